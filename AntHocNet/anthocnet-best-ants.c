@@ -0,0 +1,185 @@
+/**
+ * \file
+ *      Implements the best ants of the sources of reactive forward ants.\n
+ *      The entries are taken from a memb pool; the node id of a source maps to its pool slot, so that the entry of a
+ *      source is found in constant time. The generations of a source are kept in a ring inside of the entry.
+ */
+
+#include "anthocnet-best-ants.h"
+#include "anthocnet-node-id.h"
+#include "anthocnet-conf.h"
+#include <stdbool.h>
+#include <string.h>
+#include "lib/memb.h"
+#include "lib/list.h"
+
+// logging
+#include "sys/log.h"
+#define LOG_MODULE "AntHocNet-Best-Ants"
+#ifdef LOG_CONF_LEVEL_ANTHOCNET_BEST_ANTS
+#define LOG_LEVEL LOG_CONF_LEVEL_ANTHOCNET_BEST_ANTS
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+
+#if ANT_HOC_NET_MAX_BEST_ANT_SOURCES > 254
+#error At most 254 sources of best ants are supported
+#endif
+
+/* marks a node without best ants */
+#define EMPTY_SLOT 0xFF
+
+MEMB(best_ants_memb, best_ants_t, ANT_HOC_NET_MAX_BEST_ANT_SOURCES);
+LIST(best_ants_list);
+
+// slots of the best ants by node id of the source
+static uint8_t best_ants_slot_of_node[ANT_HOC_NET_MAX_NODE_IDS];
+
+static best_ants_t *find_best_ants(const uip_ipaddr_t *source) {
+    node_id_t node_id = node_id_lookup(source);
+    if (node_id == NODE_ID_NONE || best_ants_slot_of_node[node_id] == EMPTY_SLOT) {
+        return NULL;
+    }
+    return (best_ants_t *)best_ants_memb.mem + best_ants_slot_of_node[node_id];
+}
+
+/**
+ * Releases the node ids of the first hops of a generation.
+ */
+static void clear_generation(best_ant_t *best_ant) {
+    for (uint8_t i = 0; i < best_ant->first_hops_len; ++i) {
+        node_id_release(best_ant->first_hops[i]);
+    }
+    best_ant->first_hops_len = 0;
+}
+
+/**
+ * Releases all node ids of an entry and returns it to the pool.
+ */
+static void free_best_ants(best_ants_t *entry) {
+    for (uint8_t i = 0; i < entry->number_of_generations; ++i) {
+        clear_generation(&entry->generations[i]);
+    }
+    best_ants_slot_of_node[entry->source] = EMPTY_SLOT;
+    node_id_release(entry->source);
+    list_remove(best_ants_list, entry);
+    memb_free(&best_ants_memb, entry);
+}
+
+/**
+ * Takes a new entry from the pool; if the pool is exhausted, the entry of the least recently seen source is reused.
+ * @return The new entry, NULL if no node id is left for the source
+ */
+static best_ants_t *allocate_best_ants(const uip_ipaddr_t *source) {
+    node_id_t node_id = node_id_acquire(source);
+    if (node_id == NODE_ID_NONE) {
+        return NULL;
+    }
+
+    best_ants_t *entry = memb_alloc(&best_ants_memb);
+    if (entry == NULL) {
+        clock_time_t now = clock_time();
+        best_ants_t *oldest = list_head(best_ants_list);
+        for (entry = list_head(best_ants_list); entry != NULL; entry = list_item_next(entry)) {
+            if ((clock_time_t)(now - entry->last_seen) > (clock_time_t)(now - oldest->last_seen)) {
+                oldest = entry;
+            }
+        }
+        LOG_DBG("Best ants full - drop the least recently seen source ");
+        LOG_DBG_6ADDR(node_id_address(oldest->source));
+        LOG_DBG_("\n");
+        free_best_ants(oldest);
+        entry = memb_alloc(&best_ants_memb);
+    }
+
+    entry->source = node_id;
+    entry->number_of_generations = 0;
+    entry->next_generation = 0;
+    list_push(best_ants_list, entry);
+    best_ants_slot_of_node[node_id] = (uint8_t)(entry - (best_ants_t *)best_ants_memb.mem);
+    return entry;
+}
+
+void best_ants_init() {
+    memb_init(&best_ants_memb);
+    list_init(best_ants_list);
+    memset(best_ants_slot_of_node, EMPTY_SLOT, sizeof(best_ants_slot_of_node));
+}
+
+best_ant_t *find_best_ant(const uip_ipaddr_t *source, unsigned int generation) {
+    best_ants_t *entry = find_best_ants(source);
+    if (entry == NULL) {
+        return NULL;
+    }
+    entry->last_seen = clock_time();
+    for (uint8_t i = 0; i < entry->number_of_generations; ++i) {
+        if (entry->generations[i].generation == generation) {
+            return &entry->generations[i];
+        }
+    }
+    return NULL;
+}
+
+best_ant_t *add_best_ant(const uip_ipaddr_t *source, unsigned int generation, hop_t hop_count,
+                         time_estimate_t time_estimate, const uip_ipaddr_t *first_hop) {
+    best_ants_t *entry = find_best_ants(source);
+    if (entry == NULL) {
+        entry = allocate_best_ants(source);
+        if (entry == NULL) {
+            return NULL;
+        }
+    }
+    entry->last_seen = clock_time();
+
+    // overwrite the oldest generation, once the ring is full
+    best_ant_t *best_ant = &entry->generations[entry->next_generation];
+    if (entry->number_of_generations < ANT_HOC_NET_BEST_ANT_GENERATIONS) {
+        ++entry->number_of_generations;
+    } else {
+        clear_generation(best_ant);
+    }
+    entry->next_generation = (entry->next_generation + 1) % ANT_HOC_NET_BEST_ANT_GENERATIONS;
+
+    best_ant->generation = generation;
+    best_ant->hop_count = hop_count;
+    best_ant->time_estimate = time_estimate;
+    best_ant->first_hops_len = 0;
+    add_first_hop_to_best_ant(best_ant, first_hop);
+    return best_ant;
+}
+
+bool best_ant_has_first_hop(const best_ant_t *best_ant, const uip_ipaddr_t *first_hop) {
+    node_id_t node_id = node_id_lookup(first_hop);
+    if (node_id == NODE_ID_NONE) {
+        return false;
+    }
+    for (uint8_t i = 0; i < best_ant->first_hops_len; ++i) {
+        if (best_ant->first_hops[i] == node_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void add_first_hop_to_best_ant(best_ant_t *best_ant, const uip_ipaddr_t *first_hop) {
+    if (best_ant->first_hops_len == ANT_HOC_NET_BEST_ANT_FIRST_HOPS || best_ant_has_first_hop(best_ant, first_hop)) {
+        return;
+    }
+    node_id_t node_id = node_id_acquire(first_hop);
+    if (node_id != NODE_ID_NONE) {
+        best_ant->first_hops[best_ant->first_hops_len++] = node_id;
+    }
+}
+
+void delete_best_ants_of_source(const uip_ipaddr_t *source) {
+    best_ants_t *entry = find_best_ants(source);
+    if (entry != NULL) {
+        free_best_ants(entry);
+    }
+}
+
+void delete_best_ants() {
+    while (list_head(best_ants_list) != NULL) {
+        free_best_ants(list_head(best_ants_list));
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * \file
+ *      Declarations of the functions for the best ants, which decide on the acceptance of reactive forward ants.\n
+ *      For every source, the best ants of the latest ANT_HOC_NET_BEST_ANT_GENERATIONS generations are kept; the state
+ *      has a fixed size and does not grow with the number of generations.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_BEST_ANTS_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_BEST_ANTS_H
+
+#include "../../contiki-ng/os/net/ipv6/uip.h"
+#include "anthocnet-types.h"
+
+/**
+ * Initializes the best ants; all entries are dropped without releasing their node ids.
+ */
+void best_ants_init();
+
+/**
+ * Returns the best ant of a generation of a source.
+ * @param source The uIP address of the source of the ant
+ * @param generation The generation of the ant
+ * @return The best ant, NULL if no ant of that generation was seen, or the generation is too old
+ */
+best_ant_t *find_best_ant(const uip_ipaddr_t *source, unsigned int generation);
+
+/**
+ * Adds the first ant of a generation as best ant of that generation. The oldest generation of the source is
+ * overwritten if all are used, the least recently seen source is dropped if there are too many sources.
+ * @param source The uIP address of the source of the ant
+ * @param generation The generation of the ant
+ * @param hop_count The hop count of the ant
+ * @param time_estimate The time estimate of the ant
+ * @param first_hop The uIP address of the first hop of the ant
+ * @return The new best ant, NULL if no node id is left for the source
+ */
+best_ant_t *add_best_ant(const uip_ipaddr_t *source, unsigned int generation, hop_t hop_count,
+                         time_estimate_t time_estimate, const uip_ipaddr_t *first_hop);
+
+/**
+ * Checks whether an accepted ant of the generation had the first hop.
+ * @param best_ant The best ant of the generation
+ * @param first_hop The uIP address of the first hop
+ * @return True if the first hop was used before
+ */
+bool best_ant_has_first_hop(const best_ant_t *best_ant, const uip_ipaddr_t *first_hop);
+
+/**
+ * Adds the first hop of an accepted ant to the first hops of the generation; nothing is done if the first hop is
+ * already contained, or if ANT_HOC_NET_BEST_ANT_FIRST_HOPS first hops are kept already.
+ * @param best_ant The best ant of the generation
+ * @param first_hop The uIP address of the first hop
+ */
+void add_first_hop_to_best_ant(best_ant_t *best_ant, const uip_ipaddr_t *first_hop);
+
+/**
+ * Deletes the best ants of a source.
+ * @param source The uIP address of the source
+ */
+void delete_best_ants_of_source(const uip_ipaddr_t *source);
+
+/**
+ * Deletes the best ants of all sources.
+ */
+void delete_best_ants();
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_BEST_ANTS_H
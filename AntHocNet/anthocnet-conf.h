@@ -38,8 +38,8 @@
 #ifdef ANT_HOC_NET_CONF_T_HOP
 #define ANT_HOC_NET_T_HOP    ANT_HOC_NET_CONF_T_HOP
 #else
-/* defines time to take one hop in unloaded conditions; T_hop; needed in equation (5) of AntNetHoc Paper  */
-#define ANT_HOC_NET_T_HOP    (3.0 * pow(10, -3))
+/* defines time to take one hop in unloaded conditions (3 ms); T_hop; needed in equation (5) of AntNetHoc Paper  */
+#define ANT_HOC_NET_T_HOP    0.003
 #endif
 
 #ifdef ANT_HOC_NET_CONF_RESTART_PATH_SETUP_SECS
@@ -56,6 +56,78 @@
 #define ANT_HOC_NET_MAX_TRIES_PATH_SETUP    3
 #endif
 
+#ifdef ANT_HOC_NET_CONF_MAX_PATH_SETUPS
+#define ANT_HOC_NET_MAX_PATH_SETUPS    ANT_HOC_NET_CONF_MAX_PATH_SETUPS
+#else
+/* defines the number of destinations whose paths can be set up or repaired at the same time; packets to further
+ * destinations without a path are dropped */
+#define ANT_HOC_NET_MAX_PATH_SETUPS    4
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_BUFFERED_PACKETS
+#define ANT_HOC_NET_MAX_BUFFERED_PACKETS    ANT_HOC_NET_CONF_MAX_BUFFERED_PACKETS
+#else
+/* defines the number of packets that can wait for the path setups of all destinations together */
+#define ANT_HOC_NET_MAX_BUFFERED_PACKETS    16
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_BUFFERED_PACKETS_PER_DESTINATION
+#define ANT_HOC_NET_MAX_BUFFERED_PACKETS_PER_DESTINATION    ANT_HOC_NET_CONF_MAX_BUFFERED_PACKETS_PER_DESTINATION
+#else
+/* defines the number of packets that can wait for the path setup of one destination; holds a burst of the
+ * simulations */
+#define ANT_HOC_NET_MAX_BUFFERED_PACKETS_PER_DESTINATION    8
+#endif
+
+#ifdef ANT_HOC_NET_CONF_BUFFERED_PACKET_LEN
+#define ANT_HOC_NET_BUFFERED_PACKET_LEN    ANT_HOC_NET_CONF_BUFFERED_PACKET_LEN
+#else
+/* defines the maximal length of a packet that waits for a path setup, including its IPv6 header; longer packets are
+ * dropped. By default every packet fits; the pool takes ANT_HOC_NET_MAX_BUFFERED_PACKETS times this length */
+#define ANT_HOC_NET_BUFFERED_PACKET_LEN    UIP_BUFSIZE
+#endif
+
+#ifdef ANT_HOC_NET_CONF_BUFFER_DROP_OLDEST
+#define ANT_HOC_NET_BUFFER_DROP_OLDEST    ANT_HOC_NET_CONF_BUFFER_DROP_OLDEST
+#else
+/* whether the oldest packet of a destination is dropped for a new one if no buffer is left; otherwise the new packet
+ * is dropped */
+#define ANT_HOC_NET_BUFFER_DROP_OLDEST    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_PACED_RELEASE
+#define ANT_HOC_NET_PACED_RELEASE    ANT_HOC_NET_CONF_PACED_RELEASE
+#else
+/* defines how the packets buffered in a path setup are released after the backward ant arrived:
+ * 0 sends all at once, 1 sends ANT_HOC_NET_PACED_RELEASE_BURST packets per time estimate of the new path,
+ * 2 sends every average MAC sending time as many packets as keep ANT_HOC_NET_PACED_RELEASE_BURST packets in the MAC
+ * queue */
+#define ANT_HOC_NET_PACED_RELEASE    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_PACED_RELEASE_BURST
+#define ANT_HOC_NET_PACED_RELEASE_BURST    ANT_HOC_NET_CONF_PACED_RELEASE_BURST
+#else
+/* defines the number of buffered packets released at once with ANT_HOC_NET_PACED_RELEASE */
+#define ANT_HOC_NET_PACED_RELEASE_BURST    2
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_REROUTE_CONTEXTS
+#define ANT_HOC_NET_MAX_REROUTE_CONTEXTS    ANT_HOC_NET_CONF_MAX_REROUTE_CONTEXTS
+#else
+/* defines the number of data packets in flight whose frames can be rerouted over another neighbour if they fail;
+ * should be about the number of frames the MAC layer can queue */
+#define ANT_HOC_NET_MAX_REROUTE_CONTEXTS    8
+#endif
+
+#ifdef ANT_HOC_NET_CONF_REROUTE_CONTEXT_TIMEOUT_SEC
+#define ANT_HOC_NET_REROUTE_CONTEXT_TIMEOUT_SEC    ANT_HOC_NET_CONF_REROUTE_CONTEXT_TIMEOUT_SEC
+#else
+/* defines after how many seconds a reroute context is dropped, if the MAC layer never reported the frame, e.g. since
+ * the frame was flushed from the queue; the MAC sequence number may have wrapped around by then */
+#define ANT_HOC_NET_REROUTE_CONTEXT_TIMEOUT_SEC    5
+#endif
+
 #ifdef ANT_HOC_NET_CONF_ACC_FACTOR_A1
 #define ANT_HOC_NET_ACC_FACTOR_A1    ANT_HOC_NET_CONF_ACC_FACTOR_A1
 #else
@@ -80,10 +152,66 @@
 #ifdef ANT_HOC_NET_CONF_PFA_TIME_THRESHOLD
 #define ANT_HOC_NET_PFA_TIME_THRESHOLD  ANT_HOC_NET_CONF_PFA_TIME_THRESHOLD
 #else
-/* define data sending rate m of proactive forward ant */
+/* define data sending rate m of proactive forward ant; a data session to a destination ends if no packet is sent
+ * to it for that many seconds */
 #define ANT_HOC_NET_PFA_TIME_THRESHOLD    0.5
 #endif
 
+#ifdef ANT_HOC_NET_CONF_PFA_TRIGGER
+#define ANT_HOC_NET_PFA_TRIGGER    ANT_HOC_NET_CONF_PFA_TRIGGER
+#else
+/* defines the base interval of the proactive forward ants of a data session: 0 every ANT_HOC_NET_PFA_SENDING_RATE_N
+ * packets, 1 every ANT_HOC_NET_PFA_SENDING_RATE_N average inter-packet gaps of the session, but at most every
+ * ANT_HOC_NET_PFA_MIN_INTERVAL, 2 every ANT_HOC_NET_PFA_INTERVAL; it is doubled up to ANT_HOC_NET_PFA_MAX_BACKOFF
+ * times while the path is stable */
+#define ANT_HOC_NET_PFA_TRIGGER    1
+#endif
+
+#ifdef ANT_HOC_NET_CONF_PFA_MIN_INTERVAL
+#define ANT_HOC_NET_PFA_MIN_INTERVAL    ANT_HOC_NET_CONF_PFA_MIN_INTERVAL
+#else
+/* defines the minimal time in seconds between two proactive forward ants of a session with ANT_HOC_NET_PFA_TRIGGER 1 */
+#define ANT_HOC_NET_PFA_MIN_INTERVAL    0.1
+#endif
+
+#ifdef ANT_HOC_NET_CONF_PFA_INTERVAL
+#define ANT_HOC_NET_PFA_INTERVAL    ANT_HOC_NET_CONF_PFA_INTERVAL
+#else
+/* defines the time in seconds between two proactive forward ants of a session with ANT_HOC_NET_PFA_TRIGGER 2 */
+#define ANT_HOC_NET_PFA_INTERVAL    1.0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_PFA_MAX_BACKOFF
+#define ANT_HOC_NET_PFA_MAX_BACKOFF    ANT_HOC_NET_CONF_PFA_MAX_BACKOFF
+#else
+/* defines how often the interval between the proactive forward ants of a session is doubled at most, while the
+ * pheromone to its destination is stable */
+#define ANT_HOC_NET_PFA_MAX_BACKOFF    3
+#endif
+
+#ifdef ANT_HOC_NET_CONF_PFA_VOLATILITY_THRESHOLD
+#define ANT_HOC_NET_PFA_VOLATILITY_THRESHOLD    ANT_HOC_NET_CONF_PFA_VOLATILITY_THRESHOLD
+#else
+/* defines the relative change of the pheromone to a destination between two proactive forward ants, above which the
+ * path is volatile and the ants are sent at the base interval again */
+#define ANT_HOC_NET_PFA_VOLATILITY_THRESHOLD    0.1
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_FLOWS
+#define ANT_HOC_NET_MAX_FLOWS    ANT_HOC_NET_CONF_MAX_FLOWS
+#else
+/* defines the number of destinations whose data sessions are tracked for the proactive forward ants; the table is
+ * hashed by the destination, a new session replaces the oldest one of its slots if they are in use */
+#define ANT_HOC_NET_MAX_FLOWS    8
+#endif
+
+#ifdef ANT_HOC_NET_CONF_FLOW_GAP_WEIGHT_SHIFT
+#define ANT_HOC_NET_FLOW_GAP_WEIGHT_SHIFT    ANT_HOC_NET_CONF_FLOW_GAP_WEIGHT_SHIFT
+#else
+/* defines the weight 1 / 2^shift of a new inter-packet gap in the average gap of a session */
+#define ANT_HOC_NET_FLOW_GAP_WEIGHT_SHIFT    3
+#endif
+
 #ifdef ANT_HOC_NET_CONF_PFA_BROADCAST_PROBABILITY
 #define ANT_HOC_NET_PFA_BROADCAST_PROBABILITY    ANT_HOC_NET_CONF_PFA_BROADCAST_PROBABILITY
 #else
@@ -112,6 +240,88 @@
 #define ANT_HOC_NET_ALLOWED_HELLO_LOSS    2
 #endif
 
+#ifdef ANT_HOC_NET_CONF_HELLO_TRICKLE
+#define ANT_HOC_NET_HELLO_TRICKLE    ANT_HOC_NET_CONF_HELLO_TRICKLE
+#else
+/* whether the hello messages follow a Trickle timer instead of ANT_HOC_NET_T_HELLO_SEC; the interval starts at
+ * ANT_HOC_NET_T_HELLO_SEC, is doubled while the neighbourhood is stable and is reset if it changes */
+#define ANT_HOC_NET_HELLO_TRICKLE    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_HELLO_TRICKLE_DOUBLINGS
+#define ANT_HOC_NET_HELLO_TRICKLE_DOUBLINGS    ANT_HOC_NET_CONF_HELLO_TRICKLE_DOUBLINGS
+#else
+/* defines how often the hello interval is doubled at most with ANT_HOC_NET_HELLO_TRICKLE */
+#define ANT_HOC_NET_HELLO_TRICKLE_DOUBLINGS    6
+#endif
+
+#ifdef ANT_HOC_NET_CONF_HELLO_SUPPRESSION
+#define ANT_HOC_NET_HELLO_SUPPRESSION    ANT_HOC_NET_CONF_HELLO_SUPPRESSION
+#else
+/* whether the liveness of the neighbours is also taken from the traffic: a packet received from a neighbour or a frame
+ * it acknowledged counts like its hello, and a hello message is deferred as long as every neighbour got a frame of this
+ * node within the hello interval; the neighbours never wait longer than the advertised interval for a frame */
+#define ANT_HOC_NET_HELLO_SUPPRESSION    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_HELLO_MAX_SUPPRESSED
+#define ANT_HOC_NET_HELLO_MAX_SUPPRESSED    ANT_HOC_NET_CONF_HELLO_MAX_SUPPRESSED
+#else
+/* defines how many hello messages in a row are deferred at most with ANT_HOC_NET_HELLO_SUPPRESSION, so that nodes, that
+ * don't know this node yet, still hear of it */
+#define ANT_HOC_NET_HELLO_MAX_SUPPRESSED    3
+#endif
+
+#ifdef ANT_HOC_NET_CONF_HELLO_DIGEST_ENTRIES
+#define ANT_HOC_NET_HELLO_DIGEST_ENTRIES    ANT_HOC_NET_CONF_HELLO_DIGEST_ENTRIES
+#else
+/* if greater 0, a hello message carries the best paths of up to this many destinations, taken round-robin, and the
+ * digests of the neighbours are kept as virtual pheromone; 0 disables the digests */
+#define ANT_HOC_NET_HELLO_DIGEST_ENTRIES    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_VIRTUAL_PHEROMONE
+#define ANT_HOC_NET_MAX_VIRTUAL_PHEROMONE    ANT_HOC_NET_CONF_MAX_VIRTUAL_PHEROMONE
+#else
+/* defines the number of paths the virtual pheromone table can hold; if it is full, the oldest path is replaced */
+#define ANT_HOC_NET_MAX_VIRTUAL_PHEROMONE    16
+#endif
+
+#ifdef ANT_HOC_NET_CONF_VIRTUAL_PHEROMONE_TIMEOUT_SEC
+#define ANT_HOC_NET_VIRTUAL_PHEROMONE_TIMEOUT_SEC    ANT_HOC_NET_CONF_VIRTUAL_PHEROMONE_TIMEOUT_SEC
+#else
+/* defines how many seconds a path of the virtual pheromone table is used without being advertised again */
+#define ANT_HOC_NET_VIRTUAL_PHEROMONE_TIMEOUT_SEC    30
+#endif
+
+#ifdef ANT_HOC_NET_CONF_INTERMEDIATE_REPLY
+#define ANT_HOC_NET_INTERMEDIATE_REPLY    ANT_HOC_NET_CONF_INTERMEDIATE_REPLY
+#else
+/* if 1, a node with a fresh path to the destination of a reactive forward ant answers the ant with a backward ant */
+#define ANT_HOC_NET_INTERMEDIATE_REPLY    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_INTERMEDIATE_REPLY_MIN_PHEROMONE
+#define ANT_HOC_NET_INTERMEDIATE_REPLY_MIN_PHEROMONE    ANT_HOC_NET_CONF_INTERMEDIATE_REPLY_MIN_PHEROMONE
+#else
+/* defines the pheromone value the path of an answering node needs at least; 1.0 is a time estimate of about 2 s */
+#define ANT_HOC_NET_INTERMEDIATE_REPLY_MIN_PHEROMONE    1.0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_INTERMEDIATE_REPLY_MAX_AGE_SEC
+#define ANT_HOC_NET_INTERMEDIATE_REPLY_MAX_AGE_SEC    ANT_HOC_NET_CONF_INTERMEDIATE_REPLY_MAX_AGE_SEC
+#else
+/* defines within how many seconds an ant must have updated the path of an answering node */
+#define ANT_HOC_NET_INTERMEDIATE_REPLY_MAX_AGE_SEC    10
+#endif
+
+#ifdef ANT_HOC_NET_CONF_INTERMEDIATE_REPLY_CONTINUATION
+#define ANT_HOC_NET_INTERMEDIATE_REPLY_CONTINUATION    ANT_HOC_NET_CONF_INTERMEDIATE_REPLY_CONTINUATION
+#else
+/* if 1, an answering node still forwards the ant to the destination, so that its path is refreshed end to end */
+#define ANT_HOC_NET_INTERMEDIATE_REPLY_CONTINUATION    1
+#endif
+
 #ifdef ANT_HOC_NET_CONF_MAX_NUMBER_BROADCASTS_PATH_REPAIR_A
 #define ANT_HOC_NET_MAX_NUMBER_BROADCASTS_PATH_REPAIR_A    ANT_HOC_NET_CONF_MAX_NUMBER_BROADCASTS_PATH_REPAIR_A
 #else
@@ -135,4 +345,133 @@
 #define ANT_HOC_NET_MAX_HOPS    100
 #endif
 
+#ifdef ANT_HOC_NET_CONF_FLAT_PHEROMONE_TABLE
+#define ANT_HOC_NET_FLAT_PHEROMONE_TABLE    ANT_HOC_NET_CONF_FLAT_PHEROMONE_TABLE
+#else
+/* whether the fixed-capacity pheromone table (memb pools + neighbour x destination matrix) is used instead of the linked lists */
+#define ANT_HOC_NET_FLAT_PHEROMONE_TABLE    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_NEIGHBOURS
+#define ANT_HOC_NET_MAX_NEIGHBOURS    ANT_HOC_NET_CONF_MAX_NEIGHBOURS
+#else
+/* defines the number of neighbours the flat pheromone table can hold; at most 254 */
+#define ANT_HOC_NET_MAX_NEIGHBOURS    16
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_DESTINATIONS
+#define ANT_HOC_NET_MAX_DESTINATIONS    ANT_HOC_NET_CONF_MAX_DESTINATIONS
+#else
+/* defines the number of destinations the flat pheromone table can hold; at most 254 */
+#define ANT_HOC_NET_MAX_DESTINATIONS    32
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_NODE_IDS
+#define ANT_HOC_NET_MAX_NODE_IDS    ANT_HOC_NET_CONF_MAX_NODE_IDS
+#else
+/* defines the number of distinct nodes (neighbours, destinations, sources of ants) the routing state can refer to;
+ * up to 254 a node id takes one byte, otherwise two */
+#define ANT_HOC_NET_MAX_NODE_IDS    128
+#endif
+
+#ifdef ANT_HOC_NET_CONF_FIXED_POINT
+#define ANT_HOC_NET_FIXED_POINT    ANT_HOC_NET_CONF_FIXED_POINT
+#else
+/* whether pheromone values, time estimates and probabilities are Q16.16 fixed-point numbers instead of floats,
+ * for motes without FPU */
+#define ANT_HOC_NET_FIXED_POINT    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_BEST_ANT_SOURCES
+#define ANT_HOC_NET_MAX_BEST_ANT_SOURCES    ANT_HOC_NET_CONF_MAX_BEST_ANT_SOURCES
+#else
+/* defines the number of ant sources whose best ants are kept; if exceeded, the least recently seen source is dropped;
+ * at most 254 */
+#define ANT_HOC_NET_MAX_BEST_ANT_SOURCES    16
+#endif
+
+#ifdef ANT_HOC_NET_CONF_BEST_ANT_GENERATIONS
+#define ANT_HOC_NET_BEST_ANT_GENERATIONS    ANT_HOC_NET_CONF_BEST_ANT_GENERATIONS
+#else
+/* defines the number of the latest ant generations per source whose best ants are kept; older ones are overwritten */
+#define ANT_HOC_NET_BEST_ANT_GENERATIONS    4
+#endif
+
+#ifdef ANT_HOC_NET_CONF_BEST_ANT_FIRST_HOPS
+#define ANT_HOC_NET_BEST_ANT_FIRST_HOPS    ANT_HOC_NET_CONF_BEST_ANT_FIRST_HOPS
+#else
+/* defines the number of first hops of accepted ants kept per generation, for the acceptance with factor a2 */
+#define ANT_HOC_NET_BEST_ANT_FIRST_HOPS    4
+#endif
+
+#ifdef ANT_HOC_NET_CONF_STATEFUL_REVERSE_ROUTES
+#define ANT_HOC_NET_STATEFUL_REVERSE_ROUTES    ANT_HOC_NET_CONF_STATEFUL_REVERSE_ROUTES
+#else
+/* whether the nodes keep reverse routes of the forward ants instead of the ants carrying their path; the ants then
+ * have a constant size, independent of the length of the path; all nodes of a network have to use the same mode */
+#define ANT_HOC_NET_STATEFUL_REVERSE_ROUTES    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_REVERSE_ROUTES
+#define ANT_HOC_NET_MAX_REVERSE_ROUTES    ANT_HOC_NET_CONF_MAX_REVERSE_ROUTES
+#else
+/* defines the number of reverse routes kept with ANT_HOC_NET_STATEFUL_REVERSE_ROUTES; if exceeded, the oldest one is
+ * dropped */
+#define ANT_HOC_NET_MAX_REVERSE_ROUTES    16
+#endif
+
+#ifdef ANT_HOC_NET_CONF_REVERSE_ROUTE_LIFETIME_SEC
+#define ANT_HOC_NET_REVERSE_ROUTE_LIFETIME_SEC    ANT_HOC_NET_CONF_REVERSE_ROUTE_LIFETIME_SEC
+#else
+/* defines the seconds a reverse route is kept for the backward ants of its generation */
+#define ANT_HOC_NET_REVERSE_ROUTE_LIFETIME_SEC    (2 * ANT_HOC_NET_RESTART_PATH_SETUP_SECS)
+#endif
+
+#ifdef ANT_HOC_NET_CONF_RFA_SEEN_CACHE_SIZE
+#define ANT_HOC_NET_RFA_SEEN_CACHE_SIZE    ANT_HOC_NET_CONF_RFA_SEEN_CACHE_SIZE
+#else
+/* defines the number of broadcast reactive forward ants remembered by source, generation and hops; further copies of
+ * such an ant are dropped on reception, also those over another first hop, that the acceptance of the best ants would
+ * keep; 0 disables the cache; at most 255 */
+#define ANT_HOC_NET_RFA_SEEN_CACHE_SIZE    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_REBROADCAST_JITTER_MS
+#define ANT_HOC_NET_REBROADCAST_JITTER_MS    ANT_HOC_NET_CONF_REBROADCAST_JITTER_MS
+#else
+/* defines the maximal random delay in milliseconds of relayed broadcasts, i.e. forward ants without pheromone and link
+ * failure notifications, e.g. 64; 0 broadcasts them at once */
+#define ANT_HOC_NET_REBROADCAST_JITTER_MS    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_REBROADCAST_COUNTER_THRESHOLD
+#define ANT_HOC_NET_REBROADCAST_COUNTER_THRESHOLD    ANT_HOC_NET_CONF_REBROADCAST_COUNTER_THRESHOLD
+#else
+/* defines the number of received copies of a broadcast ant, including the own one, after which its delayed rebroadcast
+ * is cancelled, e.g. 3; 0 never cancels; only takes effect with ANT_HOC_NET_REBROADCAST_JITTER_MS */
+#define ANT_HOC_NET_REBROADCAST_COUNTER_THRESHOLD    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_REBROADCAST_NEIGHBOURS
+#define ANT_HOC_NET_REBROADCAST_NEIGHBOURS    ANT_HOC_NET_CONF_REBROADCAST_NEIGHBOURS
+#else
+/* if greater 0, a node with more neighbours relays a broadcast ant only with the probability
+ * ANT_HOC_NET_REBROADCAST_NEIGHBOURS / number of neighbours */
+#define ANT_HOC_NET_REBROADCAST_NEIGHBOURS    0
+#endif
+
+#ifdef ANT_HOC_NET_CONF_MAX_PENDING_REBROADCASTS
+#define ANT_HOC_NET_MAX_PENDING_REBROADCASTS    ANT_HOC_NET_CONF_MAX_PENDING_REBROADCASTS
+#else
+/* defines the number of broadcasts that can wait for their jitter at the same time; further ones are sent at once */
+#define ANT_HOC_NET_MAX_PENDING_REBROADCASTS    4
+#endif
+
+#ifdef ANT_HOC_NET_CONF_PENDING_REBROADCAST_LEN
+#define ANT_HOC_NET_PENDING_REBROADCAST_LEN    ANT_HOC_NET_CONF_PENDING_REBROADCAST_LEN
+#else
+/* defines the maximal ICMPv6 payload of a broadcast that waits for its jitter; larger ones are sent at once */
+#define ANT_HOC_NET_PENDING_REBROADCAST_LEN    128
+#endif
+
 #endif //IEEE_802_15_4_ANTNET_ANTHOCNET_CONF_H
\ No newline at end of file
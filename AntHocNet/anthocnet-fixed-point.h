@@ -0,0 +1,137 @@
+/**
+ * \file
+ *      Arithmetic of the pheromone values, time estimates and probabilities.\n
+ *      With ANT_HOC_NET_CONF_FIXED_POINT the values are Q16.16 fixed-point numbers, so that equations (1) - (6) of the
+ *      AntHocNet paper only need integer operations on motes without FPU; otherwise they are floats. The REAL_* macros
+ *      hide the difference, a literal has to be wrapped into REAL_CONST. The types are declared in anthocnet-types.h.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_FIXED_POINT_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_FIXED_POINT_H
+
+#include <stdint.h>
+#include "anthocnet-conf.h"
+#include "anthocnet-types.h"
+
+#if ANT_HOC_NET_FIXED_POINT
+
+/* converts a constant to Q16.16; evaluated by the compiler */
+#define REAL_CONST(x)               ((int32_t)((x) * (1L << REAL_FRACTION_BITS) + ((x) >= 0 ? 0.5 : -0.5)))
+#define REAL_FROM_INT(i)            ((int32_t)(i) * (1L << REAL_FRACTION_BITS))
+/* n / d as Q16.16, for integers n and d */
+#define REAL_FROM_FRACTION(n, d)    ((int32_t)(((int64_t)(n) << REAL_FRACTION_BITS) / (int64_t)(d)))
+#define REAL_MUL(a, b)              ((int32_t)(((int64_t)(a) * (b)) >> REAL_FRACTION_BITS))
+#define REAL_DIV(a, b)              ((int32_t)(((int64_t)(a) << REAL_FRACTION_BITS) / (b)))
+/* x * i rounded down to an integer, for an integer i */
+#define REAL_SCALE_TO_INT(x, i)     ((long)(((int64_t)(x) * (i)) >> REAL_FRACTION_BITS))
+/* only for logging */
+#define REAL_TO_FLOAT(x)            ((float)(x) / (float)(1L << REAL_FRACTION_BITS))
+
+#else
+
+#define REAL_CONST(x)               ((float)(x))
+#define REAL_FROM_INT(i)            ((float)(i))
+#define REAL_FROM_FRACTION(n, d)    ((float)(n) / (float)(d))
+#define REAL_MUL(a, b)              ((a) * (b))
+#define REAL_DIV(a, b)              ((a) / (b))
+#define REAL_SCALE_TO_INT(x, i)     ((long)((x) * (i)))
+#define REAL_TO_FLOAT(x)            ((float)(x))
+
+#endif /* ANT_HOC_NET_FIXED_POINT */
+
+/**
+ * Calculates the pheromone value to the power of beta, the numerator of equation (1).
+ * @param pheromone_value The pheromone value, not negative
+ * @param beta Beta, >= 1
+ * @return pheromone_value^beta
+ */
+static inline pheromone_weight_t calc_pheromone_weight(pheromone_t pheromone_value, int beta) {
+#if ANT_HOC_NET_FIXED_POINT
+    uint64_t weight = (uint64_t)(pheromone_value > 0 ? pheromone_value : 0);
+    for (int i = 1; i < beta; ++i) {
+        // saturate instead of overflowing for large betas
+        if (pheromone_value > 0 && weight > UINT64_MAX / (uint64_t)pheromone_value) {
+            return UINT64_MAX;
+        }
+        weight = (weight * (uint64_t)pheromone_value) >> REAL_FRACTION_BITS;
+    }
+    return weight;
+#else
+    float weight = pheromone_value;
+    for (int i = 1; i < beta; ++i) {
+        weight *= pheromone_value;
+    }
+    return weight;
+#endif
+}
+
+/**
+ * Calculates the probability P_nd, equation (1) of the AntHocNet paper.
+ * @param weight The pheromone value of the path over n to d to the power of beta
+ * @param sum_of_weights Sum of the weights of all neighbours where a path to d exists
+ * @return P_nd; 1 if the sum is 0
+ */
+static inline probability_t calc_probability(pheromone_weight_t weight, pheromone_weight_t sum_of_weights) {
+    if (sum_of_weights <= 0) {
+        return REAL_CONST(1.0);
+    }
+#if ANT_HOC_NET_FIXED_POINT
+    // shifting the sum instead of the weight keeps the intermediate small for large weights
+    if (weight >= (UINT64_MAX >> REAL_FRACTION_BITS)) {
+        return (probability_t)(weight / ((sum_of_weights >> REAL_FRACTION_BITS) + 1));
+    }
+    return (probability_t)((weight << REAL_FRACTION_BITS) / sum_of_weights);
+#else
+    return weight / sum_of_weights;
+#endif
+}
+
+/**
+ * Calculates the pheromone value tau^i_d of a path, equation (5) of the AntHocNet paper.
+ * @param time_estimate_T_P The time estimate of the path
+ * @param hops The number of hops of the path
+ * @return tau^i_d
+ */
+static inline pheromone_t calc_tau_i_d(time_estimate_t time_estimate_T_P, hop_t hops) {
+    time_estimate_t denominator = time_estimate_T_P + (time_estimate_t)hops * REAL_CONST(ANT_HOC_NET_T_HOP);
+#if ANT_HOC_NET_FIXED_POINT
+    // saturate instead of dividing by 0 or overflowing for (almost) empty paths
+    if (denominator <= 0) {
+        return INT32_MAX;
+    }
+    int64_t tau_i_d = ((int64_t)REAL_CONST(2.0) << REAL_FRACTION_BITS) / denominator;
+    return tau_i_d > INT32_MAX ? INT32_MAX : (pheromone_t)tau_i_d;
+#else
+    return REAL_DIV(REAL_CONST(2.0), denominator);
+#endif
+}
+
+/**
+ * Calculates the time estimate of a path from its pheromone value, the inverse of calc_tau_i_d().
+ * @param pheromone_value The pheromone value of the path, larger than 0
+ * @param hops The number of hops of the path
+ * @return The time estimate, not negative
+ */
+static inline time_estimate_t calc_time_estimate_of_pheromone(pheromone_t pheromone_value, hop_t hops) {
+#if ANT_HOC_NET_FIXED_POINT
+    // saturate instead of overflowing for tiny pheromone values
+    int64_t quotient = ((int64_t)REAL_CONST(2.0) << REAL_FRACTION_BITS) / pheromone_value;
+    time_estimate_t time_estimate = quotient > INT32_MAX ? INT32_MAX : (time_estimate_t)quotient;
+#else
+    time_estimate_t time_estimate = REAL_DIV(REAL_CONST(2.0), pheromone_value);
+#endif
+    time_estimate -= (time_estimate_t)hops * REAL_CONST(ANT_HOC_NET_T_HOP);
+    return time_estimate > REAL_CONST(0.0) ? time_estimate : REAL_CONST(0.0);
+}
+
+/**
+ * Updates a pheromone value with tau^i_d, equation (6) of the AntHocNet paper.
+ * @param pheromone_value The old pheromone value, 0 if there was none
+ * @param tau_i_d The pheromone value of the new path
+ * @return The new pheromone value
+ */
+static inline pheromone_t calc_new_pheromone_value(pheromone_t pheromone_value, pheromone_t tau_i_d) {
+    return REAL_MUL(REAL_CONST(ANT_HOC_NET_GAMMA), pheromone_value)
+           + REAL_MUL(REAL_CONST(1 - ANT_HOC_NET_GAMMA), tau_i_d);
+}
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_FIXED_POINT_H
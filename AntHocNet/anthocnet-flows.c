@@ -0,0 +1,186 @@
+/**
+ * \file
+ *      Implements the flow table of the data sessions.\n
+ *      A destination is hashed to a slot and probed in FLOW_PROBES slots from there, so that a packet costs the same
+ *      time however many sessions are tracked. The interval between the ants of a session is doubled after each ant
+ *      that found the pheromone to the destination stable, like a Trickle timer, and gets a jitter of up to a quarter.
+ */
+
+#include "anthocnet-flows.h"
+#include "anthocnet-conf.h"
+#include "anthocnet-fixed-point.h"
+#include <string.h>
+#include "sys/cc.h"
+#include "lib/random.h"
+
+// logging
+#include "sys/log.h"
+#define LOG_MODULE "AntHocNet-Flows"
+#ifdef LOG_CONF_LEVEL_ANTHOCNET_FLOWS
+#define LOG_LEVEL LOG_CONF_LEVEL_ANTHOCNET_FLOWS
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+
+// number of slots a destination may take, starting at its hash
+#define FLOW_PROBES             MIN(4, ANT_HOC_NET_MAX_FLOWS)
+#define SESSION_TIMEOUT         ((clock_time_t)(ANT_HOC_NET_PFA_TIME_THRESHOLD * CLOCK_SECOND))
+#define PFA_MIN_INTERVAL        ((clock_time_t)(ANT_HOC_NET_PFA_MIN_INTERVAL * CLOCK_SECOND))
+#define PFA_INTERVAL            ((clock_time_t)(ANT_HOC_NET_PFA_INTERVAL * CLOCK_SECOND))
+
+static flow_t flows[ANT_HOC_NET_MAX_FLOWS];
+
+static uint8_t flow_hash(const uip_ipaddr_t *destination) {
+    // FNV-1a of the interface identifier, the prefix is the same for all nodes
+    uint32_t hash = 2166136261UL;
+    for (uint8_t i = 8; i < sizeof(uip_ipaddr_t); ++i) {
+        hash = (hash ^ destination->u8[i]) * 16777619UL;
+    }
+    return hash % ANT_HOC_NET_MAX_FLOWS;
+}
+
+static bool flow_expired(const flow_t *flow, clock_time_t now) {
+    return !flow->used || now - flow->last_packet > SESSION_TIMEOUT;
+}
+
+/**
+ * The interval between two proactive forward ants of the session in ticks, according to ANT_HOC_NET_PFA_TRIGGER and
+ * the backoff; 0 if the ants are triggered by the packet count.
+ */
+static clock_time_t proactive_forward_ant_interval(const flow_t *flow) {
+#if ANT_HOC_NET_PFA_TRIGGER == 0
+    return 0;
+#elif ANT_HOC_NET_PFA_TRIGGER == 1
+    // a new session has no gap yet, ANT_HOC_NET_PFA_MIN_INTERVAL delays its first ant
+    return MAX(ANT_HOC_NET_PFA_SENDING_RATE_N * flow->gap, PFA_MIN_INTERVAL) << flow->backoff;
+#else
+    return PFA_INTERVAL << flow->backoff;
+#endif
+}
+
+void flows_init() {
+    memset(flows, 0, sizeof(flows));
+}
+
+flow_t *find_flow(const uip_ipaddr_t *destination) {
+    clock_time_t now = clock_time();
+    uint8_t index = flow_hash(destination);
+    for (uint8_t i = 0; i < FLOW_PROBES; ++i) {
+        flow_t *flow = &flows[(index + i) % ANT_HOC_NET_MAX_FLOWS];
+        if (flow->used && uip_ipaddr_cmp(&flow->destination, destination)) {
+            return flow_expired(flow, now) ? NULL : flow;
+        }
+    }
+    return NULL;
+}
+
+bool flow_packet_sent(const uip_ipaddr_t *destination) {
+    clock_time_t now = clock_time();
+    uint8_t index = flow_hash(destination);
+
+    // the session of the destination, otherwise a slot whose session ended, otherwise the least recently used slot
+    flow_t *flow = NULL;
+    flow_t *replaced = NULL;
+    for (uint8_t i = 0; i < FLOW_PROBES; ++i) {
+        flow_t *slot = &flows[(index + i) % ANT_HOC_NET_MAX_FLOWS];
+        if (slot->used && uip_ipaddr_cmp(&slot->destination, destination)) {
+            flow = slot;
+            break;
+        }
+        if (replaced != NULL && flow_expired(replaced, now)) {
+            continue;
+        }
+        if (replaced == NULL || flow_expired(slot, now) || now - slot->last_packet > now - replaced->last_packet) {
+            replaced = slot;
+        }
+    }
+
+    bool started = flow == NULL || flow_expired(flow, now);
+    if (started) {
+        if (flow == NULL) {
+            flow = replaced;
+            if (!flow_expired(flow, now)) {
+                LOG_DBG("Flow table slots in use - the oldest session is replaced\n");
+            }
+        }
+        LOG_DBG("New data session to ");
+        LOG_DBG_6ADDR(destination);
+        LOG_DBG_("\n");
+        flow->destination = *destination;
+        flow->used = true;
+        flow->packets = 1;
+        flow->last_packet = now;
+        flow->last_ant = now;
+        flow->jitter = 0;
+        flow->gap = 0;
+        flow->backoff = 0;
+        flow->pheromone = REAL_CONST(0.0);
+    } else {
+        // EWMA of the gap, the first gap is taken as it is
+        clock_time_t gap = now - flow->last_packet;
+        if (flow->gap == 0) {
+            flow->gap = gap;
+        } else {
+            flow->gap = (flow->gap * ((1 << ANT_HOC_NET_FLOW_GAP_WEIGHT_SHIFT) - 1) + gap)
+                        >> ANT_HOC_NET_FLOW_GAP_WEIGHT_SHIFT;
+        }
+        flow->last_packet = now;
+        if (flow->packets < 0xFF) {
+            ++flow->packets;
+        }
+    }
+    LOG_DBG("Data session: %u packets since the last ant, average gap %lu ticks\n", flow->packets,
+            (unsigned long) flow->gap);
+
+    // a new session has to be scheduled; with the packet count, the count has to be checked
+    return started || flow_ant_due(flow, now);
+}
+
+flow_t *next_active_flow(flow_t *flow) {
+    clock_time_t now = clock_time();
+    for (flow = flow == NULL ? flows : flow + 1; flow < flows + ANT_HOC_NET_MAX_FLOWS; ++flow) {
+        if (!flow_expired(flow, now)) {
+            return flow;
+        }
+    }
+    return NULL;
+}
+
+bool flow_ant_due(const flow_t *flow, clock_time_t now) {
+#if ANT_HOC_NET_PFA_TRIGGER == 0
+    return flow->packets >= (ANT_HOC_NET_PFA_SENDING_RATE_N << flow->backoff);
+#else
+    return now - flow->last_ant >= proactive_forward_ant_interval(flow) + flow->jitter;
+#endif
+}
+
+clock_time_t flow_time_until_ant(const flow_t *flow, clock_time_t now) {
+    clock_time_t interval = proactive_forward_ant_interval(flow);
+    if (interval == 0) {
+        return 0;
+    }
+    clock_time_t elapsed = now - flow->last_ant;
+    return elapsed >= interval + flow->jitter ? 1 : interval + flow->jitter - elapsed;
+}
+
+void flow_ant_sent(flow_t *flow, clock_time_t now, pheromone_t pheromone) {
+    // the path is volatile if the pheromone changed by more than the threshold since the last ant, or if it is lost
+    pheromone_t change = pheromone > flow->pheromone ? pheromone - flow->pheromone : flow->pheromone - pheromone;
+    if (pheromone == REAL_CONST(0.0)
+        || change > REAL_MUL(flow->pheromone, REAL_CONST(ANT_HOC_NET_PFA_VOLATILITY_THRESHOLD))) {
+        flow->backoff = 0;
+    } else if (flow->backoff < ANT_HOC_NET_PFA_MAX_BACKOFF) {
+        ++flow->backoff;
+    }
+    LOG_DBG("Proactive forward ant of session sent, backoff %u\n", flow->backoff);
+
+    flow->pheromone = pheromone;
+    flow->packets = 0;
+    flow->last_ant = now;
+    clock_time_t interval = proactive_forward_ant_interval(flow);
+    flow->jitter = interval >= 4 ? random_rand() % (interval / 4 + 1) : 0;
+}
+
+void delete_flows() {
+    memset(flows, 0, sizeof(flows));
+}
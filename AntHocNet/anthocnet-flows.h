@@ -0,0 +1,74 @@
+/**
+ * \file
+ *      Declarations of the functions for the flow table of the data sessions.\n
+ *      The node tracks the data sessions it is the source of in a fixed-size table, hashed by the destination. Each
+ *      session holds an EWMA of its inter-packet gap, so that the proactive forward ants keep up with the rate of the
+ *      session (ANT_HOC_NET_PFA_TRIGGER), and the pheromone seen by its last ant, so that they are sent less often on
+ *      a stable path; a session ends if no packet is sent for ANT_HOC_NET_PFA_TIME_THRESHOLD.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_FLOWS_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_FLOWS_H
+
+#include "../../contiki-ng/os/net/ipv6/uip.h"
+#include "anthocnet-types.h"
+#include <stdbool.h>
+
+/**
+ * Initializes the flow table; all sessions are dropped.
+ */
+void flows_init();
+
+/**
+ * Counts a packet the node sends as source to a destination and updates the average gap of its session; a new
+ * session is started if the destination had none. The proactive forward ants are not sent here, but by the
+ * maintenance process, that has to look at the session if true is returned.
+ * @param destination uIP address of the destination of the packet
+ * @return True if the session was started, or if its ant is due by the packet count
+ */
+bool flow_packet_sent(const uip_ipaddr_t *destination);
+
+/**
+ * Returns the session to a destination.
+ * @param destination uIP address of the destination
+ * @return The session, or NULL if the destination has none or it ended
+ */
+flow_t *find_flow(const uip_ipaddr_t *destination);
+
+/**
+ * Iterates over the sessions that have not ended.
+ * @param flow The last session returned, NULL for the first one
+ * @return The next session, NULL if there is none
+ */
+flow_t *next_active_flow(flow_t *flow);
+
+/**
+ * Whether a proactive forward ant of the session is due.
+ * @param flow The session
+ * @param now The current time
+ * @return True if the ant is due
+ */
+bool flow_ant_due(const flow_t *flow, clock_time_t now);
+
+/**
+ * The time until the next proactive forward ant of the session is due.
+ * @param flow The session
+ * @param now The current time
+ * @return The time in ticks, at least 1; 0 if the ants are triggered by the packet count
+ */
+clock_time_t flow_time_until_ant(const flow_t *flow, clock_time_t now);
+
+/**
+ * Records a proactive forward ant of the session and draws the jitter of the next one. The interval is doubled if
+ * the pheromone to the destination is stable since the last ant, and reset to the base interval if it is volatile.
+ * @param flow The session
+ * @param now The current time
+ * @param pheromone The pheromone to the destination of the session
+ */
+void flow_ant_sent(flow_t *flow, clock_time_t now, pheromone_t pheromone);
+
+/**
+ * Drops all sessions.
+ */
+void delete_flows();
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_FLOWS_H
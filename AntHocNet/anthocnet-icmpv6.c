@@ -9,8 +9,11 @@
 #include "anthocnet-icmpv6.h"
 #include "uip-icmp6.h"
 #include "anthocnet.h"
+#include "anthocnet-fixed-point.h"
+#include "anthocnet-wire.h"
+#include "anthocnet-rebroadcast.h"
 #include "sys/log.h"
-#include <stdlib.h>
+#include <string.h>
 
 #define LOG_MODULE "AntHocNet - ICMPv6"
 
@@ -40,7 +43,64 @@ UIP_ICMP6_HANDLER(hello_message_handler, ICMP6_HELLO_MESSAGE, UIP_ICMP6_HANDLER_
 UIP_ICMP6_HANDLER(warning_message_handler, ICMP6_WARNING_MESSAGE, UIP_ICMP6_HANDLER_CODE_ANY, wm_input);
 UIP_ICMP6_HANDLER(link_failure_notification_handler, ICMP6_LINK_FAILURE_NOTIFICATION, UIP_ICMP6_HANDLER_CODE_ANY, lfn_input);
 
+#if ANT_HOC_NET_RFA_SEEN_CACHE_SIZE > 255
+#error At most 255 entries of the seen cache of reactive forward ants are supported
+#endif
+
+#if ANT_HOC_NET_RFA_SEEN_CACHE_SIZE > 0
+/* marks an unused entry of the seen cache */
+#define SEEN_CACHE_EMPTY 0
+
+// fingerprints of the (source, generation, hops) of the latest broadcast reactive forward ants, used as ring
+static uint32_t rfa_seen_cache[ANT_HOC_NET_RFA_SEEN_CACHE_SIZE];
+static uint8_t rfa_seen_cache_next;
+
+/**
+ * Returns the FNV-1a hash of the source, the generation and the hops of an ant; never SEEN_CACHE_EMPTY.
+ */
+static uint32_t rfa_fingerprint(const struct reactive_forward_or_path_repair_ant *ant) {
+    uint32_t hash = 2166136261UL;
+    for (uint8_t i = 0; i < sizeof(uip_ipaddr_t); ++i) {
+        hash = (hash ^ ant->source.u8[i]) * 16777619UL;
+    }
+    hash = (hash ^ (ant->ant_generation >> 8)) * 16777619UL;
+    hash = (hash ^ (ant->ant_generation & 0xFF)) * 16777619UL;
+    hash = (hash ^ (uint8_t)ant->hops) * 16777619UL;
+    return hash == SEEN_CACHE_EMPTY ? 1 : hash;
+}
+
+/**
+ * Checks whether a copy of a broadcast ant with the same source, generation and hops was received before, i.e. the
+ * same broadcast reached this node over another neighbour.
+ * @param ant The received ant
+ * @return True if the ant is a redundant copy
+ */
+static bool rfa_seen_before(const struct reactive_forward_or_path_repair_ant *ant) {
+    uint32_t fingerprint = rfa_fingerprint(ant);
+    for (uint8_t i = 0; i < ANT_HOC_NET_RFA_SEEN_CACHE_SIZE; ++i) {
+        if (rfa_seen_cache[i] == fingerprint) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Adds a broadcast ant to the cache; only valid ants are added, so that a broken copy doesn't block the valid ones.
+ * @param ant The received ant
+ */
+static void rfa_remember(const struct reactive_forward_or_path_repair_ant *ant) {
+    rfa_seen_cache[rfa_seen_cache_next] = rfa_fingerprint(ant);
+    rfa_seen_cache_next = (rfa_seen_cache_next + 1) % ANT_HOC_NET_RFA_SEEN_CACHE_SIZE;
+}
+#endif /* ANT_HOC_NET_RFA_SEEN_CACHE_SIZE > 0 */
+
 void anthocnet_icmpv6_register_input_handlers() {
+#if ANT_HOC_NET_RFA_SEEN_CACHE_SIZE > 0
+    // the generations start again after joining a network
+    memset(rfa_seen_cache, SEEN_CACHE_EMPTY, sizeof(rfa_seen_cache));
+    rfa_seen_cache_next = 0;
+#endif
     uip_icmp6_register_input_handler(&reactive_forward_or_path_repair_ant_handler);
     uip_icmp6_register_input_handler(&reactive_backward_ant_handler);
     uip_icmp6_register_input_handler(&proactive_forward_ant_handler);
@@ -49,38 +109,107 @@ void anthocnet_icmpv6_register_input_handlers() {
     uip_icmp6_register_input_handler(&link_failure_notification_handler);
 }
 
+/**
+ * Moves the ICMPv6 header and payload of the received message behind the IPv6 header, if extension headers are in
+ * between, so that ants can be changed and forwarded in place.
+ * @param header_len The size of the fixed part of the message
+ * @return The length of the payload, 0 if the message is shorter than its fixed part or of another WIRE_VERSION
+ */
+static uint16_t payload_in_place(uint16_t header_len) {
+    if (WIRE_CODE_VERSION(UIP_ICMP_BUF->icode) != WIRE_VERSION) {
+        LOG_WARN("Message of wire format version %u is not supported\n", WIRE_CODE_VERSION(UIP_ICMP_BUF->icode));
+        return 0;
+    }
+    uint16_t l3_icmp_hdr_len = UIP_IPH_LEN + uip_ext_len + UIP_ICMPH_LEN;
+    if (uip_len < l3_icmp_hdr_len + header_len) {
+        return 0;
+    }
+    uint16_t payload_len = uip_len - l3_icmp_hdr_len;
+    if (uip_ext_len > 0) {
+        memmove(&uip_buf[UIP_IPH_LEN], UIP_ICMP_BUF, UIP_ICMPH_LEN + payload_len);
+        uip_ext_len = 0;
+    }
+    return payload_len;
+}
+
+/**
+ * Expands the compressed path of the received ant in place, behind the fixed part of the ant.
+ * @param payload_len The length of the payload
+ * @param header_len The size of the fixed part of the ant
+ * @param hops The number of elements of the path
+ * @param source The address the path is compressed against
+ * @return The path in uip_buf, NULL if the path is truncated, too long, of an unknown encoding or if the ant is of the
+ * other mode of ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+ */
+static uip_ipaddr_t *path_in_place(uint16_t payload_len, uint16_t header_len, hop_t hops, const uip_ipaddr_t *source) {
+    if ((UIP_ICMP_BUF->icode & WIRE_CODE_REVERSE_ROUTES) != WIRE_CODE_FLAGS) {
+        LOG_WARN("Ant of the other reverse route mode\n");
+        return NULL;
+    }
+    if (!wire_read_path(ICMP6_ANT_PAYLOAD + header_len, payload_len - header_len, ICMP6_ANT_MAX_PAYLOAD_LEN - header_len,
+                        hops, source, WIRE_CODE_PATH_ENCODING(UIP_ICMP_BUF->icode))) {
+        return NULL;
+    }
+    return (uip_ipaddr_t *) (ICMP6_ANT_PAYLOAD + header_len);
+}
+
 static void rfa_input(void) {
     struct reactive_forward_or_path_repair_ant ant;
-    //uint16_t buff_len = uip_len - uip_l3_icmp_hdr_len;
-    uint16_t size = sizeof(struct reactive_forward_or_path_repair_ant) - sizeof(uip_ipaddr_t *);
+    uint16_t payload_len = payload_in_place(WIRE_RFA_HEADER_LEN);
+
+    if (payload_len == 0) {
+        LOG_WARN("Reactive forward ant is too short - drop it!\n");
+        uipbuf_clear();
+        return;
+    }
+    wire_read_reactive_forward_ant(ICMP6_ANT_PAYLOAD, &ant);
+
+    if (uip_is_addr_mcast(&UIP_IP_BUF->destipaddr)) {
+        // a copy of the flood may cancel the pending rebroadcast of this node
+        rebroadcast_overheard(rebroadcast_key(ICMP6_REACTIVE_FORWARD_ANT, &ant.source, ant.ant_generation));
+    }
+#if ANT_HOC_NET_RFA_SEEN_CACHE_SIZE > 0
+    // redundant copies of a broadcast are dropped before the path is expanded
+    if (uip_is_addr_mcast(&UIP_IP_BUF->destipaddr) && rfa_seen_before(&ant)) {
+        LOG_DBG("Copy of a broadcast reactive forward ant seen before - drop it!\n");
+        uipbuf_clear();
+        return;
+    }
+#endif
 
-    memcpy(&ant, UIP_ICMP_PAYLOAD, size);
+    // the path is expanded and stays in uip_buf, it is extended and forwarded from there
+    ant.path = path_in_place(payload_len, WIRE_RFA_HEADER_LEN, WIRE_PATH_ELEMENTS(ant.hops), &ant.source);
+    if (ant.path == NULL) {
+        LOG_WARN("Path of reactive forward ant is truncated - drop it!\n");
+        uipbuf_clear();
+        return;
+    }
     if (ant.hops == 0) {
         ant.path = NULL;
-    } else {
-        ant.path = (uip_ipaddr_t *) malloc(ant.hops * sizeof(uip_ipaddr_t));
-        memcpy(ant.path, UIP_ICMP_PAYLOAD + size, ant.hops * sizeof(uip_ipaddr_t));
     }
-
-    uipbuf_clear();
+#if ANT_HOC_NET_RFA_SEEN_CACHE_SIZE > 0
+    if (uip_is_addr_mcast(&UIP_IP_BUF->destipaddr)) {
+        rfa_remember(&ant);
+    }
+#endif
 
     reception_reactive_forward_or_path_repair_ant(ant);
+
+    uipbuf_clear();
 }
 
 static void rba_input(void) {
     LOG_DBG("rba_input\n");
 
     struct reactive_backward_ant ant;
+    uint16_t payload_len = payload_in_place(WIRE_RBA_HEADER_LEN);
 
-    uint16_t size = sizeof(struct reactive_backward_ant) - sizeof(uip_ipaddr_t *);
-
-    /*
-    if (UIP_ICMP_PAYLOAD == NULL) {
-        LOG_ERR("UIP_ICMP_PAYLOAD is NULL\n");
+    if (payload_len == 0) {
+        LOG_WARN("Reactive backward ant is too short - drop it!\n");
+        uipbuf_clear();
         return;
-    }*/
-
-    memcpy(&ant, UIP_ICMP_PAYLOAD, size);
+    }
+    wire_read_reactive_backward_ant(ICMP6_ANT_PAYLOAD, &ant);
     LOG_DBG("Ant:\n");
     LOG_DBG("\ttype: %d\n", ant.ant_type);
     LOG_DBG("\tant_generation: %d\n", ant.ant_generation);
@@ -88,7 +217,7 @@ static void rba_input(void) {
     LOG_DBG_6ADDR(&ant.destination);
     LOG_DBG_("\n");
     LOG_DBG("\tcurrenthop: %d\n", ant.current_hop);
-    LOG_DBG("\ttime_estimate_T_P: %f\n", ant.time_estimate_T_P);
+    LOG_DBG("\ttime_estimate_T_P: %f\n", REAL_TO_FLOAT(ant.time_estimate_T_P));
     LOG_DBG("\tlength: %d\n", ant.length);
 
     if (ant.length == 0) {
@@ -96,14 +225,15 @@ static void rba_input(void) {
         // if a backward ant is received that has no path, the ant can be killed, since that cant happen
         // if the path is 0 the destination is a neighbour and thus no reactive forward ant shouldve been sent
         LOG_INFO("RBA path length is 0");
+        uipbuf_clear();
+        return;
+    }
+    // the path is expanded and stays in uip_buf, the ant is forwarded from there
+    ant.path = path_in_place(payload_len, WIRE_RBA_HEADER_LEN, ant.length, &ant.destination);
+    if (ant.path == NULL) {
+        LOG_WARN("Path of reactive backward ant is truncated - drop it!\n");
+        uipbuf_clear();
         return;
-    } else {
-        ant.path = (uip_ipaddr_t *) malloc(ant.length * sizeof(uip_ipaddr_t));
-        if (ant.path == NULL) {
-            LOG_ERR("Memory allocation for path failed!\n");
-            return;
-        }
-        memcpy(ant.path, UIP_ICMP_PAYLOAD + size, ant.length * sizeof(uip_ipaddr_t));
     }
     LOG_DBG("Path: \n");
     for (int i = 0; i < ant.length; i++) {
@@ -113,53 +243,88 @@ static void rba_input(void) {
     }
 
     uip_ipaddr_t host_address = get_host_address();
-    // check if processes are running + if host is destination + if ant generation is current generation
-    // if so stop the reactive path setup,
-    // clear the buffer and call the reception function,
-    // in addition, send the buffered messages
-    if (processes_running() && get_current_ant_generation() == ant.ant_generation && uip_ipaddr_cmp(&ant.destination, &host_address)) {
+    // the origin of the ant is the destination of the path setup; copied, since the path lives in uip_buf
+    uip_ipaddr_t origin = ant.path[0];
+    // check if host is destination + if a path setup to the origin waits for the ant generation
+    // (only reactive ants; the proactive ants count their generations apart)
+    // if so call the reception function,
+    // then finish the path setup and send its buffered messages
+    if (uip_ipaddr_cmp(&ant.destination, &host_address) && !ant.proactive
+        && path_setup_waits_for_generation(origin, ant.ant_generation)) {
         LOG_DBG("Backward ant received!\n");
-        LOG_DBG("Backward ant of generation %d received. Host is destination! Stop rps or dtf processes!\n", ant.ant_generation);
-        stop_reactive_path_setup_and_data_transmission_failed_process();
-        uipbuf_clear();
+        LOG_DBG("Backward ant of generation %d received. Host is destination! Finish path setup!\n", ant.ant_generation);
         reception_reactive_backward_ant(ant);
-        send_buffered_data_packages();
+        uipbuf_clear();
+        finish_path_setup(origin, ant.ant_generation, ant.time_estimate_T_P);
     } else {
         LOG_DBG("Backward ant received!\n");
-        LOG_DBG("Backward ant of other generation %d than current generation %d received or processes not running (%d) or not destination address (%d)\n", ant.ant_generation, get_current_ant_generation(), processes_running(), uip_ipaddr_cmp(&ant.destination, &host_address));
-        uipbuf_clear();
+        LOG_DBG("Backward ant of generation %d received, no path setup waits for it or not destination address (%d)\n", ant.ant_generation, uip_ipaddr_cmp(&ant.destination, &host_address));
         reception_reactive_backward_ant(ant);
+        uipbuf_clear();
     }
 }
 
 static void pfa_input(void) {
     struct proactive_forward_ant ant;
-    uint16_t size = sizeof(struct proactive_forward_ant) - sizeof(uip_ipaddr_t *);
+    uint16_t payload_len = payload_in_place(WIRE_PFA_HEADER_LEN);
+
+    if (payload_len == 0) {
+        LOG_WARN("Proactive forward ant is too short - drop it!\n");
+        uipbuf_clear();
+        return;
+    }
+    wire_read_proactive_forward_ant(ICMP6_ANT_PAYLOAD, &ant);
+    if (uip_is_addr_mcast(&UIP_IP_BUF->destipaddr)) {
+        // a copy of the flood may cancel the pending rebroadcast of this node
+        rebroadcast_overheard(rebroadcast_key(ICMP6_PROACTIVE_FORWARD_ANT, &ant.source, ant.ant_generation));
+    }
 
-    memcpy(&ant, UIP_ICMP_PAYLOAD, size);
+    // the path is expanded and stays in uip_buf, it is extended and forwarded from there
+    ant.path = path_in_place(payload_len, WIRE_PFA_HEADER_LEN, WIRE_PATH_ELEMENTS(ant.hops), &ant.source);
+    if (ant.path == NULL) {
+        LOG_WARN("Path of proactive forward ant is truncated - drop it!\n");
+        uipbuf_clear();
+        return;
+    }
     if (ant.hops == 0) {
         ant.path = NULL;
-    } else {
-        ant.path = (uip_ipaddr_t *) malloc(ant.hops * sizeof(uip_ipaddr_t));
-        memcpy(ant.path, UIP_ICMP_PAYLOAD + size, ant.hops * sizeof(uip_ipaddr_t));
     }
-    uipbuf_clear();
 
     reception_proactive_forward_ant(ant);
+
+    uipbuf_clear();
 }
 
 static void hm_input(void) {
     struct hello_message msg;
-    memcpy(&msg, UIP_ICMP_PAYLOAD, sizeof(struct hello_message));
+    uint16_t payload_len = payload_in_place(WIRE_HELLO_HEADER_LEN);
 
-    uipbuf_clear();
+    if (payload_len == 0) {
+        LOG_WARN("Hello message is too short - drop it!\n");
+        uipbuf_clear();
+        return;
+    }
+    // the digest is decoded in uip_buf, it is read before a new message is written into it
+    if (!wire_read_hello_message(ICMP6_ANT_PAYLOAD, payload_len, ICMP6_ANT_MAX_PAYLOAD_LEN,
+                                 WIRE_CODE_PATH_ENCODING(UIP_ICMP_BUF->icode), &msg)) {
+        LOG_WARN("Digest of hello message is truncated - drop it!\n");
+        uipbuf_clear();
+        return;
+    }
 
     reception_hello_message(msg);
+
+    uipbuf_clear();
 }
 
 static void wm_input(void) {
     struct warning_message msg;
-    memcpy(&msg, UIP_ICMP_PAYLOAD, sizeof(struct warning_message));
+    if (payload_in_place(WIRE_WARNING_LEN) == 0) {
+        LOG_WARN("Warning message is too short - drop it!\n");
+        uipbuf_clear();
+        return;
+    }
+    wire_read_warning_message(ICMP6_ANT_PAYLOAD, &msg);
 
     uipbuf_clear();
 
@@ -168,18 +333,21 @@ static void wm_input(void) {
 
 static void lfn_input(void) {
     struct link_failure_notification lfn;
-    uint16_t size = sizeof(struct link_failure_notification) - sizeof(link_failure_notification_entry_t *);
+    uint16_t payload_len = payload_in_place(WIRE_LFN_HEADER_LEN);
 
-    memcpy(&lfn, UIP_ICMP_PAYLOAD, size);
-
-    if (lfn.size_of_list_of_destinations == 0) {
-        lfn.entries = NULL;
-    } else {
-        lfn.entries = (link_failure_notification_entry_t *) malloc(lfn.size_of_list_of_destinations * sizeof(link_failure_notification_entry_t));
-        memcpy(lfn.entries, UIP_ICMP_PAYLOAD + size, lfn.size_of_list_of_destinations * sizeof(link_failure_notification_entry_t));
+    if (payload_len == 0) {
+        LOG_WARN("Link failure notification is too short - drop it!\n");
+        uipbuf_clear();
+        return;
+    }
+    // the entries are decoded in uip_buf, they are read before a new notification is written into it
+    if (!wire_read_link_failure_notification(ICMP6_ANT_PAYLOAD, payload_len, ICMP6_ANT_MAX_PAYLOAD_LEN, &lfn)) {
+        LOG_WARN("Entries of link failure notification are truncated - drop it!\n");
+        uipbuf_clear();
+        return;
     }
-
-    uipbuf_clear();
 
     reception_link_failure_notification(lfn);
-}
\ No newline at end of file
+
+    uipbuf_clear();
+}
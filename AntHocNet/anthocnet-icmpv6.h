@@ -17,6 +17,11 @@
 #define ICMP6_WARNING_MESSAGE 234
 #define ICMP6_LINK_FAILURE_NOTIFICATION 235
 
+/** The ICMPv6 payload in uip_buf, where uip_icmp6_send expects it; received messages are moved there. */
+#define ICMP6_ANT_PAYLOAD (&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN])
+/** The maximal size of the ICMPv6 payload of a message. */
+#define ICMP6_ANT_MAX_PAYLOAD_LEN (UIP_BUFSIZE - UIP_IPH_LEN - UIP_ICMPH_LEN)
+
 /**
  * Registers the input handler functions for ICMPv6 messages.
  */
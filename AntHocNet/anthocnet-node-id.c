@@ -0,0 +1,147 @@
+/**
+ * \file
+ *      Implements the interning of uIP addresses to node ids.\n
+ *      The addresses are stored in a fixed array, the index in the array is the node id. A hash over the interface
+ *      identifier maps an address to its node id.
+ */
+
+#include "anthocnet-node-id.h"
+#include "anthocnet-conf.h"
+#include <stdbool.h>
+#include <string.h>
+
+// logging
+#include "sys/log.h"
+#define LOG_MODULE "AntHocNet-Node-Id"
+#ifdef LOG_CONF_LEVEL_ANTHOCNET_NODE_ID
+#define LOG_LEVEL LOG_CONF_LEVEL_ANTHOCNET_NODE_ID
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+
+#if ANT_HOC_NET_MAX_NODE_IDS > 65534
+#error At most 65534 node ids are supported
+#endif
+
+/* the hash has twice the size of the table, so that the probe sequences stay short */
+#define NODE_ID_HASH_SIZE (2 * ANT_HOC_NET_MAX_NODE_IDS)
+
+/**
+ * Defines one interned address.
+ */
+typedef struct node_id_entry {
+    uip_ipaddr_t address;       // the interned uIP address
+    uint16_t reference_count;   // number of references held on the node id, 0 if unused
+} node_id_entry_t;
+
+/* the buckets hold node id + 1, so that the zero-initialized hash is empty */
+#define EMPTY_BUCKET 0
+
+static node_id_entry_t node_ids[ANT_HOC_NET_MAX_NODE_IDS];
+static node_id_t node_id_hash[NODE_ID_HASH_SIZE];
+
+/**
+ * Hashes an uIP address. Only the interface identifier is used, since the nodes share the prefix (FNV-1a).
+ * @param address The address to hash
+ * @return The bucket in which the probing starts
+ */
+static uint16_t hash_address(const uip_ipaddr_t *address) {
+    uint32_t hash = 2166136261UL;
+    for (int i = 8; i < 16; ++i) {
+        hash ^= address->u8[i];
+        hash *= 16777619UL;
+    }
+    return (uint16_t)(hash % NODE_ID_HASH_SIZE);
+}
+
+/**
+ * Searches the bucket of an address with linear probing.
+ * @param address The searched address
+ * @return The bucket holding the node id of the address, or the empty bucket where the probing stopped
+ */
+static uint16_t find_bucket(const uip_ipaddr_t *address) {
+    uint16_t bucket = hash_address(address);
+    while (node_id_hash[bucket] != EMPTY_BUCKET
+           && !uip_ipaddr_cmp(&node_ids[node_id_hash[bucket] - 1].address, address)) {
+        bucket = (bucket + 1) % NODE_ID_HASH_SIZE;
+    }
+    return bucket;
+}
+
+/**
+ * Removes the node id in the bucket from the hash. The following entries of the probe sequence are shifted back, so
+ * that no tombstones are needed.
+ */
+static void remove_bucket(uint16_t bucket) {
+    node_id_hash[bucket] = EMPTY_BUCKET;
+    uint16_t hole = bucket;
+    uint16_t next = (bucket + 1) % NODE_ID_HASH_SIZE;
+    while (node_id_hash[next] != EMPTY_BUCKET) {
+        uint16_t home = hash_address(&node_ids[node_id_hash[next] - 1].address);
+        // move the entry into the hole, if the hole lies (cyclically) between its home bucket and its position
+        bool movable = (hole <= next) ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (movable) {
+            node_id_hash[hole] = node_id_hash[next];
+            node_id_hash[next] = EMPTY_BUCKET;
+            hole = next;
+        }
+        next = (next + 1) % NODE_ID_HASH_SIZE;
+    }
+}
+
+void node_id_init() {
+    memset(node_ids, 0, sizeof(node_ids));
+    memset(node_id_hash, EMPTY_BUCKET, sizeof(node_id_hash));
+}
+
+node_id_t node_id_lookup(const uip_ipaddr_t *address) {
+    uint16_t bucket = find_bucket(address);
+    return node_id_hash[bucket] != EMPTY_BUCKET ? node_id_hash[bucket] - 1 : NODE_ID_NONE;
+}
+
+node_id_t node_id_acquire(const uip_ipaddr_t *address) {
+    uint16_t bucket = find_bucket(address);
+    if (node_id_hash[bucket] != EMPTY_BUCKET) {
+        node_id_t node_id = node_id_hash[bucket] - 1;
+        ++node_ids[node_id].reference_count;
+        return node_id;
+    }
+
+    for (node_id_t node_id = 0; node_id < ANT_HOC_NET_MAX_NODE_IDS; ++node_id) {
+        if (node_ids[node_id].reference_count == 0) {
+            node_ids[node_id].address = *address;
+            node_ids[node_id].reference_count = 1;
+            // the hash is twice as big as the table, so the bucket where the probing stopped is free
+            node_id_hash[bucket] = node_id + 1;
+            LOG_DBG("Node id %d assigned to ", node_id);
+            LOG_DBG_6ADDR(address);
+            LOG_DBG_("\n");
+            return node_id;
+        }
+    }
+
+    LOG_WARN("Node id table full - ");
+    LOG_WARN_6ADDR(address);
+    LOG_WARN_(" is not added.\n");
+    return NODE_ID_NONE;
+}
+
+void node_id_hold(node_id_t node_id) {
+    if (node_id != NODE_ID_NONE) {
+        ++node_ids[node_id].reference_count;
+    }
+}
+
+void node_id_release(node_id_t node_id) {
+    if (node_id == NODE_ID_NONE || node_ids[node_id].reference_count == 0) {
+        return;
+    }
+    if (--node_ids[node_id].reference_count == 0) {
+        LOG_DBG("Node id %d released\n", node_id);
+        remove_bucket(find_bucket(&node_ids[node_id].address));
+    }
+}
+
+const uip_ipaddr_t *node_id_address(node_id_t node_id) {
+    return &node_ids[node_id].address;
+}
@@ -0,0 +1,52 @@
+/**
+ * \file
+ *      Declarations of the functions for interning uIP addresses.\n
+ *      The routing state refers to nodes by a compact node_id_t instead of the full uIP address. An address gets a node
+ *      id as long as at least one reference to it is held; comparing two nodes is then a single integer comparison.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_NODE_ID_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_NODE_ID_H
+
+#include "../../contiki-ng/os/net/ipv6/uip.h"
+#include "anthocnet-types.h"
+
+/**
+ * Initializes the node id table; all node ids are released.
+ */
+void node_id_init();
+
+/**
+ * Returns the node id of an address without taking a reference.
+ * @param address The uIP address
+ * @return The node id, NODE_ID_NONE if the address is not interned
+ */
+node_id_t node_id_lookup(const uip_ipaddr_t *address);
+
+/**
+ * Interns an address and takes a reference to its node id.
+ * Every successful call has to be paired with node_id_release().
+ * @param address The uIP address
+ * @return The node id, NODE_ID_NONE if the node id table is full
+ */
+node_id_t node_id_acquire(const uip_ipaddr_t *address);
+
+/**
+ * Takes another reference to an already interned node id.
+ * @param node_id The node id
+ */
+void node_id_hold(node_id_t node_id);
+
+/**
+ * Releases a reference to a node id. The node id is freed with its last reference.
+ * @param node_id The node id; NODE_ID_NONE is ignored
+ */
+void node_id_release(node_id_t node_id);
+
+/**
+ * Returns the address of a node id.
+ * @param node_id The node id, must be interned
+ * @return Pointer to the uIP address
+ */
+const uip_ipaddr_t *node_id_address(node_id_t node_id);
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_NODE_ID_H
@@ -0,0 +1,191 @@
+/**
+ * \file
+ *      Implements the buffering of data packets while the path to their destination is set up.\n
+ *      Every queue keeps its newest packet, so that a packet is appended without walking the queue. Queues that are
+ *      released with pacing are moved into a packet release, which has its own ctimer.
+ */
+
+#include "anthocnet-packet-buffer.h"
+#include "anthocnet.h"
+#include "anthocnet-conf.h"
+#include <stdbool.h>
+#include <string.h>
+#include "lib/memb.h"
+#include "lib/list.h"
+#include "sys/ctimer.h"
+#include "tcpip.h"
+
+// logging
+#include "sys/log.h"
+#define LOG_MODULE "AntHocNet-Packet-Buffer"
+#ifdef LOG_CONF_LEVEL_ANTHOCNET_PACKET_BUFFER
+#define LOG_LEVEL LOG_CONF_LEVEL_ANTHOCNET_PACKET_BUFFER
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+
+/**
+ * Structure for the packets of a destination that are released with pacing.
+ */
+typedef struct packet_release {
+    struct packet_release *next;    // the next element in the list of used entries
+    struct ctimer timer;            // fires for the next burst
+    clock_time_t interval;          // time between two bursts
+    buffer_t buffer;                // the packets that are not yet released
+} packet_release_t;
+
+MEMB(packet_buffers_memb, packet_buffer_t, ANT_HOC_NET_MAX_BUFFERED_PACKETS);
+MEMB(packet_releases_memb, packet_release_t, ANT_HOC_NET_MAX_PATH_SETUPS);
+LIST(packet_releases_list);
+
+/**
+ * Removes the oldest packet of a queue, without releasing its slot.
+ */
+static packet_buffer_t *dequeue_packet(buffer_t *buffer) {
+    packet_buffer_t *packet = buffer->packet_buffer;
+    if (packet != NULL) {
+        buffer->packet_buffer = packet->next;
+        if (buffer->packet_buffer == NULL) {
+            buffer->last_packet = NULL;
+        }
+        --buffer->number_of_packets;
+    }
+    return packet;
+}
+
+/**
+ * Sends the oldest packet of a queue and releases its slot.
+ */
+static void send_buffered_packet(buffer_t *buffer) {
+    packet_buffer_t *packet = dequeue_packet(buffer);
+    LOG_INFO("Send message of length %d\n", packet->len);
+    uip_len = packet->len;
+    memcpy(&uip_buf, packet->buffer, packet->len);
+    memb_free(&packet_buffers_memb, packet);
+    tcpip_ipv6_output();
+}
+
+static void packet_release_callback_function(void *ptr);
+
+/**
+ * Sends the next burst of a packet release; the release is freed after its last packet.
+ */
+static void send_burst(packet_release_t *release) {
+    int burst = ANT_HOC_NET_PACED_RELEASE_BURST;
+#if ANT_HOC_NET_PACED_RELEASE == 2
+    burst -= mac_queue_length();
+#endif
+    // uip_buf is not overwritten if it holds a packet
+    if (uip_len > 0) {
+        burst = 0;
+    }
+    for (; burst > 0 && release->buffer.packet_buffer != NULL; --burst) {
+        send_buffered_packet(&release->buffer);
+    }
+    LOG_DBG("Paced release, %u packets left\n", release->buffer.number_of_packets);
+
+    if (release->buffer.packet_buffer == NULL) {
+        ctimer_stop(&release->timer);
+        list_remove(packet_releases_list, release);
+        memb_free(&packet_releases_memb, release);
+    } else {
+        ctimer_set(&release->timer, release->interval, packet_release_callback_function, release);
+    }
+}
+
+static void packet_release_callback_function(void *ptr) {
+    send_burst((packet_release_t *) ptr);
+}
+
+void packet_buffer_init() {
+    memb_init(&packet_buffers_memb);
+    memb_init(&packet_releases_memb);
+    list_init(packet_releases_list);
+}
+
+bool buffer_packet(buffer_t *buffer) {
+    if (uip_len > ANT_HOC_NET_BUFFERED_PACKET_LEN) {
+        LOG_WARN("Packet of length %u is too long to be buffered - drop it!\n", uip_len);
+        return false;
+    }
+
+    packet_buffer_t *packet = NULL;
+    if (buffer->number_of_packets < ANT_HOC_NET_MAX_BUFFERED_PACKETS_PER_DESTINATION) {
+        packet = memb_alloc(&packet_buffers_memb);
+    }
+    if (packet == NULL) {
+#if ANT_HOC_NET_BUFFER_DROP_OLDEST
+        packet = dequeue_packet(buffer);
+        if (packet != NULL) {
+            LOG_WARN("Buffer full - drop the oldest packet!\n");
+        }
+#endif
+        if (packet == NULL) {
+            LOG_WARN("Buffer full - drop the packet!\n");
+            return false;
+        }
+    }
+
+    memcpy(packet->buffer, &uip_buf, uip_len);
+    packet->len = uip_len;
+    packet->next = NULL;
+    if (buffer->last_packet == NULL) {
+        buffer->packet_buffer = packet;
+    } else {
+        buffer->last_packet->next = packet;
+    }
+    buffer->last_packet = packet;
+    ++buffer->number_of_packets;
+
+    LOG_DBG("Packet buffered, %u packets of the destination, %d free buffers\n", buffer->number_of_packets,
+            number_of_free_packet_buffers());
+    return true;
+}
+
+void send_buffered_packets(buffer_t *buffer) {
+    while (buffer->packet_buffer != NULL) {
+        send_buffered_packet(buffer);
+    }
+}
+
+void release_buffered_packets(buffer_t *buffer, clock_time_t interval) {
+    if (buffer->packet_buffer == NULL) {
+        return;
+    }
+    packet_release_t *release = memb_alloc(&packet_releases_memb);
+    if (release == NULL) {
+        LOG_WARN("Too many packet releases - packets are sent at once!\n");
+        send_buffered_packets(buffer);
+        return;
+    }
+    LOG_DBG("Release %u packets every %lu ticks\n", buffer->number_of_packets, (unsigned long) interval);
+    release->interval = interval;
+    release->buffer = *buffer;
+    buffer->packet_buffer = NULL;
+    buffer->last_packet = NULL;
+    buffer->number_of_packets = 0;
+    list_add(packet_releases_list, release);
+    send_burst(release);
+}
+
+void delete_packet_releases() {
+    while (list_head(packet_releases_list) != NULL) {
+        packet_release_t *release = list_head(packet_releases_list);
+        ctimer_stop(&release->timer);
+        discard_buffered_packets(&release->buffer);
+        list_remove(packet_releases_list, release);
+        memb_free(&packet_releases_memb, release);
+    }
+}
+
+void discard_buffered_packets(buffer_t *buffer) {
+    packet_buffer_t *packet;
+    while ((packet = dequeue_packet(buffer)) != NULL) {
+        memb_free(&packet_buffers_memb, packet);
+    }
+    LOG_INFO("Buffer discarded!\n");
+}
+
+int number_of_free_packet_buffers() {
+    return memb_numfree(&packet_buffers_memb);
+}
@@ -0,0 +1,61 @@
+/**
+ * \file
+ *      Declarations of the functions for the buffering of data packets while the path to their destination is set up.\n
+ *      The packets are copied into slots of a memb pool, shared by all destinations; every destination has its own
+ *      queue of at most ANT_HOC_NET_MAX_BUFFERED_PACKETS_PER_DESTINATION packets. No heap memory is used.\n
+ *      With ANT_HOC_NET_PACED_RELEASE, the packets of a finished path setup are released in bursts by a ctimer, instead
+ *      of being sent back to back into the MAC queue.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_PACKET_BUFFER_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_PACKET_BUFFER_H
+
+#include "../../contiki-ng/os/net/ipv6/uip.h"
+#include "anthocnet-types.h"
+
+/**
+ * Initializes the packet buffers; all buffered packets are dropped.
+ */
+void packet_buffer_init();
+
+/**
+ * Appends the packet in uip_buf to the queue of a destination. If the queue is full, or no slot is left, the packet
+ * is dropped; with ANT_HOC_NET_BUFFER_DROP_OLDEST the oldest packet of the queue is dropped instead, if it has one.
+ * @param buffer The queue of the destination
+ * @return True if the packet was buffered
+ */
+bool buffer_packet(buffer_t *buffer);
+
+/**
+ * Sends the packets of a queue in the order they were buffered, and empties the queue. The slots are released before
+ * the packets are sent, a packet that finds no path may be buffered again.
+ * @param buffer The queue of the destination
+ */
+void send_buffered_packets(buffer_t *buffer);
+
+/**
+ * Releases the packets of a queue in bursts of ANT_HOC_NET_PACED_RELEASE_BURST packets, the first one at once, the
+ * others each after an interval; with ANT_HOC_NET_PACED_RELEASE 2, a burst only fills the MAC queue up to
+ * ANT_HOC_NET_PACED_RELEASE_BURST packets. The packets are moved out of the queue, that is empty afterwards. If too many
+ * queues are released at the same time, the packets are sent at once.
+ * @param buffer The queue of the destination
+ * @param interval The time in clock ticks between two bursts
+ */
+void release_buffered_packets(buffer_t *buffer, clock_time_t interval);
+
+/**
+ * Drops the packets that wait for their release.
+ */
+void delete_packet_releases();
+
+/**
+ * Drops the packets of a queue.
+ * @param buffer The queue of the destination
+ */
+void discard_buffered_packets(buffer_t *buffer);
+
+/**
+ * @return The number of slots that are not used by any queue
+ */
+int number_of_free_packet_buffers();
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_PACKET_BUFFER_H
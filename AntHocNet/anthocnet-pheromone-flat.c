@@ -0,0 +1,767 @@
+/**
+ * \file
+ *      Implements the pheromone table as fixed-capacity table, selected with ANT_HOC_NET_CONF_FLAT_PHEROMONE_TABLE.\n
+ *      Neighbours and destinations are taken from memb pools. Their position in the pool is used as row respectively
+ *      column of a dense neighbour x destination matrix, which holds the pheromone values. The node id of an address
+ *      maps to its pool slot, so that every lookup takes constant time and no heap is used for the table itself.
+ */
+
+#include "anthocnet-pheromone.h"
+#include "anthocnet-node-id.h"
+#include "anthocnet-fixed-point.h"
+#include "anthocnet-conf.h"
+#include "anthocnet-types.h"
+#include "anthocnet.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// logging
+#include "sys/log.h"
+#define LOG_MODULE "AntHocNet-Pheromone"
+#ifdef LOG_CONF_LEVEL_ANTHOCNET_PHEROMONE
+#define LOG_LEVEL LOG_CONF_LEVEL_ANTHOCNET_PHEROMONE
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+
+#if ANT_HOC_NET_FLAT_PHEROMONE_TABLE
+
+#include "lib/memb.h"
+#include "lib/list.h"
+
+#if ANT_HOC_NET_MAX_NEIGHBOURS > 254 || ANT_HOC_NET_MAX_DESTINATIONS > 254
+#error The flat pheromone table supports at most 254 neighbours and 254 destinations
+#endif
+
+/* marks an unused slot */
+#define EMPTY_SLOT 0xFF
+
+/**
+ * Defines a destination of the flat pheromone table. The position in the pool is the column in the matrix.\n
+ * The valid cells of the column are chained over destination_info_t.next_candidate, starting at first_candidate, so
+ * that the next hop selection only visits the neighbours that actually know the destination.
+ */
+typedef struct destination_slot {
+    struct destination_slot *next;  // next destination slot (list of used pool entries)
+    node_id_t destination;          // node id of the destination
+    uint8_t number_of_neighbours;   // number of neighbours over which the destination can be reached
+    uint8_t first_candidate;        // row of the first neighbour that knows the destination, EMPTY_SLOT if none
+    uint8_t valid_distributions;    // bit per PHEROMONE_DISTRIBUTION_*, set if the cached probabilities are up to date
+    uint8_t best_candidate;         // row of the candidate with the smallest pheromone value, EMPTY_SLOT if none
+    uint8_t second_best_candidate;  // row of the candidate with the second smallest pheromone value, EMPTY_SLOT if none
+    clock_time_t last_ant;          // when a backward ant updated a path to the destination, or it was added
+} destination_slot_t;
+
+MEMB(neighbour_memb, pheromone_entry_t, ANT_HOC_NET_MAX_NEIGHBOURS);
+MEMB(destination_memb, destination_slot_t, ANT_HOC_NET_MAX_DESTINATIONS);
+LIST(neighbour_list);
+LIST(destination_list);
+
+// slots of the neighbours and destinations by node id
+static uint8_t neighbour_slot_of_node[ANT_HOC_NET_MAX_NODE_IDS];
+static uint8_t destination_slot_of_node[ANT_HOC_NET_MAX_NODE_IDS];
+
+static destination_info_t pheromone_matrix[ANT_HOC_NET_MAX_NEIGHBOURS][ANT_HOC_NET_MAX_DESTINATIONS];
+
+/*----Slots-----------------------------------------------------------------------------------------------------------*/
+
+static uint8_t neighbour_slot(const pheromone_entry_t *entry) {
+    return (uint8_t)(entry - (pheromone_entry_t *)neighbour_memb.mem);
+}
+
+static pheromone_entry_t *neighbour_of_slot(uint8_t slot) {
+    return (pheromone_entry_t *)neighbour_memb.mem + slot;
+}
+
+static uint8_t destination_slot(const destination_slot_t *entry) {
+    return (uint8_t)(entry - (destination_slot_t *)destination_memb.mem);
+}
+
+static destination_slot_t *destination_of_slot(uint8_t slot) {
+    return (destination_slot_t *)destination_memb.mem + slot;
+}
+
+static pheromone_entry_t *find_neighbour(const uip_ipaddr_t *neighbour_address) {
+    node_id_t node_id = node_id_lookup(neighbour_address);
+    if (node_id == NODE_ID_NONE || neighbour_slot_of_node[node_id] == EMPTY_SLOT) {
+        return NULL;
+    }
+    return neighbour_of_slot(neighbour_slot_of_node[node_id]);
+}
+
+static destination_slot_t *find_destination(const uip_ipaddr_t *destination_address) {
+    node_id_t node_id = node_id_lookup(destination_address);
+    if (node_id == NODE_ID_NONE || destination_slot_of_node[node_id] == EMPTY_SLOT) {
+        return NULL;
+    }
+    return destination_of_slot(destination_slot_of_node[node_id]);
+}
+
+/**
+ * Returns the matrix cell of the route over the neighbour to the destination.
+ * @return The cell, or NULL if the neighbour or the destination is unknown or the cell is not used
+ */
+static destination_info_t *find_cell(const uip_ipaddr_t *neighbour_address, const uip_ipaddr_t *destination_address) {
+    pheromone_entry_t *neighbour = find_neighbour(neighbour_address);
+    if (neighbour == NULL) {
+        return NULL;
+    }
+    destination_slot_t *destination = find_destination(destination_address);
+    if (destination == NULL) {
+        return NULL;
+    }
+    destination_info_t *cell = &pheromone_matrix[neighbour_slot(neighbour)][destination_slot(destination)];
+    return cell->valid ? cell : NULL;
+}
+
+/*----Allocation------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Takes a new neighbour from the pool and starts its hello timer.
+ * @return The new neighbour, NULL if the pool is exhausted
+ */
+static pheromone_entry_t *allocate_neighbour(const uip_ipaddr_t *neighbour_address) {
+    pheromone_entry_t *entry = memb_alloc(&neighbour_memb);
+    if (entry == NULL) {
+        LOG_WARN("Pheromone table full - neighbour ");
+        LOG_WARN_6ADDR(neighbour_address);
+        LOG_WARN_(" is not added.\n");
+        return NULL;
+    }
+    node_id_t node_id = node_id_acquire(neighbour_address);
+    if (node_id == NODE_ID_NONE) {
+        memb_free(&neighbour_memb, entry);
+        return NULL;
+    }
+    uint8_t slot = neighbour_slot(entry);
+    for (uint8_t d = 0; d < ANT_HOC_NET_MAX_DESTINATIONS; ++d) {
+        pheromone_matrix[slot][d].valid = false;
+    }
+    entry->neighbour = node_id;
+    entry->hello_loss_counter = 0;
+    // no frame reached the new neighbour yet
+    entry->last_reached = clock_time() - PHEROMONE_DEFAULT_HELLO_INTERVAL;
+    list_push(neighbour_list, entry);
+    neighbour_slot_of_node[node_id] = slot;
+    entry->last_heard = clock_time();
+    entry->hello_interval = PHEROMONE_DEFAULT_HELLO_INTERVAL;
+    schedule_hello_loss_sweep(entry->last_heard + entry->hello_interval);
+    return entry;
+}
+
+/**
+ * Returns the destination slot of the address, and takes a new one from the pool if the destination is unknown.
+ * @return The destination slot, NULL if the pool is exhausted
+ */
+static destination_slot_t *get_or_allocate_destination(const uip_ipaddr_t *destination_address) {
+    destination_slot_t *destination = find_destination(destination_address);
+    if (destination != NULL) {
+        return destination;
+    }
+    destination = memb_alloc(&destination_memb);
+    if (destination == NULL) {
+        LOG_WARN("Pheromone table full - destination ");
+        LOG_WARN_6ADDR(destination_address);
+        LOG_WARN_(" is not added.\n");
+        return NULL;
+    }
+    node_id_t node_id = node_id_acquire(destination_address);
+    if (node_id == NODE_ID_NONE) {
+        memb_free(&destination_memb, destination);
+        return NULL;
+    }
+    destination->destination = node_id;
+    destination->number_of_neighbours = 0;
+    destination->first_candidate = EMPTY_SLOT;
+    destination->valid_distributions = 0;
+    destination->best_candidate = EMPTY_SLOT;
+    destination->second_best_candidate = EMPTY_SLOT;
+    destination->last_ant = clock_time();
+    list_push(destination_list, destination);
+    destination_slot_of_node[node_id] = destination_slot(destination);
+    return destination;
+}
+
+/**
+ * Returns an unused destination slot to the pool.
+ */
+static void free_destination(destination_slot_t *destination) {
+    destination_slot_of_node[destination->destination] = EMPTY_SLOT;
+    node_id_release(destination->destination);
+    list_remove(destination_list, destination);
+    memb_free(&destination_memb, destination);
+}
+
+/**
+ * Puts a candidate in place of the best or second best candidate of the destination, if its pheromone value is
+ * smaller. The smaller pheromone value is the better one, as for the link failure notifications.
+ * @param row The row of the candidate, neither the best nor the second best one
+ */
+static void rank_candidate(destination_slot_t *destination, uint8_t row) {
+    uint8_t column = destination_slot(destination);
+    pheromone_t pheromone_value = pheromone_matrix[row][column].pheromone_value;
+    if (destination->best_candidate == EMPTY_SLOT
+        || pheromone_value < pheromone_matrix[destination->best_candidate][column].pheromone_value) {
+        destination->second_best_candidate = destination->best_candidate;
+        destination->best_candidate = row;
+    } else if (destination->second_best_candidate == EMPTY_SLOT
+               || pheromone_value < pheromone_matrix[destination->second_best_candidate][column].pheromone_value) {
+        destination->second_best_candidate = row;
+    }
+}
+
+/**
+ * Searches the best and the second best candidate of the destination among all of its candidates.
+ */
+static void find_best_candidates(destination_slot_t *destination) {
+    uint8_t column = destination_slot(destination);
+    destination->best_candidate = EMPTY_SLOT;
+    destination->second_best_candidate = EMPTY_SLOT;
+    uint8_t row;
+    for (row = destination->first_candidate; row != EMPTY_SLOT; row = pheromone_matrix[row][column].next_candidate) {
+        rank_candidate(destination, row);
+    }
+}
+
+/**
+ * Updates the state cached for the destination after the pheromone value of one of its candidates changed: the
+ * probability distributions are outdated, and the best and second best candidate are adjusted. Only when one of those
+ * two got worse, all candidates are searched again.
+ * @param row The row of the changed candidate
+ */
+static void candidate_changed(destination_slot_t *destination, uint8_t row) {
+    uint8_t column = destination_slot(destination);
+    pheromone_t pheromone_value = pheromone_matrix[row][column].pheromone_value;
+    destination->valid_distributions = 0;
+
+    if (row == destination->best_candidate) {
+        if (destination->second_best_candidate != EMPTY_SLOT
+            && pheromone_matrix[destination->second_best_candidate][column].pheromone_value < pheromone_value) {
+            find_best_candidates(destination);
+        }
+    } else if (row == destination->second_best_candidate) {
+        if (pheromone_value < pheromone_matrix[destination->best_candidate][column].pheromone_value) {
+            destination->second_best_candidate = destination->best_candidate;
+            destination->best_candidate = row;
+        } else {
+            find_best_candidates(destination);
+        }
+    } else {
+        rank_candidate(destination, row);
+    }
+}
+
+/**
+ * Sets a cell of the matrix and counts the neighbour for the destination. A newly used cell is added to the candidates
+ * of the destination.
+ */
+static void set_cell(pheromone_entry_t *neighbour, destination_slot_t *destination, pheromone_t pheromone_value, hop_t hops) {
+    uint8_t row = neighbour_slot(neighbour);
+    destination_info_t *cell = &pheromone_matrix[row][destination_slot(destination)];
+    if (!cell->valid) {
+        cell->valid = true;
+        cell->next_candidate = destination->first_candidate;
+        destination->first_candidate = row;
+        ++destination->number_of_neighbours;
+    }
+    cell->pheromone_value = pheromone_value;
+    cell->hops = hops;
+    candidate_changed(destination, row);
+}
+
+/**
+ * Invalidates a cell of the matrix and removes it from the candidates of the destination; the destination slot is
+ * released when no neighbour leads to it anymore.
+ */
+static void clear_cell(pheromone_entry_t *neighbour, destination_slot_t *destination) {
+    uint8_t row = neighbour_slot(neighbour);
+    uint8_t column = destination_slot(destination);
+    destination_info_t *cell = &pheromone_matrix[row][column];
+    if (!cell->valid) {
+        return;
+    }
+    cell->valid = false;
+    destination->valid_distributions = 0;
+
+    uint8_t *link = &destination->first_candidate;
+    while (*link != EMPTY_SLOT && *link != row) {
+        link = &pheromone_matrix[*link][column].next_candidate;
+    }
+    if (*link == row) {
+        *link = cell->next_candidate;
+    }
+    if (row == destination->best_candidate || row == destination->second_best_candidate) {
+        find_best_candidates(destination);
+    }
+
+    if (--destination->number_of_neighbours == 0) {
+        free_destination(destination);
+    }
+}
+
+/*----Table-----------------------------------------------------------------------------------------------------------*/
+
+void pheromone_table_init() {
+    memb_init(&neighbour_memb);
+    memb_init(&destination_memb);
+    list_init(neighbour_list);
+    list_init(destination_list);
+    memset(neighbour_slot_of_node, EMPTY_SLOT, sizeof(neighbour_slot_of_node));
+    memset(destination_slot_of_node, EMPTY_SLOT, sizeof(destination_slot_of_node));
+}
+
+void delete_pheromone_table() {
+    pheromone_entry_t *entry;
+    for (entry = list_head(neighbour_list); entry != NULL; entry = list_item_next(entry)) {
+        node_id_release(entry->neighbour);
+    }
+    destination_slot_t *destination;
+    for (destination = list_head(destination_list); destination != NULL; destination = list_item_next(destination)) {
+        node_id_release(destination->destination);
+    }
+    pheromone_table_init();
+}
+
+void print_pheromone_table() {
+    pheromone_entry_t *entry;
+    for (entry = list_head(neighbour_list); entry != NULL; entry = list_item_next(entry)) {
+        LOG_INFO("Neighbour: ");
+        LOG_INFO_6ADDR(node_id_address(entry->neighbour));
+        LOG_INFO_("\n");
+
+        destination_slot_t *destination;
+        for (destination = list_head(destination_list); destination != NULL; destination = list_item_next(destination)) {
+            destination_info_t *cell = &pheromone_matrix[neighbour_slot(entry)][destination_slot(destination)];
+            if (cell->valid) {
+                LOG_INFO_(" - Destination: ");
+                LOG_INFO_6ADDR(node_id_address(destination->destination));
+                LOG_INFO_(" with pheromone value: %f, hops: %d\n", REAL_TO_FLOAT(cell->pheromone_value), cell->hops);
+            }
+        }
+    }
+}
+
+/**
+ * Calculates P_nd of equation (1) for all candidates of the destination, and caches the cumulative sum along the
+ * candidates in their cells.
+ * @param destination The destination
+ * @param distribution PHEROMONE_DISTRIBUTION_FORWARD or PHEROMONE_DISTRIBUTION_STOCHASTIC
+ */
+static void calc_distribution(destination_slot_t *destination, uint8_t distribution) {
+    uint8_t column = destination_slot(destination);
+    int beta = distribution == PHEROMONE_DISTRIBUTION_FORWARD ? ANT_HOC_NET_BETA_FORWARD : ANT_HOC_NET_BETA_STOCHASTIC;
+
+    pheromone_weight_t sum_of_pheromone_of_neighbours = 0;
+    uint8_t row;
+    for (row = destination->first_candidate; row != EMPTY_SLOT; row = pheromone_matrix[row][column].next_candidate) {
+        sum_of_pheromone_of_neighbours += calc_pheromone_weight(pheromone_matrix[row][column].pheromone_value, beta);
+    }
+
+    probability_t cumulative_probability = 0;
+    for (row = destination->first_candidate; row != EMPTY_SLOT; row = pheromone_matrix[row][column].next_candidate) {
+        destination_info_t *cell = &pheromone_matrix[row][column];
+        cumulative_probability += calc_probability(calc_pheromone_weight(cell->pheromone_value, beta), sum_of_pheromone_of_neighbours);
+        cell->cumulative_probability[distribution] = cumulative_probability;
+    }
+    destination->valid_distributions |= 1 << distribution;
+}
+
+bool neighbours_exists() {
+    return list_head(neighbour_list) != NULL;
+}
+
+int number_of_neighbours() {
+    return list_length(neighbour_list);
+}
+
+bool does_neighbour_exists(uip_ipaddr_t neighbour_addr) {
+    return find_neighbour(&neighbour_addr) != NULL;
+}
+
+int get_neighbours_to_send_to_destination(uip_ipaddr_t destination, bool forward_ant, uip_ipaddr_t *accepted_neighbours,
+                                          int max_accepted_neighbours) {
+    LOG_DBG("Get neighbours to send to destination: ");
+    LOG_DBG_6ADDR(&destination);
+    LOG_DBG_("\n");
+
+    destination_slot_t *destination_entry = find_destination(&destination);
+    if (destination_entry == NULL) {
+        return 0;
+    }
+    uint8_t column = destination_slot(destination_entry);
+
+    // select the distribution on whether data or an ant is going to be sent
+    uint8_t distribution = forward_ant ? PHEROMONE_DISTRIBUTION_FORWARD : PHEROMONE_DISTRIBUTION_STOCHASTIC;
+    if (!(destination_entry->valid_distributions & (1 << distribution))) {
+        calc_distribution(destination_entry, distribution);
+    }
+
+    // the cumulative sum is increasing, so every neighbour from the first one reaching the random number is accepted
+    probability_t rand_number = REAL_FROM_FRACTION(rand(), RAND_MAX);
+    uint8_t first = destination_entry->first_candidate;
+    while (first != EMPTY_SLOT && rand_number > pheromone_matrix[first][column].cumulative_probability[distribution]) {
+        first = pheromone_matrix[first][column].next_candidate;
+    }
+
+    int number_of_accepted = 0;
+    uint8_t row;
+    for (row = first; row != EMPTY_SLOT && number_of_accepted < max_accepted_neighbours;
+         row = pheromone_matrix[row][column].next_candidate) {
+        accepted_neighbours[number_of_accepted++] = *node_id_address(neighbour_of_slot(row)->neighbour);
+    }
+
+    LOG_DBG("Accepted neighbours size: %d\n", number_of_accepted);
+    return number_of_accepted;
+}
+
+pheromone_t* get_pheromone_value(uip_ipaddr_t neighbour, uip_ipaddr_t destination) {
+    destination_info_t *cell = find_cell(&neighbour, &destination);
+    return cell == NULL ? NULL : &cell->pheromone_value;
+}
+
+void create_or_update_pheromone_table(struct reactive_backward_ant ant) {
+    LOG_DBG("Update pheromone table!\n");
+
+    // equation (5)
+    pheromone_t tau_i_d = calc_tau_i_d(ant.time_estimate_T_P, ant.current_hop);
+
+    // hop to look at is no the current hop but the hop before that; makes minus two in total
+    hop_t hops = ant.current_hop - 1 < 0 ? 0 : ant.current_hop - 1;
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+    // the ant only carries its origin and the last node it passed, the hop count still comes from current_hop
+    hop_t hop_to_look_at = 1;
+#else
+    hop_t hop_to_look_at = hops;
+#endif
+
+    uip_ipaddr_t path_neighbour = ant.path[hop_to_look_at];
+    uip_ipaddr_t destination = ant.path[0];
+
+    pheromone_entry_t *neighbour = find_neighbour(&path_neighbour);
+    destination_info_t *cell = find_cell(&path_neighbour, &destination);
+    if (cell != NULL) {
+        // equation (6)
+        cell->pheromone_value = calc_new_pheromone_value(cell->pheromone_value, tau_i_d);
+        destination_slot_t *destination_entry = find_destination(&destination);
+        candidate_changed(destination_entry, neighbour_slot(neighbour));
+        destination_entry->last_ant = clock_time();
+        return;
+    }
+
+    LOG_DBG("No neighbour or no destination is found!\n");
+    if (neighbour == NULL) {
+        LOG_DBG("Neighbour ");
+        LOG_DBG_6ADDR(&path_neighbour);
+        LOG_DBG_(" not yet in pheromone table - add new entry.\n");
+        neighbour = allocate_neighbour(&path_neighbour);
+        if (neighbour == NULL) {
+            return;
+        }
+    }
+
+    destination_slot_t *destination_entry = get_or_allocate_destination(&destination);
+    if (destination_entry == NULL) {
+        return;
+    }
+    set_cell(neighbour, destination_entry, calc_new_pheromone_value(0, tau_i_d), hops);
+    destination_entry->last_ant = clock_time();
+}
+
+pheromone_entry_t *next_neighbour_entry(pheromone_entry_t *entry) {
+    return entry == NULL ? list_head(neighbour_list) : list_item_next(entry);
+}
+
+int number_of_destinations() {
+    return list_length(destination_list);
+}
+
+/**
+ * Returns the row of the candidate of the destination with the largest pheromone value. The cached best candidate is
+ * the one with the smallest pheromone value, so the candidates are searched.
+ * @return The row of the candidate, EMPTY_SLOT if there is none
+ */
+static uint8_t strongest_candidate(destination_slot_t *destination) {
+    uint8_t column = destination_slot(destination);
+    uint8_t best = EMPTY_SLOT;
+    uint8_t row;
+    for (row = destination->first_candidate; row != EMPTY_SLOT; row = pheromone_matrix[row][column].next_candidate) {
+        if (best == EMPTY_SLOT || pheromone_matrix[row][column].pheromone_value > pheromone_matrix[best][column].pheromone_value) {
+            best = row;
+        }
+    }
+    return best;
+}
+
+const pheromone_destination_t *next_best_path(const pheromone_destination_t *iterator, uip_ipaddr_t *destination,
+                                              pheromone_t *pheromone_value, hop_t *hops) {
+    // the iterator is the slot of the destination
+    destination_slot_t *destination_entry = iterator == NULL ? list_head(destination_list)
+                                                             : list_item_next((void *) iterator);
+    if (destination_entry == NULL) {
+        return NULL;
+    }
+    uint8_t column = destination_slot(destination_entry);
+    uint8_t best = strongest_candidate(destination_entry);
+    *destination = *node_id_address(destination_entry->destination);
+    *pheromone_value = best != EMPTY_SLOT ? pheromone_matrix[best][column].pheromone_value : REAL_CONST(0.0);
+    *hops = best != EMPTY_SLOT ? pheromone_matrix[best][column].hops : 0;
+    return (const pheromone_destination_t *) destination_entry;
+}
+
+bool get_best_path(uip_ipaddr_t destination, uip_ipaddr_t *neighbour, pheromone_t *pheromone_value, hop_t *hops,
+                   clock_time_t *last_ant) {
+    destination_slot_t *destination_entry = find_destination(&destination);
+    uint8_t best = destination_entry == NULL ? EMPTY_SLOT : strongest_candidate(destination_entry);
+    if (best == EMPTY_SLOT) {
+        return false;
+    }
+    destination_info_t *cell = &pheromone_matrix[best][destination_slot(destination_entry)];
+    *neighbour = *node_id_address(neighbour_of_slot(best)->neighbour);
+    *pheromone_value = cell->pheromone_value;
+    *hops = cell->hops;
+    *last_ant = destination_entry->last_ant;
+    return true;
+}
+
+pheromone_t get_pheromone_sum_to_destination(uip_ipaddr_t destination) {
+    destination_slot_t *destination_entry = find_destination(&destination);
+    pheromone_t sum = REAL_CONST(0.0);
+    if (destination_entry == NULL) {
+        return sum;
+    }
+    uint8_t column = destination_slot(destination_entry);
+    for (uint8_t row = destination_entry->first_candidate; row != EMPTY_SLOT; row = pheromone_matrix[row][column].next_candidate) {
+        sum += pheromone_matrix[row][column].pheromone_value;
+    }
+    return sum;
+}
+
+int reset_hello_loss_timer(uip_ipaddr_t neighbour_address) {
+    pheromone_entry_t *entry = find_neighbour(&neighbour_address);
+    if (entry == NULL) {
+        return 0;
+    }
+    // reset the hello loss and set counter to 0; the sweep timer isn't touched, the neighbour is checked later
+    entry->last_heard = clock_time();
+    entry->hello_loss_counter = 0;
+    LOG_DBG("Neighbour already in pheromone table - timer and count reset.\n");
+    return 1;
+}
+
+void set_hello_interval(uip_ipaddr_t neighbour_address, clock_time_t interval) {
+    pheromone_entry_t *entry = find_neighbour(&neighbour_address);
+    if (entry != NULL) {
+        entry->hello_interval = interval;
+        entry->last_heard = clock_time();
+        entry->hello_loss_counter = 0;
+        schedule_hello_loss_sweep(entry->last_heard + interval);
+    }
+}
+
+void set_neighbour_reached(uip_ipaddr_t neighbour_address) {
+    pheromone_entry_t *entry = find_neighbour(&neighbour_address);
+    if (entry != NULL) {
+        entry->last_reached = clock_time();
+    }
+}
+
+clock_time_t longest_time_since_neighbour_reached() {
+    clock_time_t now = clock_time();
+    clock_time_t longest = 0;
+    for (pheromone_entry_t *entry = list_head(neighbour_list); entry != NULL; entry = list_item_next(entry)) {
+        if (now - entry->last_reached > longest) {
+            longest = now - entry->last_reached;
+        }
+    }
+    return longest;
+}
+
+void add_neighbour_to_pheromone_table(uip_ipaddr_t neighbour_address, pheromone_t pheromone_value) {
+    LOG_DBG("Add neighbour to pheromone table.\n");
+
+    if (reset_hello_loss_timer(neighbour_address)) {
+        // the neighbour was found, timer reset, no need to add a new neighbour
+        return;
+    }
+
+    LOG_DBG("Neighbour not in pheromone table - add new entry.\n");
+    destination_slot_t *destination_entry = get_or_allocate_destination(&neighbour_address);
+    if (destination_entry == NULL) {
+        return;
+    }
+    pheromone_entry_t *entry = allocate_neighbour(&neighbour_address);
+    if (entry == NULL) {
+        if (destination_entry->number_of_neighbours == 0) {
+            // release the destination slot again, that was just taken
+            free_destination(destination_entry);
+        }
+        return;
+    }
+    set_cell(entry, destination_entry, pheromone_value, 1);
+
+    LOG_DBG("New Neighbour added: ");
+    LOG_DBG_6ADDR(&neighbour_address);
+    LOG_DBG_(".\n");
+}
+
+void delete_neighbour_from_pheromone_table(uip_ipaddr_t neighbour_address) {
+    LOG_DBG("Delete neighbour from pheromone table.\n");
+    pheromone_entry_t *entry = find_neighbour(&neighbour_address);
+    if (entry == NULL) {
+        return;
+    }
+
+    // clear the row of the neighbour; the next destination is fetched first, since the slot may be released
+    destination_slot_t *destination = list_head(destination_list);
+    while (destination != NULL) {
+        destination_slot_t *next = list_item_next(destination);
+        clear_cell(entry, destination);
+        destination = next;
+    }
+
+    LOG_DBG("Neighbour deleted: ");
+    LOG_DBG_6ADDR(&neighbour_address);
+    LOG_DBG_(".\n");
+    neighbour_slot_of_node[entry->neighbour] = EMPTY_SLOT;
+    node_id_release(entry->neighbour);
+    list_remove(neighbour_list, entry);
+    memb_free(&neighbour_memb, entry);
+}
+
+void delete_destination_from_pheromone_table(uip_ipaddr_t destination, uip_ipaddr_t neighbour) {
+    LOG_DBG("Delete destination from pheromone table.\n");
+    pheromone_entry_t *entry = find_neighbour(&neighbour);
+    destination_slot_t *destination_entry = find_destination(&destination);
+    if (entry == NULL || destination_entry == NULL) {
+        return;
+    }
+    clear_cell(entry, destination_entry);
+}
+
+/**
+ * Checks whether the route over the neighbour is the best route to the destination, and if so fills in the best
+ * remaining route, the same way as it is done for the linked list table. The best and second best candidate are kept
+ * up to date for every destination, so that no other neighbour has to be searched.
+ * @param neighbour The neighbour whose route is lost
+ * @param destination The destination
+ * @param entry Where the link failure notification entry is written to
+ * @return True if the entry has to be part of the notification, false if a better route exists
+ */
+static bool fill_link_failure_notification_entry(pheromone_entry_t *neighbour, destination_slot_t *destination,
+                                                 link_failure_notification_entry_t *entry) {
+    uint8_t column = destination_slot(destination);
+    uint8_t lost_row = neighbour_slot(neighbour);
+    destination_info_t *lost = &pheromone_matrix[lost_row][column];
+
+    // another route is better than the lost one, so no entry is needed
+    if (pheromone_matrix[destination->best_candidate][column].pheromone_value < lost->pheromone_value) {
+        return false;
+    }
+    uint8_t new_best_row = destination->best_candidate != lost_row ? destination->best_candidate
+                                                                   : destination->second_best_candidate;
+    destination_info_t *new_best_destination = new_best_row != EMPTY_SLOT ? &pheromone_matrix[new_best_row][column] : NULL;
+
+    entry->uip_address_of_destination = *node_id_address(destination->destination);
+    if (new_best_destination != NULL) {
+        entry->number_of_hops_to_new_best_destination = new_best_destination->hops;
+        entry->time_estimate_T_P_of_new_best_destination = new_best_destination->pheromone_value;
+    } else {
+        // no best path (after the lost one) was found
+        entry->number_of_hops_to_new_best_destination = 0;
+        entry->time_estimate_T_P_of_new_best_destination = REAL_CONST(-100.0);
+    }
+    return true;
+}
+
+link_failure_notification_entry_t *creat_link_failure_notification_entries(uip_ipaddr_t neighbour_address, int *length_of_notification_list) {
+    LOG_DBG("Create link failure notification entries.\n");
+    *length_of_notification_list = 0;
+
+    pheromone_entry_t *neighbour = find_neighbour(&neighbour_address);
+    if (neighbour == NULL) {
+        return NULL;
+    }
+
+    // the list can't be longer than the number of destinations of the neighbour
+    int number_of_destinations = 0;
+    destination_slot_t *destination;
+    for (destination = list_head(destination_list); destination != NULL; destination = list_item_next(destination)) {
+        if (pheromone_matrix[neighbour_slot(neighbour)][destination_slot(destination)].valid) {
+            ++number_of_destinations;
+        }
+    }
+    if (number_of_destinations == 0) {
+        return NULL;
+    }
+
+    link_failure_notification_entry_t *list = malloc(number_of_destinations * sizeof(link_failure_notification_entry_t));
+    if (list == NULL) {
+        LOG_ERR("Memory allocation for link failure notification failed!\n");
+        return NULL;
+    }
+
+    for (destination = list_head(destination_list); destination != NULL; destination = list_item_next(destination)) {
+        if (!pheromone_matrix[neighbour_slot(neighbour)][destination_slot(destination)].valid) {
+            continue;
+        }
+        if (fill_link_failure_notification_entry(neighbour, destination, &list[*length_of_notification_list])) {
+            ++(*length_of_notification_list);
+        }
+    }
+
+    if (*length_of_notification_list == 0) {
+        free(list);
+        return NULL;
+    }
+    return list;
+}
+
+link_failure_notification_entry_t * update_pheromone_after_link_failure(link_failure_notification_t link_failure_notification, int *length_of_notification_list) {
+    LOG_DBG("Update pheromone after link failure.\n");
+    *length_of_notification_list = 0;
+
+    if (link_failure_notification.size_of_list_of_destinations == 0) {
+        return NULL;
+    }
+    link_failure_notification_entry_t *list = malloc(link_failure_notification.size_of_list_of_destinations * sizeof(link_failure_notification_entry_t));
+    if (list == NULL) {
+        LOG_ERR("Memory allocation for link failure notification failed!\n");
+        return NULL;
+    }
+
+    pheromone_entry_t *neighbour = find_neighbour(&link_failure_notification.source);
+
+    for (int i = 0; i < link_failure_notification.size_of_list_of_destinations; i++) {
+        link_failure_notification_entry_t *received = &link_failure_notification.entries[i];
+
+        if (received->number_of_hops_to_new_best_destination == 0 && received->time_estimate_T_P_of_new_best_destination == REAL_CONST(-100.0)) {
+            // the neighbour of the lost link has no path to the destination anymore, thus this node has to remove the
+            // destination over this neighbour, and notify its neighbours if that was its best path
+            destination_slot_t *destination = find_destination(&received->uip_address_of_destination);
+            if (neighbour != NULL && destination != NULL
+                && pheromone_matrix[neighbour_slot(neighbour)][destination_slot(destination)].valid) {
+                if (fill_link_failure_notification_entry(neighbour, destination, &list[*length_of_notification_list])) {
+                    ++(*length_of_notification_list);
+                }
+                clear_cell(neighbour, destination);
+            }
+        } else {
+            destination_info_t *cell = find_cell(&link_failure_notification.source, &received->uip_address_of_destination);
+            if (cell != NULL) {
+                pheromone_t tau_i_d = calc_tau_i_d(received->time_estimate_T_P_of_new_best_destination, received->number_of_hops_to_new_best_destination);
+                cell->pheromone_value = calc_new_pheromone_value(cell->pheromone_value, tau_i_d);
+                cell->hops = received->number_of_hops_to_new_best_destination;
+                candidate_changed(find_destination(&received->uip_address_of_destination), neighbour_slot(neighbour));
+            }
+        }
+    }
+
+    if (*length_of_notification_list == 0) {
+        free(list);
+        return NULL;
+    }
+    return list;
+}
+
+#endif /* ANT_HOC_NET_FLAT_PHEROMONE_TABLE */
@@ -4,13 +4,13 @@
  */
 
 #include "anthocnet-pheromone.h"
+#include "anthocnet-node-id.h"
+#include "anthocnet-fixed-point.h"
 #include "anthocnet-conf.h"
 #include "anthocnet-types.h"
 #include "anthocnet.h"
 #include <stdbool.h>
 #include <stdlib.h>
-#include <time.h>
-#include <math.h>
 
 // logging
 #include "sys/log.h"
@@ -21,13 +21,192 @@
 #define LOG_LEVEL LOG_LEVEL_NONE
 #endif
 
+// the fixed-capacity table is implemented in anthocnet-pheromone-flat.c
+#if !ANT_HOC_NET_FLAT_PHEROMONE_TABLE
+
+/**
+ * Destination-major index of the pheromone table. For every known destination, it chains the destination entries of
+ * all neighbours that have a path to that destination (over destination_info_t.next_candidate).
+ */
+typedef struct destination_index {
+    struct destination_index *next;     // next destination of the index
+    node_id_t destination;              // node id of the destination
+    destination_info_t *candidates;     // first destination entry of a neighbour that leads to the destination
+    uint8_t valid_distributions;        // bit per PHEROMONE_DISTRIBUTION_*, set if the cached probabilities are up to date
+    destination_info_t *best;           // candidate with the smallest pheromone value, NULL if none
+    destination_info_t *second_best;    // candidate with the second smallest pheromone value, NULL if none
+    clock_time_t last_ant;              // when a backward ant updated a path to the destination, or it was added
+} destination_index_t;
 
 pheromone_entry_t *pheromone_table;
+destination_index_t *destination_index;
 
 pheromone_entry_t* get_pheromone_tabel_head();
 
 void pheromone_table_init() {
     pheromone_table = NULL;
+    destination_index = NULL;
+}
+
+/**
+ * Returns the index entry of a destination.
+ * @param destination The node id of the destination
+ * @return The index entry, NULL if no neighbour leads to the destination
+ */
+static destination_index_t *find_destination_index(node_id_t destination) {
+    destination_index_t *index = destination_index;
+    while (index != NULL) {
+        if (index->destination == destination) {
+            return index;
+        }
+        index = index->next;
+    }
+    return NULL;
+}
+
+/**
+ * Puts a candidate in place of the best or second best candidate of its destination, if its pheromone value is smaller.
+ * The smaller pheromone value is the better one, as for the link failure notifications.
+ * @param index The index entry of the destination
+ * @param destination_entry The candidate, neither the best nor the second best one
+ */
+static void rank_candidate(destination_index_t *index, destination_info_t *destination_entry) {
+    if (index->best == NULL || destination_entry->pheromone_value < index->best->pheromone_value) {
+        index->second_best = index->best;
+        index->best = destination_entry;
+    } else if (index->second_best == NULL || destination_entry->pheromone_value < index->second_best->pheromone_value) {
+        index->second_best = destination_entry;
+    }
+}
+
+/**
+ * Searches the best and the second best candidate of a destination among all of its candidates.
+ * @param index The index entry of the destination
+ */
+static void find_best_candidates(destination_index_t *index) {
+    index->best = NULL;
+    index->second_best = NULL;
+    destination_info_t *candidate;
+    for (candidate = index->candidates; candidate != NULL; candidate = candidate->next_candidate) {
+        rank_candidate(index, candidate);
+    }
+}
+
+/**
+ * Updates the state cached for a destination after the pheromone value of one of its candidates changed: the
+ * probability distributions are outdated, and the best and second best candidate are adjusted. Only when one of those
+ * two got worse, all candidates are searched again.
+ * @param destination_entry The changed candidate
+ */
+static void candidate_changed(destination_info_t *destination_entry) {
+    destination_index_t *index = destination_entry->index;
+    if (index == NULL) {
+        return;
+    }
+    index->valid_distributions = 0;
+
+    if (destination_entry == index->best) {
+        if (index->second_best != NULL && index->second_best->pheromone_value < destination_entry->pheromone_value) {
+            find_best_candidates(index);
+        }
+    } else if (destination_entry == index->second_best) {
+        if (destination_entry->pheromone_value < index->best->pheromone_value) {
+            index->second_best = index->best;
+            index->best = destination_entry;
+        } else {
+            find_best_candidates(index);
+        }
+    } else {
+        rank_candidate(index, destination_entry);
+    }
+}
+
+/**
+ * Adds a destination entry of a neighbour to the candidates of its destination, the index entry of the destination is
+ * created if necessary.
+ * @param destination_entry The new destination entry
+ * @param neighbour_entry The neighbour the destination entry belongs to
+ */
+static void add_candidate(destination_info_t *destination_entry, pheromone_entry_t *neighbour_entry) {
+    destination_entry->neighbour_entry = neighbour_entry;
+    destination_entry->next_candidate = NULL;
+    destination_entry->index = NULL;
+
+    destination_index_t *index = find_destination_index(destination_entry->destination);
+    if (index == NULL) {
+        index = (destination_index_t *)malloc(sizeof(destination_index_t));
+        if (index == NULL) {
+            LOG_ERR("Memory allocation for destination index failed!\n");
+            return;
+        }
+        index->destination = destination_entry->destination;
+        index->candidates = NULL;
+        index->valid_distributions = 0;
+        index->best = NULL;
+        index->second_best = NULL;
+        index->last_ant = clock_time();
+        index->next = destination_index;
+        destination_index = index;
+    }
+    destination_entry->index = index;
+    destination_entry->next_candidate = index->candidates;
+    index->candidates = destination_entry;
+    candidate_changed(destination_entry);
+}
+
+/**
+ * Records that a backward ant updated the path of a destination entry, see get_best_path().
+ * @param destination_entry The updated destination entry
+ */
+static void path_updated_by_ant(destination_info_t *destination_entry) {
+    if (destination_entry->index != NULL) {
+        destination_entry->index->last_ant = clock_time();
+    }
+}
+
+/**
+ * Removes a destination entry from the candidates of its destination, before it is freed. The index entry of the
+ * destination is freed, when no candidate is left.
+ * @param destination_entry The destination entry to remove
+ */
+static void remove_candidate(destination_info_t *destination_entry) {
+    destination_index_t *index = destination_entry->index;
+    if (index == NULL) {
+        return;
+    }
+
+    destination_info_t **candidate = &index->candidates;
+    while (*candidate != NULL && *candidate != destination_entry) {
+        candidate = &(*candidate)->next_candidate;
+    }
+    if (*candidate != NULL) {
+        *candidate = destination_entry->next_candidate;
+    }
+    index->valid_distributions = 0;
+    if (destination_entry == index->best || destination_entry == index->second_best) {
+        find_best_candidates(index);
+    }
+
+    if (index->candidates == NULL) {
+        destination_index_t **link = &destination_index;
+        while (*link != NULL && *link != index) {
+            link = &(*link)->next;
+        }
+        if (*link != NULL) {
+            *link = index->next;
+        }
+        free(index);
+    }
+}
+
+/**
+ * Frees a destination entry after removing it from the index, and releases its node id.
+ * @param destination_entry The destination entry to free
+ */
+static void free_destination_entry(destination_info_t *destination_entry) {
+    remove_candidate(destination_entry);
+    node_id_release(destination_entry->destination);
+    free(destination_entry);
 }
 
 void delete_pheromone_table() {
@@ -39,12 +218,12 @@ void delete_pheromone_table() {
         {
             destination_info_t *temp_dest= destination_info;
             destination_info = destination_info->next;
-            free(temp_dest);
+            free_destination_entry(temp_dest);
         }
 
         // delete pheromone entry
         pheromone_entry_t *temp = table;
-        ctimer_stop(&table->hello_timer);
+        node_id_release(table->neighbour);
         table = table->next;
         free(temp);
     }
@@ -64,42 +243,20 @@ void print_pheromone_table() {
     while(tabel != NULL)
     {
         LOG_INFO("Neighbour: ");
-        LOG_INFO_6ADDR(&tabel->neighbour);
+        LOG_INFO_6ADDR(node_id_address(tabel->neighbour));
         LOG_INFO_("\n");
         destination_info_t *dest_entry = tabel->destination_entry;
 
         while (dest_entry != NULL) {
             LOG_INFO_(" - Destination: ");
-            LOG_INFO_6ADDR(&dest_entry->destination);
-            LOG_INFO_(" with pheromone value: %f, hops: %d\n", dest_entry->pheromone_value, dest_entry->hops);
+            LOG_INFO_6ADDR(node_id_address(dest_entry->destination));
+            LOG_INFO_(" with pheromone value: %f, hops: %d\n", REAL_TO_FLOAT(dest_entry->pheromone_value), dest_entry->hops);
             dest_entry = dest_entry->next;
         }
         tabel = tabel->next;
     }
 }
 
-/**
- * Calculates the probability that neighbour n to destination d is picked.\n
- * Equation (1) of AntHocNet paper
- * @param pheromone_value Pheromone value of the path over n to d
- * @param sum_of_pheromones_of_neighbours Sum of pheromone values of all neighbours where a path to d exists
- * @param beta Beta, needed for the equation
- * @return
- */
-double calc_Pnd(float pheromone_value, float sum_of_pheromones_of_neighbours, int beta) {
-    LOG_DBG("calc_Pnd: pheromone_value %f, sum_of_pheromone_of_neighbours %f, beta %d\n", pheromone_value, sum_of_pheromones_of_neighbours, beta);
-
-    double power = pow(pheromone_value, beta);
-
-    // if pheromone value 0 but sum also 0 then a neighbour was found
-    float P_nd = (float)1.0;
-    if (sum_of_pheromones_of_neighbours > 0.0) {
-        P_nd = (float)(power / sum_of_pheromones_of_neighbours);
-    }
-
-    return P_nd;
-}
-
 bool neighbours_exists() {
     pheromone_entry_t *tabel = get_pheromone_tabel_head();
     if (tabel != NULL) {
@@ -108,10 +265,38 @@ bool neighbours_exists() {
     return false;
 }
 
+int number_of_neighbours() {
+    int number = 0;
+    for (pheromone_entry_t *table = get_pheromone_tabel_head(); table != NULL; table = table->next) {
+        ++number;
+    }
+    return number;
+}
+
+/**
+ * Returns the neighbour entry of a node.
+ * @param neighbour The node id of the neighbour
+ * @return The neighbour entry, NULL if the node is no neighbour
+ */
+static pheromone_entry_t *find_neighbour_entry(node_id_t neighbour) {
+    if (neighbour == NODE_ID_NONE) {
+        return NULL;
+    }
+    pheromone_entry_t *table = get_pheromone_tabel_head();
+    while (table != NULL) {
+        if (table->neighbour == neighbour) {
+            return table;
+        }
+        table = table->next;
+    }
+    return NULL;
+}
+
 bool does_neighbour_exists(uip_ipaddr_t neighbour_addr) {
+    node_id_t neighbour = node_id_lookup(&neighbour_addr);
     pheromone_entry_t *tabel = get_pheromone_tabel_head();
     while(tabel != NULL) {
-        if (uip_ipaddr_cmp(&neighbour_addr, &tabel->neighbour)) {
+        if (neighbour == tabel->neighbour) {
             return true;
         }
         tabel = tabel->next;
@@ -119,185 +304,124 @@ bool does_neighbour_exists(uip_ipaddr_t neighbour_addr) {
     return false;
 }
 
-uip_ipaddr_t* get_neighbours_to_send_to_destination(uip_ipaddr_t destination, bool forward_ant, int* accepted_neighbour_size) {
-    LOG_DBG("Get neighbours to send to destination: ");
-    LOG_DBG_6ADDR(&destination);
-    LOG_DBG_("\n");
-    float sum_of_pheromone_of_neighbours = (float)0.0;
-    pnd_neighbours_t *head = (pnd_neighbours_t *)malloc(sizeof(pnd_neighbours_t));
-    // select beta on whether data or an ant is going to be sent
-    int beta = forward_ant ? ANT_HOC_NET_BETA_FORWARD : ANT_HOC_NET_BETA_STOCHASTIC;
-
-    head->length = 0;
-
-    pheromone_entry_t *pheromone_head = get_pheromone_tabel_head();
-    pheromone_entry_t *table = pheromone_head;
-
-    // loop over neighbours
-    while(table != NULL) {
-        destination_info_t *dest_entry = table->destination_entry;
-        LOG_DBG("Neighbour: ");
-        LOG_DBG_6ADDR(&table->neighbour);
-        LOG_DBG_("\n");
-        // loop over destinations and search for the destination
-        while(dest_entry != NULL) {
-            LOG_DBG("Destination entry with ip address: ");
-            LOG_DBG_6ADDR(&dest_entry->destination);
-            LOG_DBG_("\n");
-            if (uip_ipaddr_cmp(&destination, &dest_entry->destination)) {
-                // add pheromone value to sum, if destination is found in the table
-                sum_of_pheromone_of_neighbours += (float)pow(dest_entry->pheromone_value, beta);
-
-                // add new neighbour and pheromone to pnd_table to access that information more efficiently later
-                if (head->length == 0) {
-                    head->pheromone_entry_to_the_destination = dest_entry->pheromone_value;
-                    head->neighbour = table->neighbour;
-                    head->next = NULL,
-                    ++head->length;
-                } else  {
-                    pnd_neighbours_t *new = (pnd_neighbours_t *)malloc(sizeof(pnd_neighbours_t));
-                    new->next = head;
-                    new->neighbour = table->neighbour;
-                    new->pheromone_entry_to_the_destination = dest_entry->pheromone_value;
-                    new->length = head->length + 1;
-                    head = new;
-                }
-
-                LOG_DBG("Destination found with pheromone value: %f! Break out of the loop -> stop printing addresses!\n", dest_entry->pheromone_value);
-                // since there is just one entry for one destination, we can break out of the second loop
-                break;
-            }
-            dest_entry = dest_entry->next;
-        }
+/**
+ * Calculates P_nd of equation (1) for all candidates of the destination, and caches the cumulative sum along the
+ * candidates in their destination entries.
+ * @param index The index entry of the destination
+ * @param distribution PHEROMONE_DISTRIBUTION_FORWARD or PHEROMONE_DISTRIBUTION_STOCHASTIC
+ */
+static void calc_distribution(destination_index_t *index, uint8_t distribution) {
+    int beta = distribution == PHEROMONE_DISTRIBUTION_FORWARD ? ANT_HOC_NET_BETA_FORWARD : ANT_HOC_NET_BETA_STOCHASTIC;
 
-        table = table->next;
+    pheromone_weight_t sum_of_pheromone_of_neighbours = 0;
+    destination_info_t *dest_entry;
+    for (dest_entry = index->candidates; dest_entry != NULL; dest_entry = dest_entry->next_candidate) {
+        sum_of_pheromone_of_neighbours += calc_pheromone_weight(dest_entry->pheromone_value, beta);
     }
 
-    LOG_DBG("Sum of pheromone values of neighbours: %f, length: %d\n", sum_of_pheromone_of_neighbours, head->length);
-
-    // head points to the first element of the pnd_neighbour_t list, that
-    // now contains all neighbours, where pheromone values to the destination exist
-
-    if (head->length == 0) {
-        // no destinations were found -> free head pointer
-        free(head);
-        head = NULL;
-        *accepted_neighbour_size = 0;
-        return NULL;
+    probability_t cumulative_probability = 0;
+    for (dest_entry = index->candidates; dest_entry != NULL; dest_entry = dest_entry->next_candidate) {
+        probability_t pnd = calc_probability(calc_pheromone_weight(dest_entry->pheromone_value, beta), sum_of_pheromone_of_neighbours);
+        LOG_DBG("Pnd: %f\n", REAL_TO_FLOAT(pnd));
+        cumulative_probability += pnd;
+        dest_entry->cumulative_probability[distribution] = cumulative_probability;
     }
+    index->valid_distributions |= 1 << distribution;
+}
 
-    uip_ipaddr_t *accepted_neighbours = (uip_ipaddr_t *)malloc(0 * sizeof(uip_ipaddr_t));
-    *accepted_neighbour_size = 0;
-
-    //srand(time(NULL));
-
-    // calculate the probabilities pnds, order them increasing, calc cumulative sum
-    int pnd_entry_len = head->length;
-    double cumulative_probs[pnd_entry_len];
-    int cumulative_prob_counter = 0;
-
-    // first element of the list
-    pnd_neighbours_t *pnd_entry = head;
-    while (pnd_entry != NULL) {
+int get_neighbours_to_send_to_destination(uip_ipaddr_t destination, bool forward_ant, uip_ipaddr_t *accepted_neighbours,
+                                          int max_accepted_neighbours) {
+    LOG_DBG("Get neighbours to send to destination: ");
+    LOG_DBG_6ADDR(&destination);
+    LOG_DBG_("\n");
 
-        double pnd = calc_Pnd(pnd_entry->pheromone_entry_to_the_destination, sum_of_pheromone_of_neighbours, beta);
+    node_id_t destination_id = node_id_lookup(&destination);
+    destination_index_t *index = destination_id != NODE_ID_NONE ? find_destination_index(destination_id) : NULL;
+    if (index == NULL) {
+        // no neighbour has a path to the destination
+        return 0;
+    }
 
-        LOG_DBG("Pnd: %f\n", pnd);
+    // select the distribution on whether data or an ant is going to be sent
+    uint8_t distribution = forward_ant ? PHEROMONE_DISTRIBUTION_FORWARD : PHEROMONE_DISTRIBUTION_STOCHASTIC;
+    if (!(index->valid_distributions & (1 << distribution))) {
+        calc_distribution(index, distribution);
+    }
 
-        // calculate cumulative sum to pick the neighbours accordingly
-        if (cumulative_prob_counter == 0) {
-            cumulative_probs[cumulative_prob_counter] = pnd;
-        } else {
-            cumulative_probs[cumulative_prob_counter] = cumulative_probs[cumulative_prob_counter - 1] + pnd;
-        }
-        cumulative_prob_counter++;
-        pnd_entry = pnd_entry->next;
-    }
-
-    double rand_number = (double) rand() / RAND_MAX;
-    cumulative_prob_counter = 0;
-    while (head != NULL) {
-        // check whether the entry of the cumulative sum is greater than the random number,
-        // if that is the case, the neighbour was selected
-        // that should be true for one node
-        // after that use the loop to free the space
-        LOG_DBG("Random number %f vs cumulative probability %f\n", rand_number, cumulative_probs[cumulative_prob_counter]);
-        if (rand_number <= cumulative_probs[cumulative_prob_counter]) {
-
-            (*accepted_neighbour_size)++;
-            uip_ipaddr_t *bigger_array = (uip_ipaddr_t *) realloc(accepted_neighbours, *accepted_neighbour_size * sizeof(uip_ipaddr_t));
-            if (bigger_array != NULL) {
-                accepted_neighbours = bigger_array;
-                LOG_DBG("Accepted neighbour: ");
-                LOG_DBG_6ADDR(&head->neighbour);
-                LOG_DBG_(".\n");
-                accepted_neighbours[*accepted_neighbour_size - 1] = head->neighbour;
-            }
-        }
-        cumulative_prob_counter++;
+    // check whether the entry of the cumulative sum is greater than the random number, if that is the case, the
+    // neighbour was selected; since the sum is increasing, all following neighbours are selected as well
+    probability_t rand_number = REAL_FROM_FRACTION(rand(), RAND_MAX);
+    destination_info_t *first = index->candidates;
+    while (first != NULL && rand_number > first->cumulative_probability[distribution]) {
+        first = first->next_candidate;
+    }
 
-        // free pnd_entry list
-        pnd_neighbours_t* temp = head;
-        head = head->next;
-        free(temp);
+    int number_of_accepted = 0;
+    destination_info_t *dest_entry;
+    for (dest_entry = first; dest_entry != NULL && number_of_accepted < max_accepted_neighbours;
+         dest_entry = dest_entry->next_candidate) {
+        LOG_DBG("Accepted neighbour: ");
+        LOG_DBG_6ADDR(node_id_address(dest_entry->neighbour_entry->neighbour));
+        LOG_DBG_(".\n");
+        accepted_neighbours[number_of_accepted++] = *node_id_address(dest_entry->neighbour_entry->neighbour);
     }
 
-    LOG_DBG("Accepted neighbours size: %d\n", *accepted_neighbour_size);
-    return accepted_neighbours;
+    LOG_DBG("Accepted neighbours size: %d\n", number_of_accepted);
+    return number_of_accepted;
 }
 
-float* get_pheromone_value(uip_ipaddr_t neighbour, uip_ipaddr_t destination) {
-    pheromone_entry_t *table = get_pheromone_tabel_head();
-    // find neighbour
-    while(table != NULL) {
-        if (uip_ipaddr_cmp(&neighbour, &table->neighbour)) {
-            destination_info_t *dest_entry = table->destination_entry;
-            // find destination
-            while(dest_entry != NULL) {
-                if (uip_ipaddr_cmp(&destination, &dest_entry->destination)) {
-                    return &table->destination_entry->pheromone_value;
-                }
-                dest_entry = dest_entry->next;
-            }
-            // return NULL if no destination is found
-            return NULL;
+/**
+ * Returns the destination entry of the path over a neighbour to a destination.
+ * @param neighbour The node id of the neighbour
+ * @param destination The node id of the destination
+ * @return The destination entry, NULL if the neighbour or the destination is not found
+ */
+static destination_info_t *find_destination_entry(node_id_t neighbour, node_id_t destination) {
+    pheromone_entry_t *table = find_neighbour_entry(neighbour);
+    if (table == NULL || destination == NODE_ID_NONE) {
+        // return NULL if neighbour is not found
+        return NULL;
+    }
+    destination_info_t *dest_entry = table->destination_entry;
+    // find destination
+    while(dest_entry != NULL) {
+        if (dest_entry->destination == destination) {
+            return dest_entry;
         }
-        table = table->next;
+        dest_entry = dest_entry->next;
     }
-    // return NULL if neighbour is not found
+    // return NULL if no destination is found
     return NULL;
 }
 
+destination_info_t *get_destination_entry(uip_ipaddr_t neighbour_address, uip_ipaddr_t destination_address) {
+    return find_destination_entry(node_id_lookup(&neighbour_address), node_id_lookup(&destination_address));
+}
+
+pheromone_t* get_pheromone_value(uip_ipaddr_t neighbour, uip_ipaddr_t destination) {
+    destination_info_t *dest_entry = get_destination_entry(neighbour, destination);
+    return dest_entry != NULL ? &dest_entry->pheromone_value : NULL;
+}
+
 hop_t* get_hops(uip_ipaddr_t neighbour, uip_ipaddr_t destination) {
-    pheromone_entry_t *table = get_pheromone_tabel_head();
-    // find neighbour
-    while(table != NULL) {
-        if (uip_ipaddr_cmp(&neighbour, &table->neighbour)) {
-            destination_info_t *dest_entry = table->destination_entry;
-            // find destination
-            while(dest_entry != NULL) {
-                if (uip_ipaddr_cmp(&destination, &dest_entry->destination)) {
-                    return &table->destination_entry->hops;
-                }
-                dest_entry = dest_entry->next;
-            }
-            // return NULL if no destination is found
-            return NULL;
-        }
-        table = table->next;
-    }
-    // return NULL if neighbour is not found
-    return NULL;
+    destination_info_t *dest_entry = get_destination_entry(neighbour, destination);
+    return dest_entry != NULL ? &dest_entry->hops : NULL;
 }
 
 void create_or_update_pheromone_table(struct reactive_backward_ant ant) {
     LOG_DBG("Update pheromone table!\n");
 
     // equation (5)
-    double tau_i_d = 1 / ((ant.time_estimate_T_P + (float)ant.current_hop * ANT_HOC_NET_T_HOP) / 2);
+    pheromone_t tau_i_d = calc_tau_i_d(ant.time_estimate_T_P, ant.current_hop);
 
     // hop to look at is no the current hop but the hop before that; makes minus two in total
-    hop_t hop_to_look_at = ant.current_hop - 1 < 0 ? 0 : ant.current_hop - 1;
+    hop_t hops = ant.current_hop - 1 < 0 ? 0 : ant.current_hop - 1;
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+    // the ant only carries its origin and the last node it passed, the hop count still comes from current_hop
+    hop_t hop_to_look_at = 1;
+#else
+    hop_t hop_to_look_at = hops;
+#endif
 
     uip_ipaddr_t path_neighbour = ant.path[hop_to_look_at];
     LOG_DBG("Path neighbour: ");
@@ -306,33 +430,40 @@ void create_or_update_pheromone_table(struct reactive_backward_ant ant) {
     uip_ipaddr_t destination = ant.path[0];
 
     // neighbour, that is hop of now - 1
-    float *pheromone_value_T_i_nd = get_pheromone_value(path_neighbour, destination);
+    destination_info_t *destination_entry_T_i_nd = get_destination_entry(path_neighbour, destination);
 
     // no neighbour or no destination is found
-    if (pheromone_value_T_i_nd == NULL) {
+    if (destination_entry_T_i_nd == NULL) {
         LOG_DBG("No neighbour or no destination is found!\n");
         pheromone_entry_t *head = get_pheromone_tabel_head();
         pheromone_entry_t *table = head;
 
         // a new destination is needed anyway
+        node_id_t destination_id = node_id_acquire(&destination);
+        if (destination_id == NODE_ID_NONE) {
+            return;
+        }
         destination_info_t *new_destination = (destination_info_t*)malloc(sizeof(destination_info_t));
-        new_destination->pheromone_value = (float)((1 - ANT_HOC_NET_GAMMA) * tau_i_d);
-        new_destination->destination = destination;
-        new_destination->hops = hop_to_look_at;
+        new_destination->pheromone_value = calc_new_pheromone_value(0, tau_i_d);
+        new_destination->destination = destination_id;
+        new_destination->hops = hops;
         new_destination->next = NULL;
         LOG_DBG("Created new destination entry with destination: ");
         LOG_DBG_6ADDR(&destination);
         LOG_DBG_(".\n");
 
         // check if the neighbour is existent, if so add the new destination entry to the neighbour
+        node_id_t path_neighbour_id = node_id_lookup(&path_neighbour);
         while(table != NULL) {
             // if a neighbour is found, add new destination entry to the neighbour
-            if (uip_ipaddr_cmp(&table->neighbour, &path_neighbour)) {
+            if (table->neighbour == path_neighbour_id) {
                 LOG_DBG("Path neighbour exists - add destination.\n");
 
                 new_destination->next = table->destination_entry;
                 // add new entry for current destination
                 table->destination_entry = new_destination;
+                add_candidate(new_destination, table);
+                path_updated_by_ant(new_destination);
 
                 // when added stop
                 return;
@@ -344,39 +475,146 @@ void create_or_update_pheromone_table(struct reactive_backward_ant ant) {
         LOG_DBG("Neighbour ");
         LOG_DBG_6ADDR(&path_neighbour);
         LOG_DBG_(" not yet in pheromone table - add new entry.\n");
+        path_neighbour_id = node_id_acquire(&path_neighbour);
+        if (path_neighbour_id == NODE_ID_NONE) {
+            node_id_release(destination_id);
+            free(new_destination);
+            return;
+        }
         pheromone_entry_t *new_entry = (pheromone_entry_t *)malloc(sizeof(pheromone_entry_t));
-        new_entry->neighbour = path_neighbour;
+        new_entry->neighbour = path_neighbour_id;
         new_entry->destination_entry = new_destination;
         new_entry->next = head;
-        ctimer_set(&new_entry->hello_timer, ANT_HOC_NET_T_HELLO_SEC * CLOCK_SECOND, hello_loss_callback_function, new_entry);
+        new_entry->hello_loss_counter = 0;
+        // no frame reached the new neighbour yet
+        new_entry->last_reached = clock_time() - PHEROMONE_DEFAULT_HELLO_INTERVAL;
+        add_candidate(new_destination, new_entry);
+        path_updated_by_ant(new_destination);
+        new_entry->last_heard = clock_time();
+        new_entry->hello_interval = PHEROMONE_DEFAULT_HELLO_INTERVAL;
+        schedule_hello_loss_sweep(new_entry->last_heard + new_entry->hello_interval);
         pheromone_table = new_entry;
         return;
     }
 
     // destination and thus pheromone value is found
     // equation (6)
-    *pheromone_value_T_i_nd = ANT_HOC_NET_GAMMA * (*pheromone_value_T_i_nd) + (1 - ANT_HOC_NET_GAMMA) * tau_i_d;
+    destination_entry_T_i_nd->pheromone_value = calc_new_pheromone_value(destination_entry_T_i_nd->pheromone_value, tau_i_d);
+    candidate_changed(destination_entry_T_i_nd);
+    path_updated_by_ant(destination_entry_T_i_nd);
 }
 
-int reset_hello_loss_timer(uip_ipaddr_t neighbour_address) {
-    pheromone_entry_t *head = get_pheromone_tabel_head();
-    pheromone_entry_t *table = head;
-    while (table != NULL) {
-        // if the neighbour is found, reset its timer and hello loss counter
-        if (uip_ipaddr_cmp(&table->neighbour, &neighbour_address)) {
-            // reset the timer for hello loss
-            ctimer_restart(&table->hello_timer);
-            // set counter to 0
-            table->hello_loss_counter = 0;
-            LOG_DBG("Neighbour already in pheromone table - timer and count reset.\n");
-            return 1;
+pheromone_entry_t *next_neighbour_entry(pheromone_entry_t *entry) {
+    return entry == NULL ? get_pheromone_tabel_head() : entry->next;
+}
+
+int number_of_destinations() {
+    int number = 0;
+    for (destination_index_t *index = destination_index; index != NULL; index = index->next) {
+        ++number;
+    }
+    return number;
+}
+
+/**
+ * Returns the candidate of a destination with the largest pheromone value. The cached best candidate is the one with
+ * the smallest pheromone value, so the candidates are searched.
+ * @param index The index entry of the destination
+ * @return The candidate, NULL if there is none
+ */
+static destination_info_t *strongest_candidate(destination_index_t *index) {
+    destination_info_t *best = NULL;
+    for (destination_info_t *candidate = index->candidates; candidate != NULL; candidate = candidate->next_candidate) {
+        if (best == NULL || candidate->pheromone_value > best->pheromone_value) {
+            best = candidate;
         }
-        table = table->next;
+    }
+    return best;
+}
+
+const pheromone_destination_t *next_best_path(const pheromone_destination_t *iterator, uip_ipaddr_t *destination,
+                                              pheromone_t *pheromone_value, hop_t *hops) {
+    // the iterator is the index entry of the destination
+    destination_index_t *index = iterator == NULL ? destination_index : ((const destination_index_t *) iterator)->next;
+    if (index == NULL) {
+        return NULL;
+    }
+    destination_info_t *best = strongest_candidate(index);
+    *destination = *node_id_address(index->destination);
+    *pheromone_value = best != NULL ? best->pheromone_value : REAL_CONST(0.0);
+    *hops = best != NULL ? best->hops : 0;
+    return (const pheromone_destination_t *) index;
+}
+
+bool get_best_path(uip_ipaddr_t destination, uip_ipaddr_t *neighbour, pheromone_t *pheromone_value, hop_t *hops,
+                   clock_time_t *last_ant) {
+    node_id_t destination_id = node_id_lookup(&destination);
+    destination_index_t *index = destination_id == NODE_ID_NONE ? NULL : find_destination_index(destination_id);
+    destination_info_t *best = index == NULL ? NULL : strongest_candidate(index);
+    if (best == NULL) {
+        return false;
+    }
+    *neighbour = *node_id_address(best->neighbour_entry->neighbour);
+    *pheromone_value = best->pheromone_value;
+    *hops = best->hops;
+    *last_ant = index->last_ant;
+    return true;
+}
+
+pheromone_t get_pheromone_sum_to_destination(uip_ipaddr_t destination) {
+    node_id_t destination_id = node_id_lookup(&destination);
+    destination_index_t *index = destination_id == NODE_ID_NONE ? NULL : find_destination_index(destination_id);
+    pheromone_t sum = REAL_CONST(0.0);
+    for (destination_info_t *candidate = index == NULL ? NULL : index->candidates; candidate != NULL;
+         candidate = candidate->next_candidate) {
+        sum += candidate->pheromone_value;
+    }
+    return sum;
+}
+
+int reset_hello_loss_timer(uip_ipaddr_t neighbour_address) {
+    pheromone_entry_t *table = find_neighbour_entry(node_id_lookup(&neighbour_address));
+    // if the neighbour is found, reset its timer and hello loss counter
+    if (table != NULL) {
+        // the sweep timer isn't touched, the neighbour is checked later than planned
+        table->last_heard = clock_time();
+        // set counter to 0
+        table->hello_loss_counter = 0;
+        LOG_DBG("Neighbour already in pheromone table - timer and count reset.\n");
+        return 1;
     }
     return 0;
 }
 
-void add_neighbour_to_pheromone_table(uip_ipaddr_t neighbour_address, float pheromone_value) {
+void set_hello_interval(uip_ipaddr_t neighbour_address, clock_time_t interval) {
+    pheromone_entry_t *table = find_neighbour_entry(node_id_lookup(&neighbour_address));
+    if (table != NULL) {
+        table->hello_interval = interval;
+        table->last_heard = clock_time();
+        table->hello_loss_counter = 0;
+        schedule_hello_loss_sweep(table->last_heard + interval);
+    }
+}
+
+void set_neighbour_reached(uip_ipaddr_t neighbour_address) {
+    pheromone_entry_t *table = find_neighbour_entry(node_id_lookup(&neighbour_address));
+    if (table != NULL) {
+        table->last_reached = clock_time();
+    }
+}
+
+clock_time_t longest_time_since_neighbour_reached() {
+    clock_time_t now = clock_time();
+    clock_time_t longest = 0;
+    for (pheromone_entry_t *table = get_pheromone_tabel_head(); table != NULL; table = table->next) {
+        if (now - table->last_reached > longest) {
+            longest = now - table->last_reached;
+        }
+    }
+    return longest;
+}
+
+void add_neighbour_to_pheromone_table(uip_ipaddr_t neighbour_address, pheromone_t pheromone_value) {
     LOG_DBG("Add neighbour to pheromone table.\n");
     pheromone_entry_t *head = get_pheromone_tabel_head();
 
@@ -387,23 +625,35 @@ void add_neighbour_to_pheromone_table(uip_ipaddr_t neighbour_address, float pher
     }
 
     LOG_DBG("Neighbour not in pheromone table - add new entry.\n");
+    // the node id is referenced by the neighbour and by its destination entry
+    node_id_t neighbour_id = node_id_acquire(&neighbour_address);
+    if (neighbour_id == NODE_ID_NONE) {
+        return;
+    }
+    node_id_hold(neighbour_id);
+
     // new destination entry
     destination_info_t *new_destination = (destination_info_t*)malloc(sizeof(destination_info_t));
     new_destination->pheromone_value = pheromone_value;
-    new_destination->destination = neighbour_address;
+    new_destination->destination = neighbour_id;
     new_destination->hops = 1;
     new_destination->next = NULL;
 
     // when arrived here, no neighbour with that uip addr is found
     pheromone_entry_t *new_entry = (pheromone_entry_t *)malloc(sizeof(pheromone_entry_t));
-    new_entry->neighbour = neighbour_address;
+    new_entry->neighbour = neighbour_id;
     new_entry->destination_entry = new_destination;
     new_entry->next = head;
     new_entry->hello_loss_counter = 0;
+    // no frame reached the new neighbour yet
+    new_entry->last_reached = clock_time() - PHEROMONE_DEFAULT_HELLO_INTERVAL;
+    add_candidate(new_destination, new_entry);
 
-    ctimer_set(&new_entry->hello_timer, ANT_HOC_NET_T_HELLO_SEC * CLOCK_SECOND, &hello_loss_callback_function, new_entry);
+    new_entry->last_heard = clock_time();
+    new_entry->hello_interval = PHEROMONE_DEFAULT_HELLO_INTERVAL;
+    schedule_hello_loss_sweep(new_entry->last_heard + new_entry->hello_interval);
     LOG_DBG("New Neighbour added: ");
-    LOG_DBG_6ADDR(&new_entry->neighbour);
+    LOG_DBG_6ADDR(&neighbour_address);
     LOG_DBG_(".\n");
     pheromone_table = new_entry;
 }
@@ -413,16 +663,17 @@ void delete_neighbour_from_pheromone_table(uip_ipaddr_t neighbour_address) {
     pheromone_entry_t *head = get_pheromone_tabel_head();
     pheromone_entry_t *table = head;
     pheromone_entry_t *previous = NULL;
+    node_id_t neighbour_id = node_id_lookup(&neighbour_address);
 
     while (table != NULL) {
-        if (uip_ipaddr_cmp(&table->neighbour, &neighbour_address)) {
+        if (neighbour_id != NODE_ID_NONE && table->neighbour == neighbour_id) {
             destination_info_t *entry = table->destination_entry;
 
             // free the destination array
             while (entry != NULL) {
                 destination_info_t *temp = entry;
                 entry = entry->next;
-                free(temp);
+                free_destination_entry(temp);
             }
 
             // set the previous pointer to the neighbour next entry
@@ -434,10 +685,9 @@ void delete_neighbour_from_pheromone_table(uip_ipaddr_t neighbour_address) {
             }
 
             LOG_DBG("Neighbour deleted: ");
-            LOG_DBG_6ADDR(&table->neighbour);
+            LOG_DBG_6ADDR(&neighbour_address);
             LOG_DBG_(".\n");
-            // stop timer
-            ctimer_stop(&table->hello_timer);
+            node_id_release(table->neighbour);
             // free the destination entry
             free(table);
             return;
@@ -451,15 +701,20 @@ void delete_destination_from_pheromone_table(uip_ipaddr_t destination, uip_ipadd
     LOG_DBG("Delete destination from pheromone table.\n");
     pheromone_entry_t *head = get_pheromone_tabel_head();
     pheromone_entry_t *table = head;
+    node_id_t neighbour_id = node_id_lookup(&neighbour);
+    node_id_t destination_id = node_id_lookup(&destination);
+    if (neighbour_id == NODE_ID_NONE || destination_id == NODE_ID_NONE) {
+        return;
+    }
     while (table != NULL) {
-        if(uip_ipaddr_cmp(&neighbour, &table->neighbour)) {
+        if(table->neighbour == neighbour_id) {
             destination_info_t *destination_entry = table->destination_entry;
             destination_info_t *previous_destination = NULL;
 
             while (destination_entry != NULL) {
                 // if destination is found, delete the entry; no need to delete neighbour entry, or create a new empty
                 // destination entry, since the first entry with the neighbour as destination itself always exists
-                if (uip_ipaddr_cmp(&destination, &destination_entry->destination)) {
+                if (destination_entry->destination == destination_id) {
                     destination_info_t * temp = destination_entry;
                     if (previous_destination == NULL) {
                         table->destination_entry = destination_entry->next;
@@ -468,9 +723,9 @@ void delete_destination_from_pheromone_table(uip_ipaddr_t destination, uip_ipadd
                     }
 
                     LOG_DBG("Destination deleted: ");
-                    LOG_DBG_6ADDR(&temp->destination);
+                    LOG_DBG_6ADDR(&destination);
                     LOG_DBG_(".\n");
-                    free(temp);
+                    free_destination_entry(temp);
                     return;
                 }
                 previous_destination = destination_entry;
@@ -483,283 +738,101 @@ void delete_destination_from_pheromone_table(uip_ipaddr_t destination, uip_ipadd
     }
 }
 
+/**
+ * Checks whether the path of a destination entry is the best path to its destination, and if so fills in the best
+ * remaining path. The best and second best candidate are kept up to date for every destination, so that no other
+ * neighbour has to be searched.
+ * @param lost The destination entry of the lost path
+ * @param entry Where the link failure notification entry is written to
+ * @return True if the entry has to be part of the notification, false if a better path exists
+ */
+static bool fill_link_failure_notification_entry(destination_info_t *lost, link_failure_notification_entry_t *entry) {
+    destination_index_t *index = lost->index;
+    if (index == NULL) {
+        return false;
+    }
+    // another path is better than the lost one, so no entry is needed
+    if (index->best->pheromone_value < lost->pheromone_value) {
+        return false;
+    }
+    destination_info_t *new_best_destination = index->best != lost ? index->best : index->second_best;
+
+    entry->uip_address_of_destination = *node_id_address(lost->destination);
+    if (new_best_destination != NULL) {
+        entry->number_of_hops_to_new_best_destination = new_best_destination->hops;
+        entry->time_estimate_T_P_of_new_best_destination = new_best_destination->pheromone_value;
+    } else {
+        // if this is reached, no best path (after the lost one) was found, and no better path exists
+        entry->number_of_hops_to_new_best_destination = 0;
+        entry->time_estimate_T_P_of_new_best_destination = REAL_CONST(-100.0);
+    }
+    return true;
+}
+
 link_failure_notification_entry_t *creat_link_failure_notification_entries(uip_ipaddr_t neighbour_address, int *length_of_notification_list) {
     LOG_DBG("Create link failure notification entries.\n");
-    pheromone_entry_t * head = get_pheromone_tabel_head();
-    pheromone_entry_t * table = head;
-
     *length_of_notification_list = 0;
-    link_failure_notification_entry_t * list_destinations_of_lost_neighbour = (link_failure_notification_entry_t *)malloc(*length_of_notification_list * sizeof (link_failure_notification_entry_t));
 
-    destination_info_t * destinations_of_neighbours_head = NULL;
-
-    // loop through pheromone table and get the pointer to the first destination entry of the searched neighbour
-    while (table != NULL) {
-        if (uip_ipaddr_cmp(&neighbour_address, &table->neighbour)) {
-            destinations_of_neighbours_head = table->destination_entry;
-            break;
-        }
-        table = table->next;
+    pheromone_entry_t *table = find_neighbour_entry(node_id_lookup(&neighbour_address));
+    if (table == NULL) {
+        return NULL;
     }
 
-    destination_info_t * destinations_of_neighbours = destinations_of_neighbours_head;
-
-    // loop through the destination entries of the lost neighbour
-    while(destinations_of_neighbours != NULL) {
-        // to safe the new best destination
-        destination_info_t *new_best_destination = NULL;
-
-        // to be able to break out of both loops when a better destination entry than of the lost neighbour is found
-        // also used to save if a better neighbour was found
-        // (the check on new_best_destiantion == NULL is not enough,
-        // since it's null, if no neighbour was found and if a better than the lost neighbour was found)
-        bool done = false;
-
-        table = head;
-
-        // loop through pheromone table
-        while (table != NULL) {
-            // skip the entry of the lost neighbour
-            if (uip_ipaddr_cmp(&neighbour_address, &table->neighbour)) {
-                table = table->next;
-                continue;
-            }
-            destination_info_t *destination_entry = table->destination_entry;
-
-            // loop through all destination entries of the current neighbour
-            while (destination_entry != NULL) {
-                // continue if address of destination is not the same as the destination entry of the lost neighbour
-                if (!uip_ipaddr_cmp(&destination_entry->destination, &destinations_of_neighbours->destination)) {
-                    destination_entry = destination_entry->next;
-                    continue;
-                }
-                /* check if pheromone value of current destination entry is smaller than that of the lost neighbour
-                 * if smaller:      delete new_best_destination, since the destination of the lost neighbour is not the best
-                 * if not smaller:  the destination of the lost neighbour might have the best path
-                 *                  -> compare to new_best_destination, assign if better
-                 */
-                // the current destination is better than the lost one
-                if (destination_entry->pheromone_value < destinations_of_neighbours->pheromone_value) {
-                    // the lost destination is not the best
-                    // thus no entry must be created since there is a path to the destination
-                    new_best_destination = NULL;
-                    // to break both inner while loops, to get to the next destination entry of the lost neighbour
-                    done = true;
-                    break;
-
-                // the current destination is worse than the lost one
-                } else {
-                    // if new_best_destination entry is null just assign current destination entry
-                    // since it is the best seen yet
-                    if (new_best_destination == NULL) {
-                        new_best_destination = destination_entry;
-                    } else {
-                        // if new_best_destination exists, check whether the pheromone value of the current is better
-                        // if so save the entry, since it is the best (after the lost path)
-                        if (new_best_destination->pheromone_value > destination_entry->pheromone_value) {
-                            new_best_destination = destination_entry;
-                        }
-                    }
-                }
-
-                destination_entry = destination_entry->next;
-            }
-            // break out of the loop of the pheromone table
-            // because a path with a better prheromone value was found, so no the best path was lost and thus must not be
-            // included in the notification
-            if (done) {
-                break;
-            }
-            table = table->next;
-        }
-
-        // if done, a better neighbour path was found, thus this entry doesn't need to be included in the notification
-        // coninue with the next destinatino entry
-        if (done) {
-            destinations_of_neighbours = destinations_of_neighbours->next;
-            continue;
-        }
-
-        (*length_of_notification_list)++;
-
-        link_failure_notification_entry_t *new_list = (link_failure_notification_entry_t *) realloc(list_destinations_of_lost_neighbour, *length_of_notification_list * sizeof(link_failure_notification_entry_t));
-        if (new_list != NULL) {
-            list_destinations_of_lost_neighbour = new_list;
+    // the list can't be longer than the number of destinations of the lost neighbour
+    int number_of_destinations = 0;
+    destination_info_t *destination_entry;
+    for (destination_entry = table->destination_entry; destination_entry != NULL; destination_entry = destination_entry->next) {
+        ++number_of_destinations;
+    }
+    if (number_of_destinations == 0) {
+        return NULL;
+    }
 
-            link_failure_notification_entry_t new_entry;
-            if (new_best_destination != NULL) {
-                // if not null a best path (after the lost one) was found, so save its parameters
-                // memcpy in order to free the neighour and destination
+    link_failure_notification_entry_t *list_destinations_of_lost_neighbour = malloc(number_of_destinations * sizeof(link_failure_notification_entry_t));
+    if (list_destinations_of_lost_neighbour == NULL) {
+        LOG_ERR("Memory allocation for link failure notification failed!\n");
+        return NULL;
+    }
 
-                //new_entry.number_of_hops_to_new_best_destination = new_best_destination->hops;
-                memcpy(&new_entry.number_of_hops_to_new_best_destination, &new_best_destination->hops, sizeof(new_best_destination->hops));
-                //new_entry.time_estimate_T_P_of_new_best_destination = new_best_destination->pheromone_value;
-                memcpy(&new_entry.time_estimate_T_P_of_new_best_destination, &new_best_destination->pheromone_value, sizeof(new_best_destination->pheromone_value));
-                //new_entry.uip_address_of_destination = new_best_destination->destination;
-                memcpy(&new_entry.uip_address_of_destination, &new_best_destination->destination, sizeof(new_best_destination->destination));
-            } else {
-                // if this is reached, no best path (after the lost one) was found, and no better path exists
-                new_entry.number_of_hops_to_new_best_destination = 0;
-                new_entry.time_estimate_T_P_of_new_best_destination = (float)-100.0;
-                //new_entry.uip_address_of_destination = destinations_of_neighbours->destination;
-                memcpy(&new_entry.uip_address_of_destination, &destinations_of_neighbours->destination, sizeof(destinations_of_neighbours->destination));
-            }
-            //list_destinations_of_lost_neighbour[*length_of_notification_list - 1] = new_entry;
-            memcpy(&list_destinations_of_lost_neighbour[*length_of_notification_list - 1], &new_entry, sizeof(link_failure_notification_entry_t));
+    for (destination_entry = table->destination_entry; destination_entry != NULL; destination_entry = destination_entry->next) {
+        if (fill_link_failure_notification_entry(destination_entry, &list_destinations_of_lost_neighbour[*length_of_notification_list])) {
+            ++(*length_of_notification_list);
         }
-        destinations_of_neighbours = destinations_of_neighbours->next;
     }
 
     if (*length_of_notification_list == 0) {
-        if (list_destinations_of_lost_neighbour != NULL) {
-            free(list_destinations_of_lost_neighbour);
-            list_destinations_of_lost_neighbour = NULL;
-        }
+        free(list_destinations_of_lost_neighbour);
         return NULL;
     }
     return list_destinations_of_lost_neighbour;
 }
 
-destination_info_t *get_destination_entry(uip_ipaddr_t neighbour_address, uip_ipaddr_t destination_address) {
-    pheromone_entry_t * head = get_pheromone_tabel_head();
-    pheromone_entry_t * table = head;
-
-    // find destination enty
-    while(table != NULL) {
-        if (uip_ipaddr_cmp(&neighbour_address, &table->neighbour)) {
-            destination_info_t *dest_entry = table->destination_entry;
-            // find destination
-            while(dest_entry != NULL) {
-                if (uip_ipaddr_cmp(&destination_address, &dest_entry->destination)) {
-                    return dest_entry;
-                }
-                dest_entry = dest_entry->next;
-            }
-            // return NULL if no destination is found
-            return NULL;
-        }
-        table = table->next;
-    }
-    // return NULL if neighbour is not found
-    return NULL;
-}
-
 link_failure_notification_entry_t* create_one_link_failure_notification(uip_ipaddr_t destination, uip_ipaddr_t neighbour_address) {
-
-    pheromone_entry_t *head = get_pheromone_tabel_head();
-    pheromone_entry_t *table = head;
-
     destination_info_t *destination_of_neighbour = get_destination_entry(neighbour_address, destination);
     // if that destination does no exist, create no messagse
     if (destination_of_neighbour == NULL) {
         return NULL;
     }
 
-    // to safe the new best destination
-    destination_info_t *new_best_destination = NULL;
-
-    // to be able to break out of both loops when a better destination entry than of the lost neighbour is found
-    // also used to save if a better neighbour was found
-    // (the check on new_best_destiantion == NULL is not enough,
-    // since it's null, if no neighbour was found and if a better than the lost neighbour was found)
-    bool done = false;
-
-    // loop through pheromone table
-    while (table != NULL) {
-        // skip the entry of the neighbour
-        if (uip_ipaddr_cmp(&neighbour_address, &table->neighbour)) {
-            table = table->next;
-            continue;
-        }
-        destination_info_t *destination_entry = table->destination_entry;
-
-        // loop through all destination entries of the current neighbour
-        while (destination_entry != NULL) {
-            // continue if address of destination is not the same as the destination entry of the lost neighbour
-            if (!uip_ipaddr_cmp(&destination_entry->destination, &destination)) {
-                destination_entry = destination_entry->next;
-                continue;
-            }
-            /* check if pheromone value of current destination entry is smaller than that of the lost neighbour
-             * if smaller:      delete new_best_destination, since the destination of the lost neighbour is not the best
-             * if not smaller:  the destination of the lost neighbour might have the best path
-             *                  -> compare to new_best_destination, assign if better
-             */
-            // the current destination is better than the lost one
-            if (destination_entry->pheromone_value < destination_of_neighbour->pheromone_value) {
-                // the lost destination is not the best
-                // thus no entry must be created since there is a path to the destination
-                new_best_destination = NULL;
-                // to break both inner while loops, to get to the next destination entry of the lost neighbour
-                done = true;
-                break;
-
-            // the current destination is worse than the lost one
-            } else {
-                // if new_best_destination entry is null just assign current destination entry
-                // since it is the best seen yet
-                if (new_best_destination == NULL) {
-                    new_best_destination = destination_entry;
-                } else {
-                    // if new_best_destination exists, check whether the pheromone value of the current is better
-                    // if so save the entry, since it is the best (after the lost path)
-                    if (new_best_destination->pheromone_value > destination_entry->pheromone_value) {
-                        new_best_destination = destination_entry;
-                    }
-                }
-            }
-
-            destination_entry = destination_entry->next;
-        }
-        // break out of the loop of the pheromone table
-        // because a path with a better prheromone value was found, so no the best path was lost and thus must not be
-        // included in the notification
-        if (done) {
-            break;
-        }
-        table = table->next;
-    }
-
-    // if done, a better neighbour path was found, thus this entry doesn't need to be included in the notification
-    // coninue with the next destinatino entry
-    if (done) {
-        return NULL;
-    }
-
     link_failure_notification_entry_t *new_entry = malloc(sizeof(link_failure_notification_entry_t));
-    if (new_entry != NULL) {
-
-        if (new_best_destination != NULL) {
-            // if not null a best path (after the lost one) was found, so save its parameters
-            // memcpy in order to free the neighour and destination
-
-            new_entry->number_of_hops_to_new_best_destination = new_best_destination->hops;
-            //memcpy(&new_entry->number_of_hops_to_new_best_destination, &new_best_destination->hops, sizeof(new_best_destination->hops));
-            new_entry->time_estimate_T_P_of_new_best_destination = new_best_destination->pheromone_value;
-            //memcpy(&new_entry->time_estimate_T_P_of_new_best_destination, &new_best_destination->pheromone_value, sizeof(new_best_destination->pheromone_value));
-            new_entry->uip_address_of_destination = new_best_destination->destination;
-            //memcpy(&new_entry->uip_address_of_destination, &new_best_destination->destination, sizeof(new_best_destination->destination));
-        } else {
-            // if this is reached, no best path (after the lost one) was found, and no better path exists
-            new_entry->number_of_hops_to_new_best_destination = 0;
-            new_entry->time_estimate_T_P_of_new_best_destination = (float)-100.0;
-            new_entry->uip_address_of_destination = destination_of_neighbour->destination;
-            //memcpy(&new_entry->uip_address_of_destination, &destination_of_neighbour->destination, sizeof(destination_of_neighbour->destination));
-        }
+    if (new_entry != NULL && !fill_link_failure_notification_entry(destination_of_neighbour, new_entry)) {
+        // a better path exists, thus this entry doesn't need to be included in the notification
+        free(new_entry);
+        new_entry = NULL;
     }
     return new_entry;
 }
 
 link_failure_notification_entry_t * update_pheromone_after_link_failure(link_failure_notification_t link_failure_notification, int *length_of_notification_list) {
     LOG_DBG("Update pheromone after link failure.\n");
-    float *pheromone_value = NULL;
+    destination_info_t *destination_entry = NULL;
 
     *length_of_notification_list = 0;
     link_failure_notification_entry_t * list_destinations_of_lost_neighbour = (link_failure_notification_entry_t *)malloc(*length_of_notification_list * sizeof (link_failure_notification_entry_t));
 
     for (int i = 0; i < link_failure_notification.size_of_list_of_destinations; i++) {
 
-        if (link_failure_notification.entries[i].number_of_hops_to_new_best_destination == 0 && link_failure_notification.entries[i].time_estimate_T_P_of_new_best_destination == (float)-100.0) {
+        if (link_failure_notification.entries[i].number_of_hops_to_new_best_destination == 0 && link_failure_notification.entries[i].time_estimate_T_P_of_new_best_destination == REAL_CONST(-100.0)) {
 
             link_failure_notification_entry_t *new_entry = create_one_link_failure_notification(link_failure_notification.entries[i].uip_address_of_destination, link_failure_notification.source);
 
@@ -785,17 +858,14 @@ link_failure_notification_entry_t * update_pheromone_after_link_failure(link_fai
             // thus this node has to remove the destination over this link
             delete_destination_from_pheromone_table(link_failure_notification.entries[i].uip_address_of_destination, link_failure_notification.source);
         } else {
-            pheromone_value = get_pheromone_value(link_failure_notification.source, link_failure_notification.entries[i].uip_address_of_destination);
+            destination_entry = get_destination_entry(link_failure_notification.source, link_failure_notification.entries[i].uip_address_of_destination);
 
-            if (pheromone_value != NULL) {
+            if (destination_entry != NULL) {
                 // if null, that the enrty doesnt exists
-                double tau_i_d = 1 / ((link_failure_notification.entries[i].time_estimate_T_P_of_new_best_destination + (float)link_failure_notification.entries[i].number_of_hops_to_new_best_destination * ANT_HOC_NET_T_HOP) / 2);
-                *pheromone_value = ANT_HOC_NET_GAMMA * (*pheromone_value) + (1 - ANT_HOC_NET_GAMMA) * tau_i_d;
-            }
-
-            hop_t *hops = get_hops(link_failure_notification.source, link_failure_notification.entries[i].uip_address_of_destination);
-            if (hops != NULL) {
-                *hops = link_failure_notification.entries[i].number_of_hops_to_new_best_destination;
+                pheromone_t tau_i_d = calc_tau_i_d(link_failure_notification.entries[i].time_estimate_T_P_of_new_best_destination, link_failure_notification.entries[i].number_of_hops_to_new_best_destination);
+                destination_entry->pheromone_value = calc_new_pheromone_value(destination_entry->pheromone_value, tau_i_d);
+                destination_entry->hops = link_failure_notification.entries[i].number_of_hops_to_new_best_destination;
+                candidate_changed(destination_entry);
             }
         }
     }
@@ -804,3 +874,5 @@ link_failure_notification_entry_t * update_pheromone_after_link_failure(link_fai
     }
     return list_destinations_of_lost_neighbour;
 }
+
+#endif /* !ANT_HOC_NET_FLAT_PHEROMONE_TABLE */
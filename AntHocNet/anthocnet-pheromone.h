@@ -7,15 +7,65 @@
 
 #include "../../contiki-ng/os/net/ipv6/uip.h"
 #include "anthocnet-types.h"
+#include "anthocnet-conf.h"
 
+/* index of the cached probability distributions, one per beta of equation (1) */
+#define PHEROMONE_DISTRIBUTION_FORWARD      0   // ANT_HOC_NET_BETA_FORWARD, used for ants
+#define PHEROMONE_DISTRIBUTION_STOCHASTIC   1   // ANT_HOC_NET_BETA_STOCHASTIC, used for data packets
+#define PHEROMONE_DISTRIBUTIONS             2
+
+/* destination of the pheromone table, only used as the iterator of next_best_path() */
+typedef struct pheromone_destination pheromone_destination_t;
+
+/* size of a buffer that can hold every neighbour get_neighbours_to_send_to_destination() may accept */
+#define PHEROMONE_MAX_ACCEPTED_NEIGHBOURS   ANT_HOC_NET_MAX_NEIGHBOURS
+
+/* longest time in ticks between two hellos of a neighbour, until its first hello tells it */
+#define PHEROMONE_DEFAULT_HELLO_INTERVAL    ((clock_time_t)(ANT_HOC_NET_T_HELLO_SEC * CLOCK_SECOND))
+
+#if ANT_HOC_NET_FLAT_PHEROMONE_TABLE
 /**
- * Defines the destination containing the uIP address and pheromone entry, among other things.
+ * Defines one cell of the neighbour x destination matrix of the flat pheromone table, i.e. the pheromone value and
+ * the hops to a destination via one neighbour.
  */
 typedef struct destination_information {
-    struct destination_information *next;   // next destination entry
-    uip_ipaddr_t destination;               // ip address of the destination
-    float pheromone_value;                  // pheromone_value
+    pheromone_t pheromone_value;            // pheromone_value
     hop_t hops;                             // number of hops to that destination
+    bool valid;                             // whether a path to the destination via the neighbour is known
+    uint8_t next_candidate;                 // row of the next neighbour that knows a path to the destination
+    probability_t cumulative_probability[PHEROMONE_DISTRIBUTIONS];  // cached P_nd summed up along the candidates
+} destination_info_t;
+
+/**
+ * Defines a neighbour of the flat pheromone table T^i. The entries are taken from a memb pool, the position in the
+ * pool is the row of the neighbour in the neighbour x destination matrix.
+ */
+typedef struct pheromone_entry {
+    struct pheromone_entry *next;           // next pheromone entry (list of used pool entries)
+    node_id_t neighbour;                    // node id of the next hop neighbour
+    clock_time_t last_heard;                // when the last hello message, or other sign of life, was received
+    clock_time_t hello_interval;            // the longest time in ticks between two hellos of the neighbour
+    uint8_t hello_loss_counter;             // counts the number of lost hellos
+    clock_time_t last_reached;              // when the neighbour acknowledged the last frame of this node
+} pheromone_entry_t;
+#else
+struct pheromone_entry;
+struct destination_index;
+
+/**
+ * Defines the destination containing the uIP address and pheromone entry, among other things.\n
+ * Besides the list of destinations of one neighbour, every entry is also linked into the list of entries of the
+ * same destination (over all neighbours), which is the destination-major index used for the next hop selection.
+ */
+typedef struct destination_information {
+    struct destination_information *next;               // next destination entry
+    node_id_t destination;                              // node id of the destination
+    pheromone_t pheromone_value;                        // pheromone_value
+    hop_t hops;                                         // number of hops to that destination
+    struct destination_information *next_candidate;     // next entry of the same destination via another neighbour
+    struct pheromone_entry *neighbour_entry;            // the neighbour this entry belongs to
+    struct destination_index *index;                    // the index entry of the destination
+    probability_t cumulative_probability[PHEROMONE_DISTRIBUTIONS];  // cached P_nd summed up along the candidates
 } destination_info_t;
 
 /**
@@ -25,21 +75,14 @@ typedef struct destination_information {
  */
 typedef struct pheromone_entry {
     struct pheromone_entry *next;           // next pheromone entry
-    uip_ipaddr_t neighbour;                 // the next hop neighbour
+    node_id_t neighbour;                    // node id of the next hop neighbour
     destination_info_t *destination_entry;  // destination information about this neighbour
-    struct ctimer hello_timer;              // timer to handle the reception of hello messages
+    clock_time_t last_heard;                // when the last hello message, or other sign of life, was received
+    clock_time_t hello_interval;            // the longest time in ticks between two hellos of the neighbour
     uint8_t hello_loss_counter;             // counts the number of lost hellos
+    clock_time_t last_reached;              // when the neighbour acknowledged the last frame of this node
 } pheromone_entry_t;
-
-/**
- * To safe the pheromone values and neighbours for the calculation of P_nd.
- */
-typedef struct pnd_neighbours {
-    struct pnd_neighbours *next;                // next pnd_neighbour entry
-    uip_ipaddr_t neighbour;                     // neighbour address
-    float pheromone_entry_to_the_destination;   // pheromone value of that neighbour
-    uint8_t length;                             // length of te pnd_neighbour list
-} pnd_neighbours_t;
+#endif /* ANT_HOC_NET_FLAT_PHEROMONE_TABLE */
 
 /**
  * Initializes the pheromone table.
@@ -57,6 +100,12 @@ void delete_pheromone_table();
  */
 bool neighbours_exists();
 
+/**
+ * Returns the number of neighbours in the pheromone table.
+ * @return The number of neighbours
+ */
+int number_of_neighbours();
+
 /**
  * Checks whether a neighbour with the give uIP address exists.
  * @param neighbour_addr The uIP address of the neighbour
@@ -70,13 +119,18 @@ bool does_neighbour_exists(uip_ipaddr_t neighbour_addr);
 void print_pheromone_table();
 
 /**
- * Picks neighbour to which packages is sent.
+ * Picks neighbour to which packages is sent.\n
+ * The cumulative distribution of P_nd over the candidates of a destination is cached per beta, and only recalculated
+ * after a pheromone value to that destination changed. The accepted neighbours are written into a buffer of the caller,
+ * the first one is the selected next hop, the following ones are the alternatives; nothing is allocated.
  * @param destination The destination to which packages should be sent to
  * @param forward_ant Whether the calculation is for ant or for data packages
- * @param accepted_neighbour_size Pointer to store the size of the resulting array in
- * @return Pointer to a list of neighbours, or NULL if there are no neighbours
+ * @param accepted_neighbours Buffer the accepted neighbours are written into
+ * @param max_accepted_neighbours Size of the buffer; if more neighbours are accepted, the last ones are left out
+ * @return Number of neighbours written into the buffer, 0 if there are no neighbours
  */
-uip_ipaddr_t* get_neighbours_to_send_to_destination(uip_ipaddr_t destination, bool forward_ant, int* accepted_neighbour_size);
+int get_neighbours_to_send_to_destination(uip_ipaddr_t destination, bool forward_ant, uip_ipaddr_t *accepted_neighbours,
+                                          int max_accepted_neighbours);
 
 /**
  * Return the pheromone value of the route via the neighbour to the destination.
@@ -84,7 +138,7 @@ uip_ipaddr_t* get_neighbours_to_send_to_destination(uip_ipaddr_t destination, bo
  * \param destination The destination to which the pheromone value is searched for
  * \return Pointer to the pheromone value, NULL if the neighbour or destination is not found
  */
-float* get_pheromone_value(uip_ipaddr_t neighbour, uip_ipaddr_t destination);
+pheromone_t* get_pheromone_value(uip_ipaddr_t neighbour, uip_ipaddr_t destination);
 
 /**
  * Updates the pheromone table entry T_i_nd. Corresponds to equation (5) and (6) of the AntHocNet paper.
@@ -97,7 +151,7 @@ void create_or_update_pheromone_table(struct reactive_backward_ant ant);
  * @param neighbour_address uIP address of the neighbour
  * @param pheromone_value the time estimate of the neighbour according to equation (3) of the paper
  */
-void add_neighbour_to_pheromone_table(uip_ipaddr_t neighbour_address,float pheromone_value);
+void add_neighbour_to_pheromone_table(uip_ipaddr_t neighbour_address, pheromone_t pheromone_value);
 
 /**
  * Removes neighbour (and all of its destination entries) form the routing table.
@@ -106,12 +160,78 @@ void add_neighbour_to_pheromone_table(uip_ipaddr_t neighbour_address,float phero
 void delete_neighbour_from_pheromone_table(uip_ipaddr_t neighbour_address);
 
 /**
- * Resets the timer of the given neighbour
+ * Iterates over the neighbours of the pheromone table.
+ * @param entry The last neighbour returned, NULL for the first one
+ * @return The next neighbour, NULL if there is none
+ */
+pheromone_entry_t *next_neighbour_entry(pheromone_entry_t *entry);
+
+/**
+ * Returns the number of destinations of the pheromone table.
+ * @return The number of destinations
+ */
+int number_of_destinations();
+
+/**
+ * Iterates over the destinations of the pheromone table and returns the best path to each, i.e. the path over the
+ * neighbour with the largest pheromone value.
+ * @param iterator The destination returned by the last call, NULL for the first one
+ * @param destination Is set to the uIP address of the destination
+ * @param pheromone_value Is set to the pheromone value of the best path
+ * @param hops Is set to the number of hops of the best path
+ * @return The destination, to be passed to the next call; NULL if there is none left
+ */
+const pheromone_destination_t *next_best_path(const pheromone_destination_t *iterator, uip_ipaddr_t *destination,
+                                              pheromone_t *pheromone_value, hop_t *hops);
+
+/**
+ * Returns the best path to a destination, i.e. the path over the neighbour with the largest pheromone value, and how
+ * fresh the paths to the destination are.
+ * @param destination The uIP address of the destination
+ * @param neighbour Is set to the uIP address of the neighbour of the best path
+ * @param pheromone_value Is set to the pheromone value of the best path
+ * @param hops Is set to the number of hops of the best path
+ * @param last_ant Is set to the time a backward ant updated a path to the destination the last time, or the
+ * destination was added
+ * @return False if no neighbour leads to the destination
+ */
+bool get_best_path(uip_ipaddr_t destination, uip_ipaddr_t *neighbour, pheromone_t *pheromone_value, hop_t *hops,
+                   clock_time_t *last_ant);
+
+/**
+ * Returns the sum of the pheromone values of all neighbours to a destination. Unlike
+ * get_neighbours_to_send_to_destination() it doesn't draw random numbers, so it only changes with the table.
+ * @param destination The uIP address of the destination
+ * @return The sum of the pheromone values, 0 if no neighbour leads to the destination
+ */
+pheromone_t get_pheromone_sum_to_destination(uip_ipaddr_t destination);
+
+/**
+ * Resets the hello loss of the given neighbour, i.e. it was heard of now.
  * @param neighbour_address The uip address of the neighbour to reset the timer
  * @return 1 if the timer was reset, 0 if no neighbour was found
  */
 int reset_hello_loss_timer(uip_ipaddr_t neighbour_address);
 
+/**
+ * Sets the hello interval of a neighbour to the interval its hello messages advertise, and resets its hello loss.
+ * @param neighbour_address The uIP address of the neighbour
+ * @param interval The longest time in ticks until the next hello of the neighbour
+ */
+void set_hello_interval(uip_ipaddr_t neighbour_address, clock_time_t interval);
+
+/**
+ * Marks a neighbour as reached by this node now, i.e. it acknowledged a unicast frame.
+ * @param neighbour_address The uIP address of the neighbour
+ */
+void set_neighbour_reached(uip_ipaddr_t neighbour_address);
+
+/**
+ * Returns the longest time since a neighbour acknowledged a frame of this node.
+ * @return The time in ticks, 0 if there are no neighbours
+ */
+clock_time_t longest_time_since_neighbour_reached();
+
 /**
  * Removes the path to destination d over neighbour n, more precise, it removes the destination entry d corresponding
  * to the given neighbour n, from the pheromone table.
@@ -0,0 +1,167 @@
+/**
+ * \file
+ *      Implements the scheduling of rebroadcasts.\n
+ *      The pending broadcasts are taken from a memb pool and hold a copy of their ICMPv6 payload; each one has a ctimer,
+ *      that fires after its jitter and sends it, unless enough copies of its flood were overheard.
+ */
+
+#include "anthocnet-rebroadcast.h"
+#include "anthocnet-icmpv6.h"
+#include "anthocnet-pheromone.h"
+#include "anthocnet-conf.h"
+#include "uip-icmp6.h"
+#include <stdbool.h>
+#include <string.h>
+#include "lib/memb.h"
+#include "lib/list.h"
+#include "lib/random.h"
+#include "sys/ctimer.h"
+
+// logging
+#include "sys/log.h"
+#define LOG_MODULE "AntHocNet-Rebroadcast"
+#ifdef LOG_CONF_LEVEL_ANTHOCNET_REBROADCAST
+#define LOG_LEVEL LOG_CONF_LEVEL_ANTHOCNET_REBROADCAST
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+
+#define REBROADCAST_MAX_JITTER ((clock_time_t)ANT_HOC_NET_REBROADCAST_JITTER_MS * CLOCK_SECOND / 1000)
+
+/**
+ * Structure for a broadcast that waits for its jitter.
+ */
+typedef struct pending_rebroadcast {
+    struct pending_rebroadcast *next;       // the next element in the list of used entries
+    struct ctimer timer;                    // fires after the jitter
+    uint32_t key;                           // key of the flood the message belongs to
+    uip_ipaddr_t destination;               // multicast address the message is sent to
+    uint8_t type;                           // ICMPv6 type of the message
+    uint8_t code;                           // ICMPv6 code of the message
+    uint8_t copies;                         // number of copies of the flood received, including the own one
+    time_estimate_t time_estimate;          // time estimate of the message, a message with a larger one doesn't replace it
+    bool suppressible;                      // whether the broadcast is cancelled after enough copies
+    uint16_t len;                           // length of the payload
+    uint8_t payload[ANT_HOC_NET_PENDING_REBROADCAST_LEN];   // the ICMPv6 payload of the message
+} pending_rebroadcast_t;
+
+MEMB(pending_rebroadcasts_memb, pending_rebroadcast_t, ANT_HOC_NET_MAX_PENDING_REBROADCASTS);
+LIST(pending_rebroadcasts_list);
+
+static pending_rebroadcast_t *find_pending_rebroadcast(uint32_t key) {
+    for (pending_rebroadcast_t *entry = list_head(pending_rebroadcasts_list); entry != NULL; entry = list_item_next(entry)) {
+        if (entry->key == key) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void free_pending_rebroadcast(pending_rebroadcast_t *entry) {
+    ctimer_stop(&entry->timer);
+    list_remove(pending_rebroadcasts_list, entry);
+    memb_free(&pending_rebroadcasts_memb, entry);
+}
+
+static void rebroadcast_callback_function(void *ptr) {
+    pending_rebroadcast_t *entry = (pending_rebroadcast_t *) ptr;
+    if (entry->suppressible && ANT_HOC_NET_REBROADCAST_COUNTER_THRESHOLD > 0
+        && entry->copies >= ANT_HOC_NET_REBROADCAST_COUNTER_THRESHOLD) {
+        LOG_DBG("%u copies overheard - rebroadcast is cancelled\n", entry->copies);
+    } else if (uip_len > 0) {
+        // the message would overwrite a packet in uip_buf, it is sent with the next tick
+        ctimer_set(&entry->timer, 1, rebroadcast_callback_function, entry);
+        return;
+    } else {
+        LOG_DBG("Rebroadcast of message with type %u\n", entry->type);
+        memcpy(ICMP6_ANT_PAYLOAD, entry->payload, entry->len);
+        uip_icmp6_send(&entry->destination, entry->type, entry->code, entry->len);
+    }
+    list_remove(pending_rebroadcasts_list, entry);
+    memb_free(&pending_rebroadcasts_memb, entry);
+}
+
+/**
+ * Decides with the probability ANT_HOC_NET_REBROADCAST_NEIGHBOURS / number of neighbours whether a relayed ant is
+ * broadcast; always, if the node has at most ANT_HOC_NET_REBROADCAST_NEIGHBOURS neighbours.
+ */
+static bool rebroadcast_by_neighbour_count() {
+#if ANT_HOC_NET_REBROADCAST_NEIGHBOURS > 0
+    int neighbours = number_of_neighbours();
+    return neighbours <= ANT_HOC_NET_REBROADCAST_NEIGHBOURS
+           || random_rand() % neighbours < ANT_HOC_NET_REBROADCAST_NEIGHBOURS;
+#else
+    return true;
+#endif
+}
+
+void rebroadcast_init() {
+    memb_init(&pending_rebroadcasts_memb);
+    list_init(pending_rebroadcasts_list);
+}
+
+uint32_t rebroadcast_key(uint8_t type, const uip_ipaddr_t *address, uint16_t number) {
+    // FNV-1a
+    uint32_t hash = 2166136261UL;
+    hash = (hash ^ type) * 16777619UL;
+    for (uint8_t i = 0; i < sizeof(uip_ipaddr_t); ++i) {
+        hash = (hash ^ address->u8[i]) * 16777619UL;
+    }
+    hash = (hash ^ (number >> 8)) * 16777619UL;
+    hash = (hash ^ (number & 0xFF)) * 16777619UL;
+    return hash;
+}
+
+void schedule_rebroadcast(const uip_ipaddr_t *destination, uint8_t type, uint8_t code, uint16_t len, uint32_t key,
+                          time_estimate_t time_estimate, bool suppressible) {
+    if (suppressible && !rebroadcast_by_neighbour_count()) {
+        LOG_DBG("Rebroadcast is skipped because of the number of neighbours\n");
+        return;
+    }
+
+    pending_rebroadcast_t *entry = find_pending_rebroadcast(key);
+    if (entry != NULL && time_estimate > entry->time_estimate) {
+        LOG_DBG("Pending rebroadcast of the flood has a better time estimate - message is dropped\n");
+        return;
+    }
+    if (entry == NULL && REBROADCAST_MAX_JITTER > 0 && len <= ANT_HOC_NET_PENDING_REBROADCAST_LEN) {
+        entry = memb_alloc(&pending_rebroadcasts_memb);
+        if (entry != NULL) {
+            entry->key = key;
+            entry->copies = 1;
+            list_add(pending_rebroadcasts_list, entry);
+            ctimer_set(&entry->timer, random_rand() % (REBROADCAST_MAX_JITTER + 1), rebroadcast_callback_function, entry);
+        }
+    } else if (entry != NULL && len > ANT_HOC_NET_PENDING_REBROADCAST_LEN) {
+        // the newer message of the flood is sent at once, the pending one is outdated
+        free_pending_rebroadcast(entry);
+        entry = NULL;
+    }
+
+    if (entry == NULL) {
+        uip_icmp6_send(destination, type, code, len);
+        return;
+    }
+
+    // a pending broadcast of the flood keeps its timer and counter, only the message is replaced
+    entry->destination = *destination;
+    entry->type = type;
+    entry->code = code;
+    entry->suppressible = suppressible;
+    entry->time_estimate = time_estimate;
+    entry->len = len;
+    memcpy(entry->payload, ICMP6_ANT_PAYLOAD, len);
+}
+
+void rebroadcast_overheard(uint32_t key) {
+    pending_rebroadcast_t *entry = find_pending_rebroadcast(key);
+    if (entry != NULL && entry->copies < 0xFF) {
+        ++entry->copies;
+    }
+}
+
+void delete_pending_rebroadcasts() {
+    while (list_head(pending_rebroadcasts_list) != NULL) {
+        free_pending_rebroadcast(list_head(pending_rebroadcasts_list));
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * \file
+ *      Declarations of the functions for the scheduling of rebroadcasts.\n
+ *      Broadcasts that are relayed, as forward ants without pheromone and link failure notifications, are delayed by a
+ *      random jitter, so that the neighbours that received the same broadcast don't send at the same time. A relayed
+ *      ant is cancelled if ANT_HOC_NET_REBROADCAST_COUNTER_THRESHOLD copies of it were overheard until then, the
+ *      neighbourhood is covered in that case; with ANT_HOC_NET_REBROADCAST_NEIGHBOURS it is in addition only relayed
+ *      with a probability that falls with the number of neighbours.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_REBROADCAST_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_REBROADCAST_H
+
+#include "../../contiki-ng/os/net/ipv6/uip.h"
+#include "anthocnet-types.h"
+
+/**
+ * Initializes the scheduling of the rebroadcasts; all pending broadcasts are dropped without stopping their timers.
+ */
+void rebroadcast_init();
+
+/**
+ * Returns the key of a flood, e.g. the source and generation of an ant, or the sender and number of a link failure
+ * notification.
+ * @param type The ICMPv6 type of the messages
+ * @param address The address that identifies the flood
+ * @param number The number that identifies the flood, e.g. the generation
+ * @return The key
+ */
+uint32_t rebroadcast_key(uint8_t type, const uip_ipaddr_t *address, uint16_t number);
+
+/**
+ * Broadcasts the message in the ICMPv6 payload of uip_buf after a random jitter of at most
+ * ANT_HOC_NET_REBROADCAST_JITTER_MS. A pending broadcast of the same flood is replaced by the message, unless the
+ * pending one has the smaller time estimate, e.g. a reactive forward ant accepted with a1 is not replaced by a later
+ * one accepted with a2. The message is broadcast at once if it doesn't fit into a pending broadcast, or if no pending
+ * broadcast is left.
+ * @param destination The multicast address the message is sent to
+ * @param type The ICMPv6 type of the message
+ * @param code The ICMPv6 code of the message
+ * @param len The length of the ICMPv6 payload
+ * @param key The key of the flood the message belongs to
+ * @param time_estimate The time estimate of the message, 0 for messages without one
+ * @param suppressible Whether the broadcast is cancelled when enough copies are overheard; for relayed ants
+ */
+void schedule_rebroadcast(const uip_ipaddr_t *destination, uint8_t type, uint8_t code, uint16_t len, uint32_t key,
+                          time_estimate_t time_estimate, bool suppressible);
+
+/**
+ * Counts an overheard copy of a flood, that may cancel the pending broadcast of that flood.
+ * @param key The key of the flood
+ */
+void rebroadcast_overheard(uint32_t key);
+
+/**
+ * Stops and drops all pending broadcasts.
+ */
+void delete_pending_rebroadcasts();
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_REBROADCAST_H
@@ -0,0 +1,203 @@
+/**
+ * \file
+ *      Implements the reroute contexts of the data packets in flight.\n
+ *      The contexts are taken from a memb pool and hold the destination, the next hop and the MAC sequence number of
+ *      the frame of a packet, but no copy of the packet.
+ */
+
+#include "anthocnet-reroute.h"
+#include "anthocnet-pheromone.h"
+#include "anthocnet-conf.h"
+#include "uip-ds6.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/sicslowpan.h"
+#include <string.h>
+#include "lib/memb.h"
+#include "lib/list.h"
+
+// logging
+#include "sys/log.h"
+#define LOG_MODULE "AntHocNet-Reroute"
+#ifdef LOG_CONF_LEVEL_ANTHOCNET_REROUTE
+#define LOG_LEVEL LOG_CONF_LEVEL_ANTHOCNET_REROUTE
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+
+#define REROUTE_CONTEXT_TIMEOUT ((clock_time_t)(ANT_HOC_NET_REROUTE_CONTEXT_TIMEOUT_SEC * CLOCK_SECOND))
+
+/**
+ * Structure for the context of a data packet in flight.
+ */
+typedef struct reroute_context {
+    struct reroute_context *next;       // the next element in the list of used entries
+    uip_ipaddr_t destination;           // uIP address of the destination of the packet
+    uip_ipaddr_t next_hop;              // uIP address of the neighbour the frame is sent to
+    uint8_t seqno;                      // MAC sequence number of the frame
+    clock_time_t created;               // time the packet was routed, or the frame was rerouted
+    bool reroutable;                    // whether the frame can be sent to another neighbour
+    bool rerouted;                      // whether the frame was sent to another neighbour already
+} reroute_context_t;
+
+MEMB(reroute_contexts_memb, reroute_context_t, ANT_HOC_NET_MAX_REROUTE_CONTEXTS);
+LIST(reroute_contexts_list);
+
+// the context of the routed packet, whose frame isn't attached yet
+static reroute_context_t *unattached_context;
+
+static void free_reroute_context(reroute_context_t *context) {
+    if (context == unattached_context) {
+        unattached_context = NULL;
+    }
+    list_remove(reroute_contexts_list, context);
+    memb_free(&reroute_contexts_memb, context);
+}
+
+/**
+ * The link layer address of a neighbour, its addresses are derived from it.
+ */
+static void link_address_of(const uip_ipaddr_t *address, linkaddr_t *lladdr) {
+    uip_ds6_set_lladdr_from_iid((uip_lladdr_t *) lladdr, address);
+}
+
+/**
+ * Drops the contexts whose frames were never reported by the MAC layer within REROUTE_CONTEXT_TIMEOUT.
+ */
+static void drop_expired_reroute_contexts() {
+    clock_time_t now = clock_time();
+    reroute_context_t *context = list_head(reroute_contexts_list);
+    while (context != NULL) {
+        reroute_context_t *next = list_item_next(context);
+        if (now - context->created > REROUTE_CONTEXT_TIMEOUT) {
+            LOG_DBG("Frame %u was not reported - its context is dropped\n", context->seqno);
+            free_reroute_context(context);
+        }
+        context = next;
+    }
+}
+
+/**
+ * Finds the context of a frame by its sequence number and its receiver, since the sequence numbers of the frames to
+ * all neighbours share 8 bits.
+ */
+static reroute_context_t *find_reroute_context(uint8_t seqno, const linkaddr_t *receiver) {
+    drop_expired_reroute_contexts();
+    for (reroute_context_t *context = list_head(reroute_contexts_list); context != NULL; context = list_item_next(context)) {
+        if (context != unattached_context && context->seqno == seqno) {
+            linkaddr_t lladdr;
+            link_address_of(&context->next_hop, &lladdr);
+            if (linkaddr_cmp(receiver, &lladdr)) {
+                return context;
+            }
+        }
+    }
+    return NULL;
+}
+
+void reroute_contexts_init() {
+    memb_init(&reroute_contexts_memb);
+    list_init(reroute_contexts_list);
+    unattached_context = NULL;
+}
+
+void add_reroute_context(const uip_ipaddr_t *destination, const uip_ipaddr_t *next_hop) {
+    // the last packet was dropped before its frame was queued
+    if (unattached_context != NULL) {
+        free_reroute_context(unattached_context);
+    }
+    drop_expired_reroute_contexts();
+
+    reroute_context_t *context = memb_alloc(&reroute_contexts_memb);
+    if (context == NULL) {
+        // the frame of the oldest packet can't be rerouted anymore, a failure of it isn't noticed
+        LOG_WARN("No reroute context left - the oldest one is dropped!\n");
+        context = list_pop(reroute_contexts_list);
+        if (context == NULL) {
+            return;
+        }
+    }
+    context->destination = *destination;
+    context->next_hop = *next_hop;
+    context->seqno = 0;
+    context->created = clock_time();
+    context->reroutable = false;
+    context->rerouted = false;
+    list_add(reroute_contexts_list, context);
+    unattached_context = context;
+}
+
+void attach_frame_to_reroute_context() {
+    reroute_context_t *context = unattached_context;
+    if (context == NULL) {
+        return;
+    }
+    unattached_context = NULL;
+
+    linkaddr_t lladdr;
+    link_address_of(&context->next_hop, &lladdr);
+    if (!linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &lladdr)) {
+        // the frame doesn't carry the packet, e.g. the packet was dropped and an ant is sent
+        LOG_DBG("Frame is not sent to the next hop of the routed packet\n");
+        free_reroute_context(context);
+        return;
+    }
+    context->seqno = packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO);
+
+    // a rerouted frame keeps the header compression of its first next hop
+    if (!context->rerouted) {
+        // the fragments of a packet can't take different neighbours; and if the destination is the next hop,
+        // 6LoWPAN may have elided its address, since it can be derived from the link layer address
+        uint8_t dispatch = ((uint8_t *) packetbuf_dataptr())[0] & 0xF8;
+        context->reroutable = dispatch != SICSLOWPAN_DISPATCH_FRAG1 && dispatch != SICSLOWPAN_DISPATCH_FRAGN
+                              && memcmp(&context->destination.u8[8], &context->next_hop.u8[8], 8) != 0;
+    }
+}
+
+bool reroute_frame() {
+    reroute_context_t *context = find_reroute_context(packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO),
+                                                      packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+    if (context == NULL || !context->reroutable || context->rerouted) {
+        return false;
+    }
+
+    // static, so that the buffer is not put on the stack of the MAC callback
+    static uip_ipaddr_t neighbours[PHEROMONE_MAX_ACCEPTED_NEIGHBOURS];
+    int neighbour_size = get_neighbours_to_send_to_destination(context->destination, false, neighbours,
+                                                               PHEROMONE_MAX_ACCEPTED_NEIGHBOURS);
+    for (int i = 0; i < neighbour_size; ++i) {
+        if (!uip_ipaddr_cmp(&neighbours[i], &context->next_hop)) {
+            LOG_DBG("New neighbour was found to send frame %u to destination\n", context->seqno);
+            linkaddr_t lladdr;
+            link_address_of(&neighbours[i], &lladdr);
+            packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &lladdr);
+            context->next_hop = neighbours[i];
+            context->created = clock_time();
+            context->rerouted = true;
+
+            // the frame gets a new sequence number when it is queued again
+            if (unattached_context != NULL) {
+                free_reroute_context(unattached_context);
+            }
+            unattached_context = context;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool take_reroute_context(uint8_t seqno, const linkaddr_t *receiver, uip_ipaddr_t *destination, uip_ipaddr_t *next_hop) {
+    reroute_context_t *context = find_reroute_context(seqno, receiver);
+    if (context == NULL) {
+        return false;
+    }
+    *destination = context->destination;
+    *next_hop = context->next_hop;
+    free_reroute_context(context);
+    return true;
+}
+
+void delete_reroute_contexts() {
+    while (list_head(reroute_contexts_list) != NULL) {
+        free_reroute_context(list_head(reroute_contexts_list));
+    }
+}
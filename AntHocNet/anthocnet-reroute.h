@@ -0,0 +1,59 @@
+/**
+ * \file
+ *      Declarations of the functions for the reroute contexts of the data packets in flight.\n
+ *      Each routed data packet gets a context with its destination and next hop, that is identified by the MAC
+ *      sequence number and the receiver of its frame; a context that isn't taken within
+ *      ANT_HOC_NET_REROUTE_CONTEXT_TIMEOUT_SEC is dropped, since the sequence number wraps around. If the frame fails, the MAC layer asks for another neighbour and queues the same
+ *      frame for it, so the packet isn't copied; the contexts of several packets to different next hops are kept at
+ *      the same time.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_REROUTE_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_REROUTE_H
+
+#include "../../contiki-ng/os/net/ipv6/uip.h"
+#include "net/linkaddr.h"
+#include <stdbool.h>
+
+/**
+ * Initializes the reroute contexts; all contexts are dropped.
+ */
+void reroute_contexts_init();
+
+/**
+ * Adds the context of the data packet that is routed. The frame of the packet is attached to it by
+ * attach_frame_to_reroute_context(); if no context is left, the oldest one is dropped.
+ * @param destination uIP address of the destination of the packet
+ * @param next_hop uIP address of the neighbour the packet is sent to
+ */
+void add_reroute_context(const uip_ipaddr_t *destination, const uip_ipaddr_t *next_hop);
+
+/**
+ * Attaches the frame in the packetbuf to the context of the last routed packet, if the frame is sent to its next hop.
+ * Is called by the MAC layer after the sequence number of a frame is set.
+ */
+void attach_frame_to_reroute_context();
+
+/**
+ * Selects another neighbour for the failed frame in the packetbuf and sets it as receiver of the frame. A frame is
+ * rerouted only once, and neither if it is a fragment nor if the destination is the failed next hop.
+ * Is called by the MAC layer, that queues the frame again if true is returned.
+ * @return True if the receiver of the frame was changed
+ */
+bool reroute_frame();
+
+/**
+ * Removes the context of a frame and returns its destination and next hop.
+ * @param seqno The MAC sequence number of the frame
+ * @param receiver The link layer address of the receiver of the frame
+ * @param destination Is set to the uIP address of the destination of the packet
+ * @param next_hop Is set to the uIP address of the neighbour the frame was sent to
+ * @return True if a context was found, false if the frame doesn't carry a routed data packet
+ */
+bool take_reroute_context(uint8_t seqno, const linkaddr_t *receiver, uip_ipaddr_t *destination, uip_ipaddr_t *next_hop);
+
+/**
+ * Drops all reroute contexts.
+ */
+void delete_reroute_contexts();
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_REROUTE_H
@@ -0,0 +1,114 @@
+/**
+ * \file
+ *      Implements the reverse routes of the forward ants, selected with ANT_HOC_NET_CONF_STATEFUL_REVERSE_ROUTES.\n
+ *      The entries are taken from a memb pool. Expired entries are dropped lazily, when the routes are searched; no
+ *      timer is needed.
+ */
+
+#include "anthocnet-reverse-routes.h"
+#include "anthocnet-node-id.h"
+#include "anthocnet-conf.h"
+#include <stdbool.h>
+#include "lib/memb.h"
+#include "lib/list.h"
+
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+
+// logging
+#include "sys/log.h"
+#define LOG_MODULE "AntHocNet-Reverse-Routes"
+#ifdef LOG_CONF_LEVEL_ANTHOCNET_REVERSE_ROUTES
+#define LOG_LEVEL LOG_CONF_LEVEL_ANTHOCNET_REVERSE_ROUTES
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+
+#define REVERSE_ROUTE_LIFETIME (ANT_HOC_NET_REVERSE_ROUTE_LIFETIME_SEC * CLOCK_SECOND)
+
+MEMB(reverse_routes_memb, reverse_route_t, ANT_HOC_NET_MAX_REVERSE_ROUTES);
+LIST(reverse_routes_list);
+
+/**
+ * Releases the node ids of an entry and returns it to the pool.
+ */
+static void free_reverse_route(reverse_route_t *route) {
+    node_id_release(route->source);
+    node_id_release(route->previous_hop);
+    list_remove(reverse_routes_list, route);
+    memb_free(&reverse_routes_memb, route);
+}
+
+/**
+ * Searches the route of a generation of a source and drops the expired routes on the way.
+ */
+static reverse_route_t *find_reverse_route(const uip_ipaddr_t *source, uint16_t generation, bool proactive) {
+    node_id_t node_id = node_id_lookup(source);
+    clock_time_t now = clock_time();
+    reverse_route_t *found = NULL;
+    reverse_route_t *route = list_head(reverse_routes_list);
+    while (route != NULL) {
+        reverse_route_t *next = list_item_next(route);
+        if ((clock_time_t)(now - route->created) > REVERSE_ROUTE_LIFETIME) {
+            free_reverse_route(route);
+        } else if (route->source == node_id && route->generation == generation && route->proactive == proactive) {
+            found = route;
+        }
+        route = next;
+    }
+    return found;
+}
+
+void reverse_routes_init() {
+    memb_init(&reverse_routes_memb);
+    list_init(reverse_routes_list);
+}
+
+bool add_reverse_route(const uip_ipaddr_t *source, uint16_t generation, bool proactive,
+                       const uip_ipaddr_t *previous_hop) {
+    if (find_reverse_route(source, generation, proactive) != NULL) {
+        return true;
+    }
+
+    node_id_t source_id = node_id_acquire(source);
+    if (source_id == NODE_ID_NONE) {
+        return false;
+    }
+    node_id_t previous_hop_id = node_id_acquire(previous_hop);
+    if (previous_hop_id == NODE_ID_NONE) {
+        node_id_release(source_id);
+        return false;
+    }
+
+    reverse_route_t *route = memb_alloc(&reverse_routes_memb);
+    if (route == NULL) {
+        // new routes are pushed to the head, the tail is the oldest one
+        LOG_DBG("Reverse routes full - drop the oldest route\n");
+        free_reverse_route(list_tail(reverse_routes_list));
+        route = memb_alloc(&reverse_routes_memb);
+    }
+
+    route->source = source_id;
+    route->generation = generation;
+    route->proactive = proactive;
+    route->previous_hop = previous_hop_id;
+    route->created = clock_time();
+    list_push(reverse_routes_list, route);
+    return true;
+}
+
+bool get_reverse_route(const uip_ipaddr_t *source, uint16_t generation, bool proactive, uip_ipaddr_t *previous_hop) {
+    reverse_route_t *route = find_reverse_route(source, generation, proactive);
+    if (route == NULL) {
+        return false;
+    }
+    uip_ipaddr_copy(previous_hop, node_id_address(route->previous_hop));
+    return true;
+}
+
+void delete_reverse_routes() {
+    while (list_head(reverse_routes_list) != NULL) {
+        free_reverse_route(list_head(reverse_routes_list));
+    }
+}
+
+#endif /* ANT_HOC_NET_STATEFUL_REVERSE_ROUTES */
@@ -0,0 +1,48 @@
+/**
+ * \file
+ *      Declarations of the functions for the reverse routes, used with ANT_HOC_NET_STATEFUL_REVERSE_ROUTES.\n
+ *      A node keeps, per source and generation, the node the first forward ant was received from; backward ants travel
+ *      back along these routes, thus the ants don't need to carry their path. The routes are soft state, they expire
+ *      after ANT_HOC_NET_REVERSE_ROUTE_LIFETIME_SEC.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_REVERSE_ROUTES_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_REVERSE_ROUTES_H
+
+#include "../../contiki-ng/os/net/ipv6/uip.h"
+#include "anthocnet-types.h"
+
+/**
+ * Initializes the reverse routes; all entries are dropped without releasing their node ids.
+ */
+void reverse_routes_init();
+
+/**
+ * Adds the reverse route of a forward ant, if the generation has no route yet. Reactive and proactive forward ants
+ * count their generations apart, so the kind of the ant is part of the key. Only the first ant of a generation sets
+ * the route; as it was received before the ants of that generation were forwarded, the routes can't form a loop.
+ * The oldest route is dropped if there are too many routes.
+ * @param source The uIP address of the source of the forward ant
+ * @param generation The generation of the forward ant
+ * @param proactive Whether the forward ant is a proactive forward ant
+ * @param previous_hop The uIP address of the node the forward ant was received from
+ * @return True if the route was added or exists already, false if no node id is left
+ */
+bool add_reverse_route(const uip_ipaddr_t *source, uint16_t generation, bool proactive,
+                       const uip_ipaddr_t *previous_hop);
+
+/**
+ * Looks up the reverse route of a generation of a source.
+ * @param source The uIP address of the source of the forward ant
+ * @param generation The generation of the forward ant
+ * @param proactive Whether the forward ant is a proactive forward ant
+ * @param previous_hop Set to the uIP address of the node the forward ant was received from
+ * @return True if a route exists and is not expired
+ */
+bool get_reverse_route(const uip_ipaddr_t *source, uint16_t generation, bool proactive, uip_ipaddr_t *previous_hop);
+
+/**
+ * Deletes the reverse routes of all sources.
+ */
+void delete_reverse_routes();
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_REVERSE_ROUTES_H
@@ -8,9 +8,39 @@
 #define IEEE_802_15_4_ANTNET_ANTHOCNET_TYPES_H
 
 #include "../../contiki-ng/os/net/ipv6/uip.h"
+#include "anthocnet-conf.h"
+#include "sys/etimer.h"
 
 typedef unsigned int hop_t;
 
+/**
+ * Types of the pheromone values, time estimates and probabilities; Q16.16 fixed-point numbers with
+ * ANT_HOC_NET_CONF_FIXED_POINT, see anthocnet-fixed-point.h for the arithmetic.
+ */
+#if ANT_HOC_NET_FIXED_POINT
+#define REAL_FRACTION_BITS  16
+typedef int32_t pheromone_t;            // pheromone value T^i_nd, Q16.16
+typedef int32_t time_estimate_t;        // time estimate in seconds, Q16.16
+typedef int32_t probability_t;          // probability P_nd (or a sum of them), Q16.16
+typedef uint64_t pheromone_weight_t;    // pheromone value to the power of beta, Q16.16
+#else
+typedef float pheromone_t;              // pheromone value T^i_nd
+typedef float time_estimate_t;          // time estimate in seconds
+typedef float probability_t;            // probability P_nd (or a sum of them)
+typedef float pheromone_weight_t;       // pheromone value to the power of beta
+#endif /* ANT_HOC_NET_FIXED_POINT */
+
+/**
+ * Compact handle of an interned uIP address, see anthocnet-node-id.h.
+ */
+#if ANT_HOC_NET_MAX_NODE_IDS > 254
+typedef uint16_t node_id_t;
+#define NODE_ID_NONE 0xFFFF
+#else
+typedef uint8_t node_id_t;
+#define NODE_ID_NONE 0xFF
+#endif
+
 /**
  * Defines the type of ant.
  */
@@ -27,12 +57,13 @@ typedef enum type_of_packet {
  */
 struct reactive_forward_or_path_repair_ant {
     packet_type_t ant_type;         // the typ of ant
-    unsigned int ant_generation;    // which ant generation that ant corresponds to
+    uint16_t ant_generation;        // which ant generation that ant corresponds to
     uip_ipaddr_t source;            // source address of the ant
     uip_ipaddr_t destination;       // destination address of the ant
-    float time_estimate_T_P;        // travel time
+    time_estimate_t time_estimate_T_P;  // travel time
     hop_t number_broadcasts;        // number of broadcasts for path repair ant
     hop_t hops;                     // number of hops / length of the path
+    bool replied;                   // whether an intermediate node answered the ant already
     uip_ipaddr_t* path;             // script P, path of taken nodes
 };
 
@@ -41,10 +72,11 @@ struct reactive_forward_or_path_repair_ant {
  */
 struct reactive_backward_ant {
     packet_type_t ant_type;         // the typ of ant
-    unsigned int ant_generation;    // which ant generation that ant corresponds to
+    uint16_t ant_generation;        // which ant generation that ant corresponds to
+    bool proactive;                 // whether the ant answers a proactive forward ant, whose generations are apart
     uip_ipaddr_t destination;       // the uip addr of the node that expects the backward ant
     hop_t current_hop;              // the current hop in the path; beginning from 0 (i.e. destination)
-    float time_estimate_T_P;        // estimate of travel time for a data packet
+    time_estimate_t time_estimate_T_P;  // estimate of travel time for a data packet
     uint8_t length;                 // length of path P / array
     uip_ipaddr_t* path;             // script P, path the ant needs to take
 };
@@ -55,17 +87,30 @@ struct reactive_backward_ant {
 struct proactive_forward_ant {
     uip_ipaddr_t source;            // source of the PFA
     uip_ipaddr_t destination;       // destination of the PFA
+    uint16_t ant_generation;        // generation of the proactive ants of the source
     uint8_t number_of_broadcasts;   // the number of times the ant got broadcast
     hop_t hops;                     // number of hops the ant has taken / length of the path
     uip_ipaddr_t* path;             // path the ant has take
 };
 
+/**
+ * Defines an entry of the digest of a hello message, i.e. the best path of the sender to one of its destinations.
+ */
+typedef struct hello_digest_entry {
+    uip_ipaddr_t destination;           // the uIP address of the destination
+    time_estimate_t time_estimate_T_P;  // the time estimate of the best path of the sender to the destination
+    hop_t hops;                         // the number of hops of that path
+} hello_digest_entry_t;
+
 /**
  * Defines hello package that only contains the nodes ip address. Sent to signal that the node is alive.
  */
 struct hello_message {
     uip_ipaddr_t source;     // ip-address of the sender
-    float time_estimate_T_P; // time estimate of the path to the destination
+    time_estimate_t time_estimate_T_P;  // time estimate of the path to the destination
+    clock_time_t hello_interval;        // longest time in ticks until the next hello of the sender
+    uint8_t digest_size;                // number of entries of the digest
+    hello_digest_entry_t *digest;       // best paths of the sender to some of its destinations, NULL if none
 };
 
 /**
@@ -75,7 +120,7 @@ struct hello_message {
 typedef struct link_failure_notification_entry {
     uip_ipaddr_t uip_address_of_destination;            // the uIP address of the destination
     hop_t number_of_hops_to_new_best_destination;       // the number of hops to reach the destination via the new best path
-    float time_estimate_T_P_of_new_best_destination;    // the time estimate of the new best path to the destination
+    time_estimate_t time_estimate_T_P_of_new_best_destination;  // the time estimate of the new best path to the destination
 } link_failure_notification_entry_t ;
 
 /**
@@ -104,61 +149,87 @@ struct warning_message {
  * Structure for best ant of a generation.
  */
 typedef struct best_ant {
-    unsigned int generation;        // the generation of the ants
+    uint16_t generation;            // the generation of the ants
     hop_t hop_count;                // best hop count of this generation
-    float time_estimate;            // best time estimate of this generation
-    unsigned int first_hops_len;    // the number of elements in the first hop array
-    uip_ipaddr_t *first_hops;       // first hops of the accepted ants for the acceptance for new ant with respect to a2
+    time_estimate_t time_estimate;  // best time estimate of this generation
+    uint8_t first_hops_len;         // the number of elements in the first hop array
+    node_id_t first_hops[ANT_HOC_NET_BEST_ANT_FIRST_HOPS];  // node ids of the first hops of the accepted ants for the acceptance for new ant with respect to a2
 } best_ant_t;
 
 /**
- * Structure for the best ant array for one neighbour.
+ * Structure for the best ants of the latest generations of one source. The generations are kept in a ring, a new
+ * generation overwrites the oldest one.
  */
 typedef struct best_ants {
-    struct best_ants * next;                                // the next element in the list
-    uip_ipaddr_t source;                                    // the source of the ant
-    best_ant_t * best_ants_per_generation_array;            // the best ants per generation coming from the specific neighbour
-    unsigned int size_of_best_ants_per_generation_array;    // the size of the best_ants_per_generation_array
+    struct best_ants * next;                                        // the next element in the list of used entries
+    node_id_t source;                                               // node id of the source of the ant
+    clock_time_t last_seen;                                         // time the last ant of the source was received
+    uint8_t number_of_generations;                                  // the number of used elements of the ring
+    uint8_t next_generation;                                        // the element of the ring the next generation is put into
+    best_ant_t generations[ANT_HOC_NET_BEST_ANT_GENERATIONS];       // the best ants per generation coming from the source
 } best_ants_t;
 
 /**
- * Struct to store last package data.
+ * Structure for a reverse route, the node the first forward ant of a generation of a source was received from.
+ * Backward ants follow the reverse routes instead of a path with ANT_HOC_NET_STATEFUL_REVERSE_ROUTES.
  */
-typedef struct last_package_data {
-    uip_ipaddr_t destination;
-    uip_ipaddr_t selected_nexthop;
-    uint16_t len;
-    unsigned char *buffer;
-} last_package_data_t;
+typedef struct reverse_route {
+    struct reverse_route * next;    // the next element in the list of used entries
+    node_id_t source;               // node id of the source of the forward ant
+    uint16_t generation;            // generation of the forward ant
+    bool proactive;                 // whether the forward ant is a proactive one, their generations are counted apart
+    node_id_t previous_hop;         // node id of the node the forward ant was received from
+    clock_time_t created;           // time the forward ant was received
+} reverse_route_t;
 
 /**
- * Struct to store the times of the last packages per destination
+ * Structure for the data session to a destination, an entry of the hashed flow table.
  */
-typedef struct last_destination_data {
-    struct last_destination_data *next;
-    uip_ipaddr_t destination;
-    clock_time_t time;
-    uint8_t count;
-} last_destination_data_t;
+typedef struct flow {
+    uip_ipaddr_t destination;       // uIP address of the destination
+    bool used;                      // whether the entry holds a session
+    uint8_t packets;                // number of packets since the last proactive forward ant
+    uint8_t backoff;                // number of times the interval between the ants is doubled, while the path is stable
+    clock_time_t last_packet;       // time the last packet was sent
+    clock_time_t last_ant;          // time the last proactive forward ant was sent, or the session started
+    clock_time_t jitter;            // random time added to the interval before the next ant
+    clock_time_t gap;               // EWMA of the inter-packet gap in ticks, 0 until the second packet
+    pheromone_t pheromone;          // pheromone to the destination when the last ant was sent
+} flow_t;
 
 /**
- * Struct to buffer uip packages
+ * Struct to buffer uip packages, taken from a memb pool
  */
 typedef struct buffer_ip_packages {
     struct buffer_ip_packages *next;
-    unsigned char *buffer;
     uint16_t len;
+    unsigned char buffer[ANT_HOC_NET_BUFFERED_PACKET_LEN];
 } packet_buffer_t;
 
 /**
- * Struct to buffer package in reactive path setup
+ * Struct to buffer the packages of a destination in the path setup
  */
 typedef struct buffer {
-    bool valid;
-    uint16_t number_of_packets;
-    packet_buffer_t *packet_buffer;
+    uint8_t number_of_packets;
+    packet_buffer_t *packet_buffer;     // the oldest package, sent first
+    packet_buffer_t *last_packet;       // the newest package, new packages are appended behind it
 } buffer_t;
 
+/**
+ * Struct of the path setup of a destination, either a reactive path setup or the repair of a path after a failed data
+ * transmission.
+ */
+typedef struct path_setup {
+    struct path_setup *next;        // the next element in the list of used entries
+    uip_ipaddr_t destination;       // the destination the path is set up to
+    uint16_t ant_generation;        // generation of the last forward ant, the backward ant carries it
+    uint8_t try_counter;            // number of forward ants sent
+    bool path_repair;               // whether the path is repaired after a failed data transmission
+    uip_ipaddr_t neighbour;         // the neighbour the data transmission failed to, for a path repair
+    struct etimer timer;            // fires when no backward ant was received in time
+    buffer_t buffer;                // the packets waiting for the path
+} path_setup_t;
+
 /*--End-other-structs-------------------------------------------------------------------------------------------------*/
 
 #endif //IEEE_802_15_4_ANTNET_ANTHOCNET_TYPES_H
@@ -0,0 +1,189 @@
+/**
+ * \file
+ *      Implements the virtual pheromone table.\n
+ *      The paths are taken from a memb pool and refer to their destination and neighbour by node id. A path that wasn't
+ *      advertised within ANT_HOC_NET_VIRTUAL_PHEROMONE_TIMEOUT_SEC is not used anymore, and dropped with the next update
+ *      of the table, so that it doesn't hold its node ids.
+ */
+
+#include "anthocnet-virtual-pheromone.h"
+#include "anthocnet-pheromone.h"
+#include "anthocnet-node-id.h"
+#include "anthocnet-fixed-point.h"
+#include "anthocnet-conf.h"
+#include "lib/memb.h"
+#include "lib/list.h"
+
+// logging
+#include "sys/log.h"
+#define LOG_MODULE "AntHocNet-Virtual-Pheromone"
+#ifdef LOG_CONF_LEVEL_ANTHOCNET_VIRTUAL_PHEROMONE
+#define LOG_LEVEL LOG_CONF_LEVEL_ANTHOCNET_VIRTUAL_PHEROMONE
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+
+#define VIRTUAL_PHEROMONE_TIMEOUT   ((clock_time_t)(ANT_HOC_NET_VIRTUAL_PHEROMONE_TIMEOUT_SEC * CLOCK_SECOND))
+
+/**
+ * Structure for a path of the virtual pheromone table.
+ */
+typedef struct virtual_pheromone_entry {
+    struct virtual_pheromone_entry *next;   // the next element in the list of used entries
+    node_id_t destination;                  // node id of the destination
+    node_id_t neighbour;                    // node id of the neighbour that advertised the path
+    pheromone_t pheromone_value;            // the virtual pheromone value of the path
+    hop_t hops;                             // number of hops of the path
+    clock_time_t last_update;               // when the path was advertised the last time
+} virtual_pheromone_entry_t;
+
+MEMB(virtual_pheromone_memb, virtual_pheromone_entry_t, ANT_HOC_NET_MAX_VIRTUAL_PHEROMONE);
+LIST(virtual_pheromone_list);
+
+static bool virtual_pheromone_expired(const virtual_pheromone_entry_t *entry, clock_time_t now) {
+    return now - entry->last_update > VIRTUAL_PHEROMONE_TIMEOUT;
+}
+
+static void free_virtual_pheromone(virtual_pheromone_entry_t *entry) {
+    node_id_release(entry->destination);
+    node_id_release(entry->neighbour);
+    list_remove(virtual_pheromone_list, entry);
+    memb_free(&virtual_pheromone_memb, entry);
+}
+
+static virtual_pheromone_entry_t *find_virtual_pheromone(node_id_t destination, node_id_t neighbour) {
+    for (virtual_pheromone_entry_t *entry = list_head(virtual_pheromone_list); entry != NULL; entry = list_item_next(entry)) {
+        if (entry->destination == destination && entry->neighbour == neighbour) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Takes a new path from the pool; the paths that expired are dropped first, and if the pool is still exhausted, the
+ * oldest path is replaced.
+ * @return The new path, not linked into the list
+ */
+static virtual_pheromone_entry_t *allocate_virtual_pheromone(clock_time_t now) {
+    virtual_pheromone_entry_t *oldest = NULL;
+    virtual_pheromone_entry_t *entry = list_head(virtual_pheromone_list);
+    while (entry != NULL) {
+        virtual_pheromone_entry_t *next = list_item_next(entry);
+        if (virtual_pheromone_expired(entry, now)) {
+            free_virtual_pheromone(entry);
+        } else if (oldest == NULL || now - entry->last_update > now - oldest->last_update) {
+            oldest = entry;
+        }
+        entry = next;
+    }
+
+    entry = memb_alloc(&virtual_pheromone_memb);
+    if (entry == NULL && oldest != NULL) {
+        LOG_DBG("Virtual pheromone table is full - the oldest path is replaced\n");
+        free_virtual_pheromone(oldest);
+        entry = memb_alloc(&virtual_pheromone_memb);
+    }
+    return entry;
+}
+
+void virtual_pheromone_init() {
+    memb_init(&virtual_pheromone_memb);
+    list_init(virtual_pheromone_list);
+}
+
+void update_virtual_pheromone(const uip_ipaddr_t *destination, const uip_ipaddr_t *neighbour, pheromone_t tau_i_d,
+                              hop_t hops) {
+    clock_time_t now = clock_time();
+    virtual_pheromone_entry_t *entry = find_virtual_pheromone(node_id_lookup(destination), node_id_lookup(neighbour));
+    if (entry != NULL && !virtual_pheromone_expired(entry, now)) {
+        entry->pheromone_value = calc_new_pheromone_value(entry->pheromone_value, tau_i_d);
+        entry->hops = hops;
+        entry->last_update = now;
+        return;
+    }
+    if (entry != NULL) {
+        free_virtual_pheromone(entry);
+    }
+
+    entry = allocate_virtual_pheromone(now);
+    if (entry == NULL) {
+        return;
+    }
+    entry->destination = node_id_acquire(destination);
+    entry->neighbour = node_id_acquire(neighbour);
+    if (entry->destination == NODE_ID_NONE || entry->neighbour == NODE_ID_NONE) {
+        LOG_WARN("No node id left - virtual pheromone is not kept!\n");
+        node_id_release(entry->destination);
+        node_id_release(entry->neighbour);
+        memb_free(&virtual_pheromone_memb, entry);
+        return;
+    }
+    entry->pheromone_value = calc_new_pheromone_value(REAL_CONST(0.0), tau_i_d);
+    entry->hops = hops;
+    entry->last_update = now;
+    list_add(virtual_pheromone_list, entry);
+
+    LOG_DBG("New virtual pheromone %f to ", REAL_TO_FLOAT(entry->pheromone_value));
+    LOG_DBG_6ADDR(destination);
+    LOG_DBG_(" over ");
+    LOG_DBG_6ADDR(neighbour);
+    LOG_DBG_("\n");
+}
+
+bool get_virtual_next_hop(const uip_ipaddr_t *destination, uip_ipaddr_t *next_hop) {
+    node_id_t destination_id = node_id_lookup(destination);
+    if (destination_id == NODE_ID_NONE) {
+        return false;
+    }
+    clock_time_t now = clock_time();
+    virtual_pheromone_entry_t *best = NULL;
+    for (virtual_pheromone_entry_t *entry = list_head(virtual_pheromone_list); entry != NULL; entry = list_item_next(entry)) {
+        if (entry->destination != destination_id || virtual_pheromone_expired(entry, now)
+            || (best != NULL && entry->pheromone_value <= best->pheromone_value)) {
+            continue;
+        }
+        // the neighbour may have been lost since it advertised the path
+        if (does_neighbour_exists(*node_id_address(entry->neighbour))) {
+            best = entry;
+        }
+    }
+    if (best == NULL) {
+        return false;
+    }
+    *next_hop = *node_id_address(best->neighbour);
+    return true;
+}
+
+void delete_virtual_pheromone_of_path(const uip_ipaddr_t *destination, const uip_ipaddr_t *neighbour) {
+    node_id_t destination_id = node_id_lookup(destination);
+    node_id_t neighbour_id = node_id_lookup(neighbour);
+    if (destination_id == NODE_ID_NONE || neighbour_id == NODE_ID_NONE) {
+        return;
+    }
+    virtual_pheromone_entry_t *entry = find_virtual_pheromone(destination_id, neighbour_id);
+    if (entry != NULL) {
+        free_virtual_pheromone(entry);
+    }
+}
+
+void delete_virtual_pheromone_of_neighbour(const uip_ipaddr_t *neighbour) {
+    node_id_t neighbour_id = node_id_lookup(neighbour);
+    if (neighbour_id == NODE_ID_NONE) {
+        return;
+    }
+    virtual_pheromone_entry_t *entry = list_head(virtual_pheromone_list);
+    while (entry != NULL) {
+        virtual_pheromone_entry_t *next = list_item_next(entry);
+        if (entry->neighbour == neighbour_id) {
+            free_virtual_pheromone(entry);
+        }
+        entry = next;
+    }
+}
+
+void delete_virtual_pheromone() {
+    while (list_head(virtual_pheromone_list) != NULL) {
+        free_virtual_pheromone(list_head(virtual_pheromone_list));
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * \file
+ *      Declarations of the functions for the virtual pheromone table.\n
+ *      With ANT_HOC_NET_HELLO_DIGEST_ENTRIES the hello messages carry the best paths of their sender to some of its
+ *      destinations. The pheromone these digests lead to is kept apart from the pheromone table, since no ant has
+ *      walked the paths; it is only used by the source of a data packet if the pheromone table has no neighbour for the
+ *      destination, instead of setting up a path with reactive forward ants.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_VIRTUAL_PHEROMONE_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_VIRTUAL_PHEROMONE_H
+
+#include "../../contiki-ng/os/net/ipv6/uip.h"
+#include "anthocnet-types.h"
+#include <stdbool.h>
+
+/**
+ * Initializes the virtual pheromone table; all paths are dropped.
+ */
+void virtual_pheromone_init();
+
+/**
+ * Updates the virtual pheromone of the path over a neighbour to a destination with a new pheromone value, as
+ * equation (6) of the AntHocNet paper does for the pheromone table. If the table is full, the oldest path is replaced.
+ * @param destination uIP address of the destination
+ * @param neighbour uIP address of the neighbour that advertised the path
+ * @param tau_i_d The pheromone value of the advertised path, including the hop to the neighbour
+ * @param hops The number of hops of the path, including the hop to the neighbour
+ */
+void update_virtual_pheromone(const uip_ipaddr_t *destination, const uip_ipaddr_t *neighbour, pheromone_t tau_i_d,
+                              hop_t hops);
+
+/**
+ * Selects the neighbour with the largest virtual pheromone to a destination. Only paths that were advertised within
+ * ANT_HOC_NET_VIRTUAL_PHEROMONE_TIMEOUT_SEC, over neighbours of the pheromone table, are taken.
+ * @param destination uIP address of the destination
+ * @param next_hop Is set to the uIP address of the selected neighbour
+ * @return True if a neighbour was selected
+ */
+bool get_virtual_next_hop(const uip_ipaddr_t *destination, uip_ipaddr_t *next_hop);
+
+/**
+ * Removes the virtual pheromone of the path over a neighbour to a destination, e.g. if the neighbour warned that it
+ * has no path to the destination.
+ * @param destination uIP address of the destination
+ * @param neighbour uIP address of the neighbour
+ */
+void delete_virtual_pheromone_of_path(const uip_ipaddr_t *destination, const uip_ipaddr_t *neighbour);
+
+/**
+ * Removes the virtual pheromone of all paths over a neighbour.
+ * @param neighbour uIP address of the lost neighbour
+ */
+void delete_virtual_pheromone_of_neighbour(const uip_ipaddr_t *neighbour);
+
+/**
+ * Drops all paths of the virtual pheromone table.
+ */
+void delete_virtual_pheromone();
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_VIRTUAL_PHEROMONE_H
@@ -0,0 +1,406 @@
+/**
+ * \file
+ *      Implements the encoding of the AntHocNet messages on the air.
+ */
+
+#include "anthocnet-wire.h"
+#include "anthocnet-conf.h"
+#include "uip-ds6.h"
+#include <string.h>
+
+/* one in Q16.16, the encoding of the time estimates */
+#define WIRE_TIME_ONE   (1L << 16)
+
+/* units of the hello interval per second, it is encoded independent of CLOCK_SECOND */
+#define WIRE_HELLO_INTERVAL_UNITS   100
+
+/* alignment of the decoded entries of a link failure notification or of the digest of a hello message */
+#define ENTRY_ALIGNMENT sizeof(uint32_t)
+
+// sizes of the parts of an address
+#define PREFIX_LEN      8
+#define IID_LEN         8
+#define SHORT_ID_LEN    2
+
+// flags of a reactive forward ant; the lower bits hold the number of broadcasts
+#define RFA_FLAG_PATH_REPAIR_ANT    0x80
+#define RFA_FLAG_REPLIED            0x40
+#define RFA_MAX_BROADCASTS          0x3F
+
+// flags of a reactive backward ant
+#define RBA_FLAG_PROACTIVE          0x01
+
+static void put_u16(uint8_t *buf, uint16_t value) {
+    buf[0] = value >> 8;
+    buf[1] = value & 0xFF;
+}
+
+static uint16_t get_u16(const uint8_t *buf) {
+    return ((uint16_t)buf[0] << 8) | buf[1];
+}
+
+static void put_u32(uint8_t *buf, uint32_t value) {
+    buf[0] = value >> 24;
+    buf[1] = (value >> 16) & 0xFF;
+    buf[2] = (value >> 8) & 0xFF;
+    buf[3] = value & 0xFF;
+}
+
+static uint32_t get_u32(const uint8_t *buf) {
+    return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3];
+}
+
+static uint8_t saturate_u8(unsigned int value) {
+    return value > 0xFF ? 0xFF : value;
+}
+
+static void put_time_estimate(uint8_t *buf, time_estimate_t time_estimate) {
+#if ANT_HOC_NET_FIXED_POINT
+    put_u32(buf, (uint32_t)time_estimate);
+#else
+    float scaled = time_estimate * WIRE_TIME_ONE;
+    int32_t value;
+    if (scaled >= (float)INT32_MAX) {
+        value = INT32_MAX;
+    } else if (scaled <= (float)INT32_MIN) {
+        value = INT32_MIN;
+    } else {
+        value = (int32_t)(scaled + (scaled >= 0 ? 0.5f : -0.5f));
+    }
+    put_u32(buf, (uint32_t)value);
+#endif
+}
+
+static time_estimate_t get_time_estimate(const uint8_t *buf) {
+#if ANT_HOC_NET_FIXED_POINT
+    return (int32_t)get_u32(buf);
+#else
+    return (float)(int32_t)get_u32(buf) / WIRE_TIME_ONE;
+#endif
+}
+
+static uint8_t path_element_len(wire_path_encoding_t encoding) {
+    switch (encoding) {
+        case WIRE_PATH_FULL:
+            return sizeof(uip_ipaddr_t);
+        case WIRE_PATH_IID:
+            return IID_LEN;
+        case WIRE_PATH_SHORT:
+            return SHORT_ID_LEN;
+    }
+    return 0;
+}
+
+/**
+ * Builds the address of a node, whose link-layer address is made of its node id, as done for Cooja motes.
+ * @param address The address to set
+ * @param source The address to take the prefix from
+ * @param short_id The node id, the last two bytes of the link-layer address
+ */
+static void set_address_of_short_id(uip_ipaddr_t *address, const uip_ipaddr_t *source, uint16_t short_id) {
+    uip_lladdr_t lladdr;
+    for (uint8_t i = 0; i + 1 < sizeof(lladdr.addr); i += 2) {
+        lladdr.addr[i] = short_id >> 8;
+        lladdr.addr[i + 1] = short_id & 0xFF;
+    }
+    memcpy(address, source, PREFIX_LEN);
+    uip_ds6_set_addr_iid(address, &lladdr);
+}
+
+/**
+ * Returns the most compact encoding, that can represent the address.
+ */
+static wire_path_encoding_t get_address_encoding(const uip_ipaddr_t *address, const uip_ipaddr_t *source) {
+    if (memcmp(address, source, PREFIX_LEN) != 0) {
+        return WIRE_PATH_FULL;
+    }
+    uip_ipaddr_t short_address;
+    set_address_of_short_id(&short_address, source, get_u16(&address->u8[sizeof(uip_ipaddr_t) - SHORT_ID_LEN]));
+    return uip_ipaddr_cmp(&short_address, address) ? WIRE_PATH_SHORT : WIRE_PATH_IID;
+}
+
+/**
+ * Returns the most compact encoding, that can represent all nodes of the path.
+ */
+static wire_path_encoding_t get_path_encoding(const uip_ipaddr_t *path, uint8_t hops, const uip_ipaddr_t *source) {
+    wire_path_encoding_t encoding = WIRE_PATH_SHORT;
+    for (uint8_t i = 0; i < hops && encoding != WIRE_PATH_FULL; ++i) {
+        // the encodings are ordered from the least to the most compact one
+        wire_path_encoding_t address_encoding = get_address_encoding(&path[i], source);
+        if (address_encoding < encoding) {
+            encoding = address_encoding;
+        }
+    }
+    return encoding;
+}
+
+/**
+ * Decodes one address of a path.
+ * @param encoded The encoded address
+ * @param source The address the prefix is taken from
+ * @param encoding The encoding of the address, must be known
+ * @param address The address to set
+ */
+static void get_address(const uint8_t *encoded, const uip_ipaddr_t *source, wire_path_encoding_t encoding,
+                        uip_ipaddr_t *address) {
+    switch (encoding) {
+        case WIRE_PATH_FULL:
+            memcpy(address, encoded, sizeof(uip_ipaddr_t));
+            break;
+        case WIRE_PATH_IID:
+            memcpy(address, source, PREFIX_LEN);
+            memcpy(&address->u8[PREFIX_LEN], encoded, IID_LEN);
+            break;
+        case WIRE_PATH_SHORT:
+            set_address_of_short_id(address, source, get_u16(encoded));
+            break;
+    }
+}
+
+uint16_t wire_write_path(uint8_t *buf, const uip_ipaddr_t *path, uint8_t hops, const uip_ipaddr_t *source,
+                         wire_path_encoding_t *encoding) {
+    *encoding = get_path_encoding(path, hops, source);
+    uint8_t element_len = path_element_len(*encoding);
+
+    // the last bytes of every address are kept; an encoded node never overlaps an address that is not encoded yet
+    for (uint8_t i = 0; i < hops; ++i) {
+        memmove(&buf[i * element_len], &path[i].u8[sizeof(uip_ipaddr_t) - element_len], element_len);
+    }
+    return hops * element_len;
+}
+
+bool wire_read_path(uint8_t *buf, uint16_t len, uint16_t buf_size, uint8_t hops, const uip_ipaddr_t *source,
+                    wire_path_encoding_t encoding) {
+    uint8_t element_len = path_element_len(encoding);
+    if (element_len == 0 || len / element_len < hops || buf_size / sizeof(uip_ipaddr_t) < hops) {
+        return false;
+    }
+
+    // an address is larger than an encoded node, so address i only overlaps encoded nodes >= i;
+    // decoding from the last node to the first never overwrites a node that is not decoded yet
+    for (int i = hops - 1; i >= 0; --i) {
+        uip_ipaddr_t address;
+        get_address(&buf[i * element_len], source, encoding, &address);
+        memcpy(&buf[i * sizeof(uip_ipaddr_t)], &address, sizeof(uip_ipaddr_t));
+    }
+    return true;
+}
+
+uint16_t wire_write_reactive_forward_ant(uint8_t *buf, const struct reactive_forward_or_path_repair_ant *ant) {
+    uint8_t flags = ant->number_broadcasts > RFA_MAX_BROADCASTS ? RFA_MAX_BROADCASTS : ant->number_broadcasts;
+    if (ant->ant_type == PATH_REPAIR_ANT) {
+        flags |= RFA_FLAG_PATH_REPAIR_ANT;
+    }
+    if (ant->replied) {
+        flags |= RFA_FLAG_REPLIED;
+    }
+    buf[0] = flags;
+    buf[1] = saturate_u8(ant->hops);
+    put_u16(&buf[2], ant->ant_generation);
+    memcpy(&buf[4], &ant->source, sizeof(uip_ipaddr_t));
+    memcpy(&buf[20], &ant->destination, sizeof(uip_ipaddr_t));
+    put_time_estimate(&buf[36], ant->time_estimate_T_P);
+    return WIRE_RFA_HEADER_LEN;
+}
+
+void wire_read_reactive_forward_ant(const uint8_t *buf, struct reactive_forward_or_path_repair_ant *ant) {
+    ant->ant_type = (buf[0] & RFA_FLAG_PATH_REPAIR_ANT) ? PATH_REPAIR_ANT : REACTIVE_FORWARD_ANT;
+    ant->number_broadcasts = buf[0] & RFA_MAX_BROADCASTS;
+    ant->replied = (buf[0] & RFA_FLAG_REPLIED) != 0;
+    ant->hops = buf[1];
+    ant->ant_generation = get_u16(&buf[2]);
+    memcpy(&ant->source, &buf[4], sizeof(uip_ipaddr_t));
+    memcpy(&ant->destination, &buf[20], sizeof(uip_ipaddr_t));
+    ant->time_estimate_T_P = get_time_estimate(&buf[36]);
+}
+
+uint16_t wire_write_reactive_backward_ant(uint8_t *buf, const struct reactive_backward_ant *ant) {
+    put_u16(&buf[0], ant->ant_generation);
+    buf[2] = saturate_u8(ant->current_hop);
+    buf[3] = ant->length;
+    buf[4] = ant->proactive ? RBA_FLAG_PROACTIVE : 0;
+    // reserved, keeps the size of the fixed part even
+    buf[5] = 0;
+    put_time_estimate(&buf[6], ant->time_estimate_T_P);
+    memcpy(&buf[10], &ant->destination, sizeof(uip_ipaddr_t));
+    return WIRE_RBA_HEADER_LEN;
+}
+
+void wire_read_reactive_backward_ant(const uint8_t *buf, struct reactive_backward_ant *ant) {
+    ant->ant_type = BACKWARD_ANT;
+    ant->ant_generation = get_u16(&buf[0]);
+    ant->current_hop = buf[2];
+    ant->length = buf[3];
+    ant->proactive = (buf[4] & RBA_FLAG_PROACTIVE) != 0;
+    ant->time_estimate_T_P = get_time_estimate(&buf[6]);
+    memcpy(&ant->destination, &buf[10], sizeof(uip_ipaddr_t));
+}
+
+uint16_t wire_write_proactive_forward_ant(uint8_t *buf, const struct proactive_forward_ant *ant) {
+    buf[0] = ant->number_of_broadcasts;
+    buf[1] = saturate_u8(ant->hops);
+    put_u16(&buf[2], ant->ant_generation);
+    memcpy(&buf[4], &ant->source, sizeof(uip_ipaddr_t));
+    memcpy(&buf[20], &ant->destination, sizeof(uip_ipaddr_t));
+    return WIRE_PFA_HEADER_LEN;
+}
+
+void wire_read_proactive_forward_ant(const uint8_t *buf, struct proactive_forward_ant *ant) {
+    ant->number_of_broadcasts = buf[0];
+    ant->hops = buf[1];
+    ant->ant_generation = get_u16(&buf[2]);
+    memcpy(&ant->source, &buf[4], sizeof(uip_ipaddr_t));
+    memcpy(&ant->destination, &buf[20], sizeof(uip_ipaddr_t));
+}
+
+uint16_t wire_write_hello_message(uint8_t *buf, const struct hello_message *msg, wire_path_encoding_t *encoding) {
+    memcpy(&buf[0], &msg->source, sizeof(uip_ipaddr_t));
+    put_time_estimate(&buf[16], msg->time_estimate_T_P);
+    // rounded up, so that the interval is never too short at the neighbours
+    unsigned long interval = ((unsigned long)msg->hello_interval * WIRE_HELLO_INTERVAL_UNITS + CLOCK_SECOND - 1)
+                             / CLOCK_SECOND;
+    put_u16(&buf[20], interval > 0xFFFF ? 0xFFFF : interval);
+    buf[22] = msg->digest_size;
+
+    // the destinations of the digest are compressed like the nodes of a path
+    *encoding = WIRE_PATH_SHORT;
+    for (uint8_t i = 0; i < msg->digest_size && *encoding != WIRE_PATH_FULL; ++i) {
+        wire_path_encoding_t address_encoding = get_address_encoding(&msg->digest[i].destination, &msg->source);
+        if (address_encoding < *encoding) {
+            *encoding = address_encoding;
+        }
+    }
+    uint8_t element_len = path_element_len(*encoding);
+
+    uint8_t *entry = &buf[WIRE_HELLO_HEADER_LEN];
+    for (uint8_t i = 0; i < msg->digest_size; ++i) {
+        put_time_estimate(&entry[0], msg->digest[i].time_estimate_T_P);
+        entry[4] = saturate_u8(msg->digest[i].hops);
+        memcpy(&entry[5], &msg->digest[i].destination.u8[sizeof(uip_ipaddr_t) - element_len], element_len);
+        entry += WIRE_HELLO_ENTRY_FIXED_LEN + element_len;
+    }
+    return WIRE_HELLO_HEADER_LEN + msg->digest_size * (WIRE_HELLO_ENTRY_FIXED_LEN + element_len);
+}
+
+uint8_t wire_max_hello_digest_entries(uint16_t buf_size) {
+    if (buf_size < WIRE_HELLO_HEADER_LEN + ENTRY_ALIGNMENT - 1) {
+        return 0;
+    }
+    uint16_t entries = (buf_size - WIRE_HELLO_HEADER_LEN - (ENTRY_ALIGNMENT - 1)) / sizeof(hello_digest_entry_t);
+    return entries > 0xFF ? 0xFF : entries;
+}
+
+bool wire_read_hello_message(uint8_t *buf, uint16_t len, uint16_t buf_size, wire_path_encoding_t encoding,
+                             struct hello_message *msg) {
+    if (len < WIRE_HELLO_HEADER_LEN) {
+        return false;
+    }
+    memcpy(&msg->source, &buf[0], sizeof(uip_ipaddr_t));
+    msg->time_estimate_T_P = get_time_estimate(&buf[16]);
+    // at least one tick, the hello loss is measured in multiples of it
+    unsigned long interval = get_u16(&buf[20]);
+    if (interval == 0) {
+        interval = 1;
+    }
+    msg->hello_interval = (clock_time_t)((interval * CLOCK_SECOND + WIRE_HELLO_INTERVAL_UNITS - 1)
+                                         / WIRE_HELLO_INTERVAL_UNITS);
+    msg->digest_size = buf[22];
+    msg->digest = NULL;
+
+    uint8_t size = msg->digest_size;
+    if (size == 0) {
+        return true;
+    }
+    uint8_t entry_len = WIRE_HELLO_ENTRY_FIXED_LEN + path_element_len(encoding);
+    if (entry_len == WIRE_HELLO_ENTRY_FIXED_LEN || (len - WIRE_HELLO_HEADER_LEN) / entry_len < size
+        || size > wire_max_hello_digest_entries(buf_size)) {
+        return false;
+    }
+
+    uintptr_t address = (uintptr_t)&buf[WIRE_HELLO_HEADER_LEN];
+    address = (address + ENTRY_ALIGNMENT - 1) & ~(uintptr_t)(ENTRY_ALIGNMENT - 1);
+    hello_digest_entry_t *digest = (hello_digest_entry_t *)address;
+
+    // as for the link failure notifications, decoding from the last entry to the first never overwrites an entry that
+    // is not decoded yet
+    for (int i = size - 1; i >= 0; --i) {
+        const uint8_t *encoded = &buf[WIRE_HELLO_HEADER_LEN + i * entry_len];
+        hello_digest_entry_t entry;
+        entry.time_estimate_T_P = get_time_estimate(&encoded[0]);
+        entry.hops = encoded[4];
+        get_address(&encoded[5], &msg->source, encoding, &entry.destination);
+        digest[i] = entry;
+    }
+    msg->digest = digest;
+    return true;
+}
+
+uint16_t wire_write_warning_message(uint8_t *buf, const struct warning_message *msg) {
+    memcpy(&buf[0], &msg->destination, sizeof(uip_ipaddr_t));
+    memcpy(&buf[16], &msg->source, sizeof(uip_ipaddr_t));
+    return WIRE_WARNING_LEN;
+}
+
+void wire_read_warning_message(const uint8_t *buf, struct warning_message *msg) {
+    msg->packet_type = WARNING_MESSAGE;
+    memcpy(&msg->destination, &buf[0], sizeof(uip_ipaddr_t));
+    memcpy(&msg->source, &buf[16], sizeof(uip_ipaddr_t));
+}
+
+uint16_t wire_write_link_failure_notification(uint8_t *buf, const link_failure_notification_t *lfn) {
+    buf[0] = lfn->size_of_list_of_destinations;
+    memcpy(&buf[1], &lfn->source, sizeof(uip_ipaddr_t));
+    memcpy(&buf[17], &lfn->failed_link, sizeof(uip_ipaddr_t));
+
+    uint8_t *entry = &buf[WIRE_LFN_HEADER_LEN];
+    for (uint8_t i = 0; i < lfn->size_of_list_of_destinations; ++i) {
+        memcpy(&entry[0], &lfn->entries[i].uip_address_of_destination, sizeof(uip_ipaddr_t));
+        entry[16] = saturate_u8(lfn->entries[i].number_of_hops_to_new_best_destination);
+        put_time_estimate(&entry[17], lfn->entries[i].time_estimate_T_P_of_new_best_destination);
+        entry += WIRE_LFN_ENTRY_LEN;
+    }
+    return WIRE_LFN_HEADER_LEN + lfn->size_of_list_of_destinations * WIRE_LFN_ENTRY_LEN;
+}
+
+uint8_t wire_max_link_failure_notification_entries(uint16_t buf_size) {
+    if (buf_size < WIRE_LFN_HEADER_LEN + ENTRY_ALIGNMENT - 1) {
+        return 0;
+    }
+    uint16_t entries = (buf_size - WIRE_LFN_HEADER_LEN - (ENTRY_ALIGNMENT - 1)) / sizeof(link_failure_notification_entry_t);
+    return entries > 0xFF ? 0xFF : entries;
+}
+
+bool wire_read_link_failure_notification(uint8_t *buf, uint16_t len, uint16_t buf_size, link_failure_notification_t *lfn) {
+    if (len < WIRE_LFN_HEADER_LEN) {
+        return false;
+    }
+    lfn->size_of_list_of_destinations = buf[0];
+    memcpy(&lfn->source, &buf[1], sizeof(uip_ipaddr_t));
+    memcpy(&lfn->failed_link, &buf[17], sizeof(uip_ipaddr_t));
+
+    uint8_t size = lfn->size_of_list_of_destinations;
+    if ((len - WIRE_LFN_HEADER_LEN) / WIRE_LFN_ENTRY_LEN < size || size > wire_max_link_failure_notification_entries(buf_size)) {
+        return false;
+    }
+    if (size == 0) {
+        lfn->entries = NULL;
+        return true;
+    }
+
+    uintptr_t address = (uintptr_t)&buf[WIRE_LFN_HEADER_LEN];
+    address = (address + ENTRY_ALIGNMENT - 1) & ~(uintptr_t)(ENTRY_ALIGNMENT - 1);
+    link_failure_notification_entry_t *entries = (link_failure_notification_entry_t *)address;
+
+    // a decoded entry is larger than an encoded one, so decoded entry i only overlaps encoded entries >= i;
+    // decoding from the last entry to the first never overwrites an entry that is not decoded yet
+    for (int i = size - 1; i >= 0; --i) {
+        const uint8_t *encoded = &buf[WIRE_LFN_HEADER_LEN + i * WIRE_LFN_ENTRY_LEN];
+        link_failure_notification_entry_t entry;
+        memcpy(&entry.uip_address_of_destination, &encoded[0], sizeof(uip_ipaddr_t));
+        entry.number_of_hops_to_new_best_destination = encoded[16];
+        entry.time_estimate_T_P_of_new_best_destination = get_time_estimate(&encoded[17]);
+        entries[i] = entry;
+    }
+    lfn->entries = entries;
+    return true;
+}
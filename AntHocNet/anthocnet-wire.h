@@ -0,0 +1,216 @@
+/**
+ * \file
+ *      Encoding of the AntHocNet messages on the air.\n
+ *      The fields are written in network byte order with explicit sizes, independent of the compiler and the platform;
+ *      generations have 16, hop counts and numbers of broadcasts 8 bits, time estimates are Q16.16 numbers with 32
+ *      bits. The version of the encoding is sent in the lower bits of the ICMPv6 code, messages of other versions are
+ *      dropped.\n
+ *      Paths are sent behind the fixed part of an ant. If all nodes of a path share the /64 prefix of the source of the
+ *      ant, only their interface identifiers are sent; if in addition their link-layer addresses are built from a
+ *      16 bit node id, as for Cooja motes, only that node id is sent. With 2 bytes per hop an ant of 12 hops still
+ *      fits into one 802.15.4 frame. The encoding of the path is sent in the upper bits of the ICMPv6 code. In uip_buf
+ *      the paths are expanded to uIP addresses, so that they can be extended in place; the fixed parts of the ants
+ *      have an even size, which keeps these addresses aligned.\n
+ *      With ANT_HOC_NET_STATEFUL_REVERSE_ROUTES the ants only carry a window of their path, see WIRE_PATH_ELEMENTS;
+ *      such ants are marked in the ICMPv6 code, ants of the other mode are dropped.\n
+ *      The destinations of the digest of a hello message are compressed like a path, against the source of the hello.
+ */
+#ifndef IEEE_802_15_4_ANTNET_ANTHOCNET_WIRE_H
+#define IEEE_802_15_4_ANTNET_ANTHOCNET_WIRE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "anthocnet-types.h"
+
+/** Version of the encoding, sent in the ICMPv6 code of every message. */
+#define WIRE_VERSION 5
+
+/** Encodings of the paths of the ants. */
+typedef enum wire_path_encoding {
+    WIRE_PATH_FULL = 0,     // uIP addresses, 16 bytes per hop
+    WIRE_PATH_IID = 1,      // interface identifiers, the prefix is that of the source, 8 bytes per hop
+    WIRE_PATH_SHORT = 2,    // node ids the link-layer addresses are built of, 2 bytes per hop
+} wire_path_encoding_t;
+
+// flag of the ICMPv6 code of an ant, set if the ant carries a window of its path instead of the path
+#define WIRE_CODE_REVERSE_ROUTES            0x40
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+#define WIRE_CODE_FLAGS                     WIRE_CODE_REVERSE_ROUTES
+#else
+#define WIRE_CODE_FLAGS                     0
+#endif
+
+// ICMPv6 code of a message: the version in the lower four bits, the encoding of the path and the flags in the upper ones
+#define WIRE_CODE(path_encoding)            (WIRE_CODE_FLAGS | ((path_encoding) << 4) | WIRE_VERSION)
+#define WIRE_CODE_VERSION(code)             ((code) & 0x0F)
+#define WIRE_CODE_PATH_ENCODING(code)       ((wire_path_encoding_t)(((code) >> 4) & 0x03))
+
+/**
+ * Number of addresses in the path of an ant with the given hops. With ANT_HOC_NET_STATEFUL_REVERSE_ROUTES, a forward ant
+ * only carries its first hop and the last node it passed, a backward ant its origin and the last node it passed.
+ */
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+#define WIRE_PATH_WINDOW                    2
+#define WIRE_PATH_ELEMENTS(hops)            ((hops) < WIRE_PATH_WINDOW ? (hops) : WIRE_PATH_WINDOW)
+#else
+#define WIRE_PATH_ELEMENTS(hops)            (hops)
+#endif
+
+// sizes of the encoded fixed parts of the messages, in front of their path or entries
+#define WIRE_RFA_HEADER_LEN     40  // flags, hops, generation, source, destination, time estimate
+#define WIRE_RBA_HEADER_LEN     26  // generation, current hop, length, flags, reserved, time estimate, destination
+#define WIRE_PFA_HEADER_LEN     36  // number of broadcasts, hops, generation, source, destination
+#define WIRE_HELLO_HEADER_LEN   23  // source, time estimate, hello interval, number of entries
+#define WIRE_WARNING_LEN        32  // destination, source
+#define WIRE_LFN_HEADER_LEN     33  // number of entries, source, failed link
+#define WIRE_LFN_ENTRY_LEN      21  // destination, hops, time estimate
+// size of an entry of the digest of a hello message without its destination, which is compressed
+#define WIRE_HELLO_ENTRY_FIXED_LEN      5   // time estimate, hops
+#define WIRE_HELLO_ENTRY_MAX_LEN        (WIRE_HELLO_ENTRY_FIXED_LEN + 16)
+
+#if ANT_HOC_NET_MAX_HOPS > 255
+#error The hop count of an ant is encoded with 8 bits, ANT_HOC_NET_MAX_HOPS must not be larger than 255
+#endif
+
+/**
+ * Encodes the fixed part of a reactive forward ant or a path repair ant.
+ * @param buf The buffer of at least WIRE_RFA_HEADER_LEN bytes
+ * @param ant The ant
+ * @return WIRE_RFA_HEADER_LEN
+ */
+uint16_t wire_write_reactive_forward_ant(uint8_t *buf, const struct reactive_forward_or_path_repair_ant *ant);
+
+/**
+ * Decodes the fixed part of a reactive forward ant or a path repair ant; the path is not touched.
+ * @param buf The buffer of at least WIRE_RFA_HEADER_LEN bytes
+ * @param ant The ant to fill
+ */
+void wire_read_reactive_forward_ant(const uint8_t *buf, struct reactive_forward_or_path_repair_ant *ant);
+
+/**
+ * Encodes the fixed part of a reactive backward ant.
+ * @param buf The buffer of at least WIRE_RBA_HEADER_LEN bytes
+ * @param ant The ant
+ * @return WIRE_RBA_HEADER_LEN
+ */
+uint16_t wire_write_reactive_backward_ant(uint8_t *buf, const struct reactive_backward_ant *ant);
+
+/**
+ * Decodes the fixed part of a reactive backward ant; the path is not touched.
+ * @param buf The buffer of at least WIRE_RBA_HEADER_LEN bytes
+ * @param ant The ant to fill
+ */
+void wire_read_reactive_backward_ant(const uint8_t *buf, struct reactive_backward_ant *ant);
+
+/**
+ * Encodes the fixed part of a proactive forward ant.
+ * @param buf The buffer of at least WIRE_PFA_HEADER_LEN bytes
+ * @param ant The ant
+ * @return WIRE_PFA_HEADER_LEN
+ */
+uint16_t wire_write_proactive_forward_ant(uint8_t *buf, const struct proactive_forward_ant *ant);
+
+/**
+ * Decodes the fixed part of a proactive forward ant; the path is not touched.
+ * @param buf The buffer of at least WIRE_PFA_HEADER_LEN bytes
+ * @param ant The ant to fill
+ */
+void wire_read_proactive_forward_ant(const uint8_t *buf, struct proactive_forward_ant *ant);
+
+/**
+ * Encodes a path in its most compact encoding. The path may be in place, i.e. at buf; it is overwritten then.
+ * @param buf The buffer of at least hops * sizeof(uip_ipaddr_t) bytes
+ * @param path The path
+ * @param hops The number of nodes of the path
+ * @param source The source of the ant, its prefix is the prefix of the compressed addresses
+ * @param encoding Set to the encoding that is used
+ * @return The size of the encoded path
+ */
+uint16_t wire_write_path(uint8_t *buf, const uip_ipaddr_t *path, uint8_t hops, const uip_ipaddr_t *source,
+                         wire_path_encoding_t *encoding);
+
+/**
+ * Decodes a path in place into an array of uIP addresses, that starts at buf.
+ * @param buf The buffer with the encoded path
+ * @param len The length of the encoded path, may be longer than the path
+ * @param buf_size The size of the buffer, at least hops * sizeof(uip_ipaddr_t) are needed
+ * @param hops The number of nodes of the path
+ * @param source The source of the ant, its prefix is the prefix of the compressed addresses
+ * @param encoding The encoding of the path
+ * @return False if the path is truncated, doesn't fit into the buffer, or the encoding is unknown
+ */
+bool wire_read_path(uint8_t *buf, uint16_t len, uint16_t buf_size, uint8_t hops, const uip_ipaddr_t *source,
+                    wire_path_encoding_t encoding);
+
+/**
+ * Encodes a hello message with its digest, in the most compact encoding of the destinations of the digest.
+ * @param buf The buffer of at least WIRE_HELLO_HEADER_LEN + digest_size * WIRE_HELLO_ENTRY_MAX_LEN bytes
+ * @param msg The hello message
+ * @param encoding Set to the encoding of the destinations that is used
+ * @return The size of the encoded message
+ */
+uint16_t wire_write_hello_message(uint8_t *buf, const struct hello_message *msg, wire_path_encoding_t *encoding);
+
+/**
+ * Decodes a hello message. The digest is decoded in place, into an array of hello_digest_entry_t that starts at the
+ * first aligned address behind the fixed part; the buffer has to be large enough for that array.
+ * @param buf The buffer with the encoded message
+ * @param len The length of the encoded message
+ * @param buf_size The size of the buffer
+ * @param encoding The encoding of the destinations of the digest
+ * @param msg The hello message to fill, the digest points into buf
+ * @return False if the message is truncated, the encoding is unknown or the digest doesn't fit into the buffer
+ */
+bool wire_read_hello_message(uint8_t *buf, uint16_t len, uint16_t buf_size, wire_path_encoding_t encoding,
+                             struct hello_message *msg);
+
+/**
+ * Returns the number of entries of the digest of a hello message that can be decoded in a buffer.
+ * @param buf_size The size of the buffer
+ * @return The maximal number of entries
+ */
+uint8_t wire_max_hello_digest_entries(uint16_t buf_size);
+
+/**
+ * Encodes a warning message.
+ * @param buf The buffer of at least WIRE_WARNING_LEN bytes
+ * @param msg The warning message
+ * @return WIRE_WARNING_LEN
+ */
+uint16_t wire_write_warning_message(uint8_t *buf, const struct warning_message *msg);
+
+/**
+ * Decodes a warning message.
+ * @param buf The buffer of at least WIRE_WARNING_LEN bytes
+ * @param msg The warning message to fill
+ */
+void wire_read_warning_message(const uint8_t *buf, struct warning_message *msg);
+
+/**
+ * Encodes a link failure notification with all of its entries.
+ * @param buf The buffer of at least WIRE_LFN_HEADER_LEN + size_of_list_of_destinations * WIRE_LFN_ENTRY_LEN bytes
+ * @param lfn The link failure notification
+ * @return The size of the encoded notification
+ */
+uint16_t wire_write_link_failure_notification(uint8_t *buf, const link_failure_notification_t *lfn);
+
+/**
+ * Decodes a link failure notification. The entries are decoded in place, into an array of
+ * link_failure_notification_entry_t that starts at the first aligned address behind the fixed part; the buffer has
+ * to be large enough for that array.
+ * @param buf The buffer with the encoded notification
+ * @param len The length of the encoded notification
+ * @param buf_size The size of the buffer
+ * @param lfn The link failure notification to fill, the entries point into buf
+ * @return False if the notification is truncated or the entries don't fit into the buffer
+ */
+bool wire_read_link_failure_notification(uint8_t *buf, uint16_t len, uint16_t buf_size, link_failure_notification_t *lfn);
+
+/**
+ * Returns the number of entries of a link failure notification that can be decoded in a buffer.
+ * @param buf_size The size of the buffer
+ * @return The maximal number of entries
+ */
+uint8_t wire_max_link_failure_notification_entries(uint16_t buf_size);
+
+#endif //IEEE_802_15_4_ANTNET_ANTHOCNET_WIRE_H
@@ -6,6 +6,16 @@
 
 #include "anthocnet.h"
 #include "anthocnet-pheromone.h"
+#include "anthocnet-node-id.h"
+#include "anthocnet-best-ants.h"
+#include "anthocnet-reverse-routes.h"
+#include "anthocnet-rebroadcast.h"
+#include "anthocnet-packet-buffer.h"
+#include "anthocnet-reroute.h"
+#include "anthocnet-flows.h"
+#include "anthocnet-virtual-pheromone.h"
+#include "anthocnet-fixed-point.h"
+#include "anthocnet-wire.h"
 #include "anthocnet-conf.h"
 #include "../../contiki-ng/os/net/routing/routing.h"
 
@@ -16,10 +26,15 @@
 #include "csma-output.h"
 #endif
 
-#include <math.h>
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
+#include "lib/memb.h"
+#include "lib/list.h"
+#include "sys/cc.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "lib/trickle-timer.h"
 
 #include "anthocnet-icmpv6.h"
 #include "uip-ds6.h"
@@ -35,132 +50,71 @@
 #define LOG_LEVEL LOG_LEVEL_NONE
 #endif
 
+/* max(a, 1/a) of an acceptance factor, so that it can be greater or smaller than 1; evaluated by the compiler */
+#define ACC_FACTOR(a)   ((a) >= 1 ? (double)(a) : 1.0 / (a))
 
-void calc_time_estimate_T_P(float* time_estimate_T_P);
+void calc_time_estimate_T_P(time_estimate_t* time_estimate_T_P);
 void create_reactive_forward_or_path_repair_ant(unsigned int ant_gen, uip_ipaddr_t destination, packet_type_t type_of_ant);
 void broadcast_link_failure_notification(link_failure_notification_t link_failure_notification);
-void delete_neighbour_from_best_ant_array(uip_ipaddr_t neighbour_address);
 void create_and_send_proactive_forward_ant(uip_ipaddr_t destination);
-void delete_last_destination_data_array();
-void discard_buffer();
 void send_multicast_message(int icmp_type, uip_ipaddr_t next_hop, int len);
 
 static bool initialized = false;
 static bool hello_message_broadcasting = false;
 static bool acceptance_messages = false;
-static float running_average_T_i_mac;
-static unsigned int ant_generation;
-static best_ants_t *best_ants;
+static time_estimate_t running_average_T_i_mac;
+static uint16_t ant_generation;                 // 16 bits, as on the air
+static uint16_t proactive_ant_generation;       // generation of the proactive forward ants
+static uint16_t link_failure_notification_number;   // number of the link failure notifications of this node
 static uip_ipaddr_t host_addr;
 static uip_ipaddr_t uip_zeroes_addr;
-static last_package_data_t last_package_data;
-static last_destination_data_t *last_destination_data;
-static buffer_t buffer;
 static uip_ipaddr_t multicast_addr;
+#if ANT_HOC_NET_HELLO_TRICKLE
+static struct trickle_timer hello_trickle_timer;
+#endif
+static struct ctimer hello_loss_sweep_timer;    // one timer evaluates the hello loss of all neighbours
+static clock_time_t hello_loss_sweep_time;      // when the sweep timer expires
+static struct ctimer hello_retry_timer;         // sends the hello message, that waited for a packet in uip_buf
+#if ANT_HOC_NET_HELLO_SUPPRESSION
+static clock_time_t last_broadcast;             // when this node broadcast the last packet, it reached all neighbours
+static clock_time_t advertised_hello_interval = PHEROMONE_DEFAULT_HELLO_INTERVAL;   // interval of the last hello
+static struct ctimer hello_deferral_timer;      // sends a deferred hello message, when the frames got too old
+static uint8_t deferred_hellos = 0;             // number of hello messages deferred in a row
+#endif
 
 /*----Start-Processes-------------------------------------------------------------------------------------------------*/
+#if !ANT_HOC_NET_HELLO_TRICKLE
 PROCESS(broadcast_hello_messages_proc, "Broadcast Hello Messages Process");
-PROCESS(reactive_path_setup_proc, "Reactive Path Setup Process");
-PROCESS(data_transmission_failed_proc, "Data Transmission Failed");
+#endif
+PROCESS(path_setup_proc, "Path Setup Process");
+PROCESS(proactive_maintenance_proc, "Proactive Maintenance Process");
+
+MEMB(path_setups_memb, path_setup_t, ANT_HOC_NET_MAX_PATH_SETUPS);
+LIST(path_setups_list);
+
+static void path_setup_timer_expired(path_setup_t *path_setup);
 
 /*
- * Process that handles the reactive path setup.
- * Sends reactive forward ant, and waits till a backward ant arrives.
- * If the ant doesn't arrive in ANT_HOC_NET_RESTART_PATH_SETUP_SECS seconds, another ant is sent.
- * The process repeats the path setup, if not successful, ANT_HOC_NET_MAX_TRIES_PATH_SETUP times.
+ * Process that drives the path setups of all destinations.
+ * Each path setup has its own timer, bound to this process; the process only dispatches the expired timers.
  */
-PROCESS_THREAD(reactive_path_setup_proc, ev, data) {
-    static int try_counter;
-    static unsigned int ant_gen;
-    static struct etimer timer;
-    static uip_ipaddr_t destination;
-
+PROCESS_THREAD(path_setup_proc, ev, data) {
     PROCESS_BEGIN();
-    try_counter = 0;
-    ant_gen = 0;
-
-    packet_buffer_t *new_packet = malloc(sizeof(packet_buffer_t));
-    if (!new_packet) {
-        LOG_ERR("Failed to allocate new packet");
-        PROCESS_EXIT();
-    }
-    if (uip_len <= 0)
-    {
-        LOG_ERR("uIP len was 0, cannot buffer empty packet");
-        free(new_packet);
-        PROCESS_EXIT();
-    }
-    new_packet->buffer = malloc(sizeof(unsigned char) * uip_len);
-    if (!new_packet->buffer) {
-        LOG_ERR("Failed to allocate buffer for new packet");
-        free(new_packet);
-        PROCESS_EXIT();
-    }
-    new_packet->len = uip_len;
-    new_packet->next = NULL;
-    // put the packet at the end of the buffer
-    packet_buffer_t *current_packet = buffer.packet_buffer;
-    if (current_packet == NULL) {
-        buffer.packet_buffer = new_packet;
-    } else {
-        while (current_packet->next != NULL)
-        {
-            current_packet = current_packet->next;
+    LOG_INFO("Path setup process started\n");
+
+    while (1) {
+        PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+        for (path_setup_t *path_setup = list_head(path_setups_list); path_setup != NULL; path_setup = list_item_next(path_setup)) {
+            if (data == &path_setup->timer) {
+                path_setup_timer_expired(path_setup);
+                break;
+            }
         }
-        current_packet->next = new_packet;
     }
-
-    memcpy(new_packet->buffer, &uip_buf, new_packet->len);
-
-    ++buffer.number_of_packets;
-    buffer.valid = true;
-    memcpy(&destination, data, sizeof(uip_ipaddr_t));
-
-    LOG_INFO("Reactive path setup process started\n");
-
-    LOG_DBG("Create ant with destination ");
-    LOG_DBG_6ADDR(&destination);
-    LOG_DBG_("\n");
-
-    try_counter++;
-    // remember ant generation for the backward ant
-    ant_gen = ++ant_generation;
-    // send reactive forward ant
-    LOG_DBG("Sending reactive forward ant\n");
-    create_reactive_forward_or_path_repair_ant(ant_gen, destination, REACTIVE_FORWARD_ANT);
-
-    // set timer
-    etimer_set(&timer, ANT_HOC_NET_RESTART_PATH_SETUP_SECS * CLOCK_SECOND);
-
-    do {
-        // wait until an event is received
-        PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&timer));
-        try_counter++;
-
-        // save ant gen for backward ant
-        ant_gen = ++ant_generation;
-
-        // send reactive forward ant
-        LOG_DBG("No ant came back, Sending reactive forward ant\n");
-        create_reactive_forward_or_path_repair_ant(ant_gen, destination, REACTIVE_FORWARD_ANT);
-        LOG_DBG("Ant was sent; destination address is: ");
-        LOG_DBG_6ADDR(&destination);
-        LOG_DBG_("\n");
-
-        // set timer
-        etimer_reset(&timer);
-        LOG_DBG("Destination address is: ");
-        LOG_DBG_6ADDR(&destination);
-        LOG_DBG_("\n");
-
-    } while (try_counter <= ANT_HOC_NET_MAX_TRIES_PATH_SETUP);
-    // no backward ant was received -> discard saved package
-    LOG_DBG("No backward ant was received -> discard saved package\n");
-    discard_buffer();
-
     PROCESS_END();
 }
 
+#if !ANT_HOC_NET_HELLO_TRICKLE
 /*
  * Process that send hello messages every ANT_HOC_NET_T_HELLO_SEC seconds.
  */
@@ -181,125 +135,152 @@ PROCESS_THREAD(broadcast_hello_messages_proc, ev, data) {
     PROCESS_END();
     LOG_INFO("Hello messages broadcasting process ended\n");
 }
+#endif
 
-/*
- * Process that handles the failure while a data transmission
- */
-PROCESS_THREAD(data_transmission_failed_proc, ev, data) {
-    static struct etimer timer;
+/*----End-Processes---------------------------------------------------------------------------------------------------*/
 
-    static uip_ipaddr_t destination;
-    static uip_ipaddr_t neighbour;
+/*----General-Functions-----------------------------------------------------------------------------------------------*/
 
-    PROCESS_BEGIN();
+int accept_messages() {
+    return acceptance_messages;
+}
 
-    memcpy(&destination, data, sizeof(uip_ipaddr_t));
-    memcpy(&neighbour, data + sizeof(uip_ipaddr_t), sizeof(uip_ipaddr_t));
+static path_setup_t *find_path_setup(const uip_ipaddr_t *destination) {
+    for (path_setup_t *path_setup = list_head(path_setups_list); path_setup != NULL; path_setup = list_item_next(path_setup)) {
+        if (uip_ipaddr_cmp(&path_setup->destination, destination)) {
+            return path_setup;
+        }
+    }
+    return NULL;
+}
 
-    float *estimated_time = get_pheromone_value(neighbour, destination);
+static path_setup_t *find_path_setup_of_generation(const uip_ipaddr_t *destination, uint16_t ant_generation) {
+    for (path_setup_t *path_setup = list_head(path_setups_list); path_setup != NULL; path_setup = list_item_next(path_setup)) {
+        // the generations are counted per source, so the same generation may come back from another destination
+        if (path_setup->ant_generation == ant_generation && uip_ipaddr_cmp(&path_setup->destination, destination)) {
+            return path_setup;
+        }
+    }
+    return NULL;
+}
 
-    // to be safe, that should not happen, since the neighbour is not yet deleted
-    if (estimated_time == NULL) {
-        PROCESS_EXIT();
+/**
+ * Takes a new path setup of a destination from the pool; its timer is started in the path setup process, which is
+ * started if necessary.
+ * @param destination The destination of the path setup
+ * @param interval The time in clock ticks until the timer expires
+ * @return The path setup, or NULL if too many path setups are running
+ */
+static path_setup_t *start_path_setup(const uip_ipaddr_t *destination, clock_time_t interval) {
+    path_setup_t *path_setup = memb_alloc(&path_setups_memb);
+    if (path_setup == NULL) {
+        LOG_WARN("Too many path setups running - path setup to ");
+        LOG_WARN_6ADDR(destination);
+        LOG_WARN_(" is not started!\n");
+        return NULL;
     }
+    memset(path_setup, 0, sizeof(path_setup_t));
+    path_setup->destination = *destination;
+    list_add(path_setups_list, path_setup);
 
-    // calculate seconds to wait, according to the paper
-    unsigned long seconds = (unsigned long) (CLOCK_SECOND * ANT_HOC_NET_FACTOR_OF_WAITING_TIME_BRA * (*estimated_time));
+    if (!process_is_running(&path_setup_proc)) {
+        process_start(&path_setup_proc, NULL);
+    }
+    PROCESS_CONTEXT_BEGIN(&path_setup_proc);
+    etimer_set(&path_setup->timer, interval);
+    PROCESS_CONTEXT_END(&path_setup_proc);
+    return path_setup;
+}
 
-    // broadcast path repair ant like a reactive forward ant
-    ++ant_generation;
-    create_reactive_forward_or_path_repair_ant(ant_generation, destination, PATH_REPAIR_ANT);
+static void free_path_setup(path_setup_t *path_setup) {
+    etimer_stop(&path_setup->timer);
+    list_remove(path_setups_list, path_setup);
+    memb_free(&path_setups_memb, path_setup);
+}
 
-    etimer_set(&timer, seconds);
+/**
+ * Handles the expired timer of a path setup.\n
+ * A reactive path setup sends another forward ant, it is repeated ANT_HOC_NET_MAX_TRIES_PATH_SETUP times before the
+ * buffered packets are discarded. A path repair discards the buffered packets at once and handles the neighbour as
+ * disappeared.
+ * @param path_setup The path setup
+ */
+static void path_setup_timer_expired(path_setup_t *path_setup) {
+    if (path_setup->path_repair) {
+        uip_ipaddr_t neighbour = path_setup->neighbour;
+        discard_buffered_packets(&path_setup->buffer);
+        free_path_setup(path_setup);
+        // if no BRA ant is received in that time, send a link failure notification
+        neighbour_node_has_disappeared(neighbour);
+        return;
+    }
 
-    while (1) {
-        PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&timer));
-            discard_buffer();
-            // if no BRA ant is received in that time, send a link failure notification
-            neighbour_node_has_disappeared(neighbour);
-            PROCESS_EXIT();
+    if (path_setup->try_counter > ANT_HOC_NET_MAX_TRIES_PATH_SETUP) {
+        // no backward ant was received -> discard saved package
+        LOG_DBG("No backward ant was received -> discard saved package\n");
+        discard_buffered_packets(&path_setup->buffer);
+        free_path_setup(path_setup);
+        return;
     }
 
-    PROCESS_END();
-}
+    path_setup->try_counter++;
+    // save ant gen for backward ant
+    path_setup->ant_generation = ++ant_generation;
 
-/*----End-Processes---------------------------------------------------------------------------------------------------*/
+    LOG_DBG("No ant came back, Sending reactive forward ant to ");
+    LOG_DBG_6ADDR(&path_setup->destination);
+    LOG_DBG_("\n");
+    create_reactive_forward_or_path_repair_ant(path_setup->ant_generation, path_setup->destination, REACTIVE_FORWARD_ANT);
 
-/*----General-Functions-----------------------------------------------------------------------------------------------*/
+    PROCESS_CONTEXT_BEGIN(&path_setup_proc);
+    etimer_reset(&path_setup->timer);
+    PROCESS_CONTEXT_END(&path_setup_proc);
+}
 
-int accept_messages() {
-    return acceptance_messages;
+bool path_setup_running(uip_ipaddr_t destination) {
+    return find_path_setup(&destination) != NULL;
 }
 
-int processes_running() {
-    return process_is_running(&reactive_path_setup_proc) || process_is_running(&data_transmission_failed_proc);
+int number_of_buffered_packets(uip_ipaddr_t destination) {
+    path_setup_t *path_setup = find_path_setup(&destination);
+    return path_setup == NULL ? 0 : path_setup->buffer.number_of_packets;
 }
 
-void stop_reactive_path_setup_and_data_transmission_failed_process() {
-    process_exit(&reactive_path_setup_proc);
-    process_exit(&data_transmission_failed_proc);
+bool path_setup_waits_for_generation(uip_ipaddr_t destination, uint16_t ant_generation) {
+    return find_path_setup_of_generation(&destination, ant_generation) != NULL;
 }
 
-void send_buffered_data_packages() {
-    LOG_INFO("Backward ant is at its destination! Send buffered packages!\n");
-    if (buffer.valid)
-    {
-        int buffer_len = buffer.number_of_packets;
-        for (int i = 0; i < buffer_len; ++i) {
-            if (buffer.packet_buffer->buffer != NULL) {
-                if (buffer.packet_buffer->buffer != NULL && buffer.packet_buffer->len > 0) {
-                    LOG_INFO("Send message of length %d\n", buffer.packet_buffer->len);
-                    uip_len = buffer.packet_buffer->len;
-                    memcpy(&uip_buf, buffer.packet_buffer->buffer, buffer.packet_buffer->len);
-                    tcpip_ipv6_output();
-                }
-
-                --buffer.number_of_packets;
-                packet_buffer_t *temp = buffer.packet_buffer;
-                buffer.packet_buffer = buffer.packet_buffer->next;
-                if (temp != NULL) {
-                    if (temp->buffer != NULL) {
-                        free(temp->buffer);
-                        temp->buffer = NULL;
-                    }
-                    if (temp != NULL) {
-                        free(temp);
-                    }
-                }
-            }
-        }
-        if (buffer.number_of_packets == 0) {
-            buffer.packet_buffer = NULL;
-            buffer.valid = false;
-        }
-        // if the length is not 0 then new packages were put into the queue
-        // thus the buffer is not invalid
+void finish_path_setup(uip_ipaddr_t destination, uint16_t ant_generation, time_estimate_t time_estimate_T_P) {
+    path_setup_t *path_setup = find_path_setup_of_generation(&destination, ant_generation);
+    if (path_setup == NULL) {
+        return;
     }
+    LOG_INFO("Backward ant is at its destination! Send buffered packages!\n");
+    // the path setup is freed first, a packet that finds no path when it is sent starts a new path setup
+    buffer_t buffer = path_setup->buffer;
+    free_path_setup(path_setup);
+
+#if ANT_HOC_NET_PACED_RELEASE == 1
+    // a burst per time estimate of the new path, including the time of this node, but at least one burst per second
+    calc_time_estimate_T_P(&time_estimate_T_P);
+    clock_time_t interval = (clock_time_t) REAL_SCALE_TO_INT(time_estimate_T_P, CLOCK_SECOND);
+    release_buffered_packets(&buffer, MAX(1, MIN(interval, CLOCK_SECOND)));
+#elif ANT_HOC_NET_PACED_RELEASE == 2
+    // the MAC queue is checked every average MAC sending time
+    clock_time_t interval = (clock_time_t) REAL_SCALE_TO_INT(running_average_T_i_mac, CLOCK_SECOND);
+    release_buffered_packets(&buffer, MAX(1, MIN(interval, CLOCK_SECOND)));
+#else
+    send_buffered_packets(&buffer);
+#endif
 }
 
-/**
- * Discards the buffered packets.
- */
-void discard_buffer() {
-    if (buffer.valid) {
-        packet_buffer_t *packet_buffer = buffer.packet_buffer;
-        while (packet_buffer != NULL) {
-            packet_buffer_t *temp = packet_buffer;
-            packet_buffer = packet_buffer->next;
-            if (temp != NULL) {
-                if (temp->buffer != NULL) {
-                    free(temp->buffer);
-                    temp->buffer = NULL;
-                }
-                free(temp);
-                temp = NULL;
-            }
-        }
-        buffer.packet_buffer = NULL;
-        buffer.number_of_packets = 0;
-        buffer.valid = false;
+void stop_path_setups() {
+    while (list_head(path_setups_list) != NULL) {
+        path_setup_t *path_setup = list_head(path_setups_list);
+        discard_buffered_packets(&path_setup->buffer);
+        free_path_setup(path_setup);
     }
-    LOG_INFO("Buffer discarded!\n");
+    process_exit(&path_setup_proc);
 }
 
 unsigned int get_current_ant_generation() {
@@ -309,6 +290,69 @@ unsigned int get_current_ant_generation() {
 uip_ipaddr_t get_host_address() {
     return host_addr;
 }
+
+/**
+ * Writes an ant into the ICMPv6 payload of uip_buf and compresses its path. The path is only copied if it is not in
+ * place already, as it is the case for ants that are forwarded from uip_buf.
+ * @param header The encoded fixed part of the ant
+ * @param header_len The size of the encoded fixed part
+ * @param path The path of the ant, may be NULL if hops is 0
+ * @param hops The number of elements of the path
+ * @param source The address the path is compressed against, the receiver has to know it from the fixed part
+ * @param code Set to the ICMPv6 code the ant has to be sent with
+ * @return The length of the payload, 0 if the ant doesn't fit into uip_buf
+ */
+static uint16_t write_ant_payload(const void *header, uint16_t header_len, const uip_ipaddr_t *path, hop_t hops,
+                                  const uip_ipaddr_t *source, uint8_t *code) {
+    // the receiver expands the path in its uip_buf, so the uncompressed path has to fit
+    if (header_len + hops * sizeof(uip_ipaddr_t) > ICMP6_ANT_MAX_PAYLOAD_LEN) {
+        return 0;
+    }
+    // the path is moved first, it may overlap the position of the header
+    uip_ipaddr_t *path_in_uip_buf = (uip_ipaddr_t *) (ICMP6_ANT_PAYLOAD + header_len);
+    if (hops > 0 && path != path_in_uip_buf) {
+        memmove(path_in_uip_buf, path, hops * sizeof(uip_ipaddr_t));
+    }
+    wire_path_encoding_t encoding;
+    uint16_t path_len = wire_write_path(ICMP6_ANT_PAYLOAD + header_len, path_in_uip_buf, hops, source, &encoding);
+    memcpy(ICMP6_ANT_PAYLOAD, header, header_len);
+    *code = WIRE_CODE(encoding);
+    return header_len + path_len;
+}
+
+/**
+ * Appends the host address to the path of an ant. The path is put behind the fixed part of the ant in uip_buf; the
+ * path of a received ant is already there, thus only the host address is written. If the ant only carries a window of
+ * its path, the host address replaces the last node of the window.
+ * @param path The path of the ant, may be NULL if hops is 0
+ * @param hops The number of hops of the ant before this node
+ * @param header_len The size of the fixed part of the ant
+ * @return The path with the host address in uip_buf, NULL if it doesn't fit
+ */
+static uip_ipaddr_t *append_host_to_path(const uip_ipaddr_t *path, hop_t hops, uint16_t header_len) {
+    hop_t elements = WIRE_PATH_ELEMENTS(hops);
+    hop_t host_element = WIRE_PATH_ELEMENTS(hops + 1) - 1;
+    if (host_element + 1 > (ICMP6_ANT_MAX_PAYLOAD_LEN - header_len) / sizeof(uip_ipaddr_t)) {
+        return NULL;
+    }
+    uip_ipaddr_t *path_in_uip_buf = (uip_ipaddr_t *) (ICMP6_ANT_PAYLOAD + header_len);
+    if (elements > 0 && path != path_in_uip_buf) {
+        memmove(path_in_uip_buf, path, elements * sizeof(uip_ipaddr_t));
+    }
+    path_in_uip_buf[host_element] = host_addr;
+    return path_in_uip_buf;
+}
+
+/**
+ * Returns the node an ant was received from, the last node of its path or the source if the path is empty.
+ * @param path The path of the ant, may be NULL if hops is 0
+ * @param hops The number of hops of the ant before this node
+ * @param source The source of the ant
+ * @return The node the ant was received from
+ */
+static uip_ipaddr_t get_previous_hop(const uip_ipaddr_t *path, hop_t hops, const uip_ipaddr_t *source) {
+    return hops == 0 ? *source : path[WIRE_PATH_ELEMENTS(hops) - 1];
+}
 /*
 void send_multicast_message(int icmp_type, uip_ipaddr_t next_hop, int len) {
 
@@ -368,40 +412,42 @@ void send_multicast_message(int icmp_type, uip_ipaddr_t next_hop, int len) {
  * This function corresponds to the equations (3) and (2) of the AntHocNet paper.
  * @param time_estimate_T_P The time estimate of the ant, which is going to be updated
  */
-void calc_time_estimate_T_P(float* time_estimate_T_P) {
+void calc_time_estimate_T_P(time_estimate_t* time_estimate_T_P) {
 
     if (time_estimate_T_P == NULL) {
         LOG_ERR("Time estimate is NULL!\n");
         return;
     }
-    int Q_i_mac = 0;
-
-#if MAC_CONF_WITH_TSCH
-    // get all packages in all TSCH queues and assigned them to the Q_i_mac
-    Q_i_mac = tsch_queue_global_packet_count();
-#elif MAC_CONF_WITH_CSMA
-    Q_i_mac = get_packet_count();
-#else
-#error Only CSMA or TSCH are supported, whereas CSMA should be selected for cooja simulations / when the minimal tsch is used
-#endif
+    int Q_i_mac = mac_queue_length();
 
     /* running average is updated every time a packet is sent
-        float time_t_i_mac = (float)0.0;
-        update_running_average_T_i_mac(time_t_i_mac);
+        update_running_average_T_i_mac(0);
     */
 
     // equation (3) in AntHocNet paper; product of the average time to send one packet running_average_T_i_mac and the current
     // number of packets in the queue
-    float product_of_avg_mac_time = (float)(Q_i_mac + 1) * running_average_T_i_mac;
+    time_estimate_t product_of_avg_mac_time = (time_estimate_t)(Q_i_mac + 1) * running_average_T_i_mac;
 
     // equation (2) in AntHocNet paper
     *time_estimate_T_P += product_of_avg_mac_time;
 }
 
-void update_running_average_T_i_mac(float new_time_t_i_mac) {
+int mac_queue_length() {
+#if MAC_CONF_WITH_TSCH
+    // get all packages in all TSCH queues
+    return tsch_queue_global_packet_count();
+#elif MAC_CONF_WITH_CSMA
+    return get_packet_count();
+#else
+#error Only CSMA or TSCH are supported, whereas CSMA should be selected for cooja simulations / when the minimal tsch is used
+#endif
+}
+
+void update_running_average_T_i_mac(clock_time_t new_time_t_i_mac) {
     // equation (4)
-    running_average_T_i_mac = ANT_HOC_NET_ALPHA * running_average_T_i_mac + (1 - ANT_HOC_NET_ALPHA) * (new_time_t_i_mac/ (float)CLOCK_SECOND);
-    LOG_DBG("Running average T_i_mac updated to: %f\n", running_average_T_i_mac);
+    running_average_T_i_mac = REAL_MUL(REAL_CONST(ANT_HOC_NET_ALPHA), running_average_T_i_mac)
+            + REAL_MUL(REAL_CONST(1 - ANT_HOC_NET_ALPHA), REAL_FROM_FRACTION(new_time_t_i_mac, CLOCK_SECOND));
+    LOG_DBG("Running average T_i_mac updated to: %f\n", REAL_TO_FLOAT(running_average_T_i_mac));
 }
 
 void send_reactive_forward_or_path_repair_ant(bool broadcast, uip_ipaddr_t next_hop, struct reactive_forward_or_path_repair_ant ant) {
@@ -424,19 +470,27 @@ void send_reactive_forward_or_path_repair_ant(bool broadcast, uip_ipaddr_t next_
     char *broadcast_str = broadcast ? "broadcast" : "unicast";
     LOG_INFO_(" as %s\n", broadcast_str);
 
-    // copy the first 7 fields
-    uint16_t size_counter = sizeof(ant) - sizeof(uip_ipaddr_t *);
-    memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN], &ant, size_counter);
-
-    // copy the whole path
-    if (ant.hops >= 1  && ant.path != NULL) {
-        memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN + size_counter], ant.path, ant.hops * sizeof(uip_ipaddr_t));
-        size_counter += ant.hops * sizeof(uip_ipaddr_t);
+    // the path is only copied if the ant is not forwarded from uip_buf
+    uint8_t header[WIRE_RFA_HEADER_LEN];
+    uint8_t code;
+    wire_write_reactive_forward_ant(header, &ant);
+    uint16_t size_counter = write_ant_payload(header, WIRE_RFA_HEADER_LEN, ant.path,
+                                              ant.path == NULL ? 0 : WIRE_PATH_ELEMENTS(ant.hops), &ant.source, &code);
+    if (size_counter == 0) {
+        LOG_WARN("Ant does not fit into uip_buf - ant is killed!\n");
+        return;
     }
     /*if (broadcast) {
         send_multicast_message(ICMP6_REACTIVE_FORWARD_ANT, next_hop, size_counter);
     } else {*/
-        uip_icmp6_send(&next_hop, ICMP6_REACTIVE_FORWARD_ANT, ant.ant_type, size_counter);
+    if (broadcast && !uip_ipaddr_cmp(&ant.source, &host_addr)) {
+        // relayed broadcasts are delayed and may be suppressed, see anthocnet-rebroadcast.h
+        schedule_rebroadcast(&next_hop, ICMP6_REACTIVE_FORWARD_ANT, code, size_counter,
+                             rebroadcast_key(ICMP6_REACTIVE_FORWARD_ANT, &ant.source, ant.ant_generation),
+                             ant.time_estimate_T_P, true);
+    } else {
+        uip_icmp6_send(&next_hop, ICMP6_REACTIVE_FORWARD_ANT, code, size_counter);
+    }
    // }
 }
 
@@ -463,15 +517,132 @@ void create_reactive_forward_or_path_repair_ant(unsigned int ant_gen, uip_ipaddr
     // The source node is not in the path
     ant.path = NULL;
     // Source time estimate is not part of the time estimate of the ant
-    ant.time_estimate_T_P = (float)0.0;
+    ant.time_estimate_T_P = REAL_CONST(0.0);
     // Set the ant type
     ant.ant_type = type_of_ant;
     // Set the number of broadcasts
     ant.number_broadcasts = 0;
+    // no node answered the ant yet
+    ant.replied = false;
 
     send_reactive_forward_or_path_repair_ant(true, uip_zeroes_addr, ant);
 }
 
+#if ANT_HOC_NET_INTERMEDIATE_REPLY
+/**
+ * Checks whether this node may answer a reactive forward ant in place of its destination, i.e. whether its best path to
+ * the destination is strong and was updated by an ant within ANT_HOC_NET_INTERMEDIATE_REPLY_MAX_AGE_SEC, and doesn't
+ * lead back over a node the ant has passed.
+ * @param ant The forward ant, this node is the last node of its path
+ * @param previous_hop The node the ant was received from
+ * @param remaining_time Is set to the time estimate of the path from this node to the destination
+ * @param remaining_hops Is set to the number of hops of the path from this node to the destination
+ * @return True if the node may answer the ant
+ */
+static bool find_intermediate_reply_path(const struct reactive_forward_or_path_repair_ant *ant,
+                                         const uip_ipaddr_t *previous_hop, time_estimate_t *remaining_time,
+                                         hop_t *remaining_hops) {
+    uip_ipaddr_t neighbour;
+    pheromone_t pheromone_value;
+    hop_t hops;
+    clock_time_t last_ant;
+    if (!get_best_path(ant->destination, &neighbour, &pheromone_value, &hops, &last_ant)
+        || pheromone_value < REAL_CONST(ANT_HOC_NET_INTERMEDIATE_REPLY_MIN_PHEROMONE)
+        || clock_time() - last_ant > (clock_time_t)(ANT_HOC_NET_INTERMEDIATE_REPLY_MAX_AGE_SEC * CLOCK_SECOND)) {
+        return false;
+    }
+
+    // a path back over the nodes the ant came from would be a loop
+    if (uip_ipaddr_cmp(&neighbour, previous_hop) || uip_ipaddr_cmp(&neighbour, &ant->source)) {
+        return false;
+    }
+    for (int i = 0; i < WIRE_PATH_ELEMENTS(ant->hops); ++i) {
+        if (uip_ipaddr_cmp(&neighbour, &ant->path[i])) {
+            return false;
+        }
+    }
+
+    // the stored hops of a path count from the neighbour on, except for a neighbour that is the destination itself
+    *remaining_hops = uip_ipaddr_cmp(&neighbour, &ant->destination) ? 1 : hops + 1;
+    if (ant->hops + *remaining_hops > ANT_HOC_NET_MAX_HOPS) {
+        return false;
+    }
+    *remaining_time = calc_time_estimate_of_pheromone(pheromone_value, *remaining_hops);
+    return true;
+}
+
+/**
+ * Answers a reactive forward ant in place of its destination with a backward ant. The backward ant starts at this
+ * node as if it had come from the destination: its path begins with the destination, repeated for the remaining hops,
+ * so that the nodes on the way back count the hops of the whole path.
+ * @param ant The forward ant, this node is the last node of its path
+ * @param previous_hop The node the ant was received from
+ * @param remaining_time The time estimate of the path from this node to the destination
+ * @param remaining_hops The number of hops of the path from this node to the destination
+ */
+static void send_intermediate_backward_ant(const struct reactive_forward_or_path_repair_ant *ant,
+                                           const uip_ipaddr_t *previous_hop, time_estimate_t remaining_time,
+                                           hop_t remaining_hops) {
+    uip_ipaddr_t *reversed_path = (uip_ipaddr_t *) (ICMP6_ANT_PAYLOAD + WIRE_RBA_HEADER_LEN);
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+    // the window holds the destination as origin and this node as the last node passed
+    uip_ipaddr_t next_hop = *previous_hop;
+    reversed_path[0] = ant->destination;
+    reversed_path[WIRE_PATH_WINDOW - 1] = host_addr;
+    hop_t length = WIRE_PATH_WINDOW;
+#else
+    hop_t length = remaining_hops + ant->hops;
+    if (length > (ICMP6_ANT_MAX_PAYLOAD_LEN - WIRE_RBA_HEADER_LEN) / sizeof(uip_ipaddr_t)) {
+        LOG_WARN("Path does not fit into uip_buf - no backward ant is sent!\n");
+        return;
+    }
+
+    // move the path of the forward ant behind the padding of the destination, then reverse it in place
+    uip_ipaddr_t *path = reversed_path + remaining_hops;
+    memmove(path, ant->path, ant->hops * sizeof(uip_ipaddr_t));
+    for (int i = 0; i < ant->hops / 2; i++) {
+        uip_ipaddr_t temp = path[i];
+        path[i] = path[(ant->hops - 1) - i];
+        path[(ant->hops - 1) - i] = temp;
+    }
+    for (int i = 0; i < remaining_hops; i++) {
+        reversed_path[i] = ant->destination;
+    }
+    uip_ipaddr_t next_hop = ant->hops >= 2 ? path[1] : ant->source;
+#endif
+
+    struct reactive_backward_ant rba = {
+            .ant_type = BACKWARD_ANT,
+            .ant_generation = ant->ant_generation,
+            .proactive = false,
+            .destination = ant->source,
+            .path = reversed_path,
+            .length = length,
+            .time_estimate_T_P = remaining_time,
+            .current_hop = remaining_hops,
+    };
+
+    if (!does_neighbour_exists(next_hop)) {
+        LOG_DBG("Neighbour ");
+        LOG_DBG_6ADDR(&next_hop);
+        LOG_DBG_(" is not reachable, since it doesn't exist anymore!\n");
+        return;
+    }
+
+    LOG_INFO("Backward ant sent in place of ");
+    LOG_INFO_6ADDR(&ant->destination);
+    LOG_INFO_(" with destination: ");
+    LOG_INFO_6ADDR(&rba.destination);
+    LOG_INFO_(", %u hops remaining\n", remaining_hops);
+
+    uint8_t header[WIRE_RBA_HEADER_LEN];
+    uint8_t code;
+    wire_write_reactive_backward_ant(header, &rba);
+    uint16_t size_counter = write_ant_payload(header, WIRE_RBA_HEADER_LEN, rba.path, rba.length, &rba.destination, &code);
+    uip_icmp6_send(&next_hop, ICMP6_REACTIVE_BACKWARD_ANT, code, size_counter);
+}
+#endif /* ANT_HOC_NET_INTERMEDIATE_REPLY */
+
 void reception_reactive_forward_or_path_repair_ant(struct reactive_forward_or_path_repair_ant ant) {
     LOG_DBG("Reactive forward ant or path repair ant received!\n");
 
@@ -479,59 +650,45 @@ void reception_reactive_forward_or_path_repair_ant(struct reactive_forward_or_pa
     if (uip_ipaddr_cmp(&ant.source, &host_addr)) {
         LOG_DBG("Host is source node! - Ignore ant!\n");
         // ignore ant when node is the source and gets it back
-        if (ant.path != NULL) {
-            free(ant.path);
-            ant.path = NULL;
-        }
         return;
     }
 
-    for (int i = 0; i < ant.hops; ++i) {
+    for (int i = 0; i < WIRE_PATH_ELEMENTS(ant.hops); ++i) {
         LOG_DBG("ant.path[%d]: ", i);
         LOG_DBG_6ADDR(&ant.path[i]);
         LOG_DBG_("\n");
         if (uip_ipaddr_cmp(&host_addr, &ant.path[i])) {
             LOG_DBG("Host is in path -> ant already visited this node -> probably received from a broadcast!\n");
-            if (ant.path != NULL) {
-                free(ant.path);
-                ant.path = NULL;
-            }
             return;
         }
     }
 
+    uip_ipaddr_t previous_hop = get_previous_hop(ant.path, ant.hops, &ant.source);
     ant.hops++;
 
     // check if the maximum of the hops is reached if so discard ant before computing it further
     if (ant.hops > ANT_HOC_NET_MAX_HOPS) {
         LOG_DBG("Max hops reached!\n");
-        if (ant.path != NULL) {
-            free(ant.path);
-            ant.path = NULL;
-        }
         return;
     }
 
-    // add node to the path (even if it's the destination)
-    uip_ipaddr_t *new_path = malloc(ant.hops * sizeof(uip_ipaddr_t));
-
-    if (ant.path != NULL) {
-        // copy old elements, thus - 1
-        memcpy(new_path, ant.path, (ant.hops - 1) * sizeof(uip_ipaddr_t));
-        new_path[ant.hops - 1] = host_addr;
-        free(ant.path);
-        ant.path = new_path;
-    } else {
-        // path is null, thus path[0] can be the host addr
-        ant.path = new_path;
-        ant.path[0] = host_addr;
+    // add node to the path (even if it's the destination); a received ant is extended in place in uip_buf
+    ant.path = append_host_to_path(ant.path, ant.hops - 1, WIRE_RFA_HEADER_LEN);
+    if (ant.path == NULL) {
+        LOG_WARN("Path does not fit into uip_buf - ant is killed!\n");
+        return;
     }
 
     // Node is destination, then send backward ant
     if (uip_ipaddr_cmp(&ant.destination, &host_addr)) {
         LOG_DBG("Destination reached!\n");
         LOG_INFO("Length of path of forward ant at destination: %d\n", ant.hops);
-        create_and_send_backward_ant(ant.ant_generation, ant.hops, ant.path, ant.source);
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+        // the backward ant is sent back to the node the forward ant came from
+        create_and_send_backward_ant(ant.ant_generation, false, ant.hops, &previous_hop, ant.source);
+#else
+        create_and_send_backward_ant(ant.ant_generation, false, ant.hops, ant.path, ant.source);
+#endif
         return;
     }
 
@@ -545,191 +702,123 @@ void reception_reactive_forward_or_path_repair_ant(struct reactive_forward_or_pa
     // ant is accepted if its estimated time is in the range of the best ant with the acceptance factor a2.
     // Atm the decision is made without respect to the hop count.
 
-    best_ants_t *current_best_ants = best_ants;
-    best_ants_t *last_best_ants = NULL;
-
-    // select best_ants_t enty where the address is the same as from the source of the ant
-    while (current_best_ants != NULL) {
-        if (uip_ipaddr_cmp(&current_best_ants->source, &ant.source)) {
-            break;
-        }
-        last_best_ants = current_best_ants;
-        current_best_ants = current_best_ants->next;
-    }
-
-    if (current_best_ants == NULL) {
-        LOG_DBG("No best ant exists or no entry where the addresses are the same are found\n");
-        // no best ant exists or no entry where the addresses are the same are found
-        // create a new best_ant
-        best_ants_t *new_best_ants = (best_ants_t*) malloc(sizeof(best_ants_t));
-        new_best_ants->source = ant.source;
-        new_best_ants->best_ants_per_generation_array = malloc(sizeof(best_ant_t));
-        new_best_ants->next = NULL;
-
-        // create new best ant array
-        new_best_ants->best_ants_per_generation_array->generation = ant.ant_generation;
-        new_best_ants->best_ants_per_generation_array->hop_count = ant.hops;
-        new_best_ants->best_ants_per_generation_array->time_estimate = ant.time_estimate_T_P;
+    best_ant_t *best_ant = find_best_ant(&ant.source, ant.ant_generation);
 
+    if (best_ant == NULL) {
+        LOG_DBG("No ant of the same generation was seen before!\n");
+        // if this section is reached, no ant of that ant.generation was received earlier (or the generation is
+        // already dropped), therefor ant is accepted and becomes the best ant of its generation
         // ant path is never NULL, initial path is set up above
-        new_best_ants->best_ants_per_generation_array->first_hops = malloc(sizeof(uip_ipaddr_t));
-        new_best_ants->best_ants_per_generation_array->first_hops[0] = ant.path[0];
-        new_best_ants->best_ants_per_generation_array->first_hops_len = 1;
-        new_best_ants->size_of_best_ants_per_generation_array = 1;
-
-        // if no best_ants were yet found
-        if (best_ants == NULL) {
-            // set new best ant as the new global best ants
-            best_ants = new_best_ants;
-        } else if (last_best_ants != NULL) {
-            // add new best ants to the existing array; that happens when a new source was detected
-            last_best_ants->next = new_best_ants;
-        }
+        add_best_ant(&ant.source, ant.ant_generation, ant.hops, ant.time_estimate_T_P, &ant.path[0]);
         LOG_DBG("Set new best ant!\n");
     } else {
-        LOG_DBG("Best ant exists!\n");
-        // reached if a best_ants_t entry with the same address as the address of the source of the ant was found
-
-        unsigned int number = current_best_ants->size_of_best_ants_per_generation_array;
+        LOG_DBG("An best ant with the same generation exists!\n");
+        time_estimate_t est_of_best_entry = best_ant->time_estimate;
 
         // if the ant found a new best path
         bool best = false;
 
-        // if an ant with the same generation has already been seen
-        bool seen = false;
-
-        for (int i = 0; i < number; ++i) {
-            // if current generation in the loop is the generation of the ant
-            if (current_best_ants->best_ants_per_generation_array[i].generation == ant.ant_generation) {
-                seen = true;
-                LOG_DBG("An best ant with the same generation exists!\n");
-                float est_of_best_entry = current_best_ants->best_ants_per_generation_array[i].time_estimate;
-
-                // check acceptance factor a1
-
-                // max, so that ACC_FACTOR_A1 can be greater or smaller than 1
-                float threshold_a1 = est_of_best_entry * (float)fmax(ANT_HOC_NET_ACC_FACTOR_A1, 1.0 / ANT_HOC_NET_ACC_FACTOR_A1);
-
-                LOG_DBG("Estimated time of best ant: %f\n", est_of_best_entry);
-                LOG_DBG("Threshold for acceptance factor a1: %f\n", threshold_a1);
-                LOG_DBG("Estimated time of ant: %f\n", ant.time_estimate_T_P);
-                if (ant.time_estimate_T_P <= threshold_a1) {
-                    LOG_DBG("Ant time estimate is <= threshold.\n");
-                    // if time estimate of the ant is smaller than that of the current best ant of the generation
-                    if (ant.time_estimate_T_P < est_of_best_entry) {
-                        LOG_DBG("Ant is new best Ant.\n");
-                        best = true;
-                    }
-
-                    // failed to get accepted with acceptance factor A1
-                    // check if first hop of ant is different from those of the previously accepted ants
-                } else {
-                    LOG_DBG("Ant time estimate is > threshold - ant failed to get accepted with threshold 1.\n");
-                    // check if first hop of ant exists in the first hop list
-                    for (int j = 0; j < current_best_ants->best_ants_per_generation_array[i].first_hops_len; j++) {
-
-                        /* if path was empty before reception on this ant, path[0] is now this node -> no need to check
-                         * whether path[0] is valid
-                         */
-                        // if the first hop of the ant is a hop, that was used before, the ant is not accepted
-                        if (uip_ipaddr_cmp(&current_best_ants->best_ants_per_generation_array[i].first_hops[j], &ant.path[0])) {
-                            LOG_DBG("Ant doesn't have unique first path - ant is not accepted!\n");
-                            // ant is not accepted
-                            if (ant.path != NULL) {
-                                free(ant.path);
-                                ant.path = NULL;
-                            }
-                            return;
-                        }
-                    }
-
-                    LOG_DBG("Ant has unique first hop! -> check acceptance with threshold 2\n");
-
-                    // if first hop of ant does not exist in the first hop list, check for acceptance factor a2
-                    float threshold_a2 = est_of_best_entry * (float)fmax(ANT_HOC_NET_ACC_FACTOR_A2, 1.0 / ANT_HOC_NET_ACC_FACTOR_A2);
-                    LOG_DBG("Estimated time of best ant: %f\n", est_of_best_entry);
-                    LOG_DBG("Threshold for acceptance factor a2: %f\n", threshold_a2);
-                    LOG_DBG("Estimated time of ant: %f\n", ant.time_estimate_T_P);
-                    if (ant.time_estimate_T_P > threshold_a2) {
-                        LOG_DBG("Ant time estimate is > threshold2 - ant failed to get accepted with threshold 2.\n");
-                        LOG_DBG("Ant is killed.\n");
-                        // ant is not accepted
-                        if (ant.path != NULL) {
-                            free(ant.path);
-                            ant.path = NULL;
-                        }
-                        return;
-                    }
-                }
-                LOG_DBG("Ant is accepted!\n");
-                //------reached when ant was accepted-------------------------------------------------------------------
-
-                current_best_ants->best_ants_per_generation_array[i].first_hops_len++;
-
-                // add first hop of the node to the first hops array
-                uip_ipaddr_t *new_first_hops = malloc(current_best_ants->best_ants_per_generation_array[i].first_hops_len * sizeof(uip_ipaddr_t));
-                memcpy(new_first_hops, current_best_ants->best_ants_per_generation_array[i].first_hops, (current_best_ants->best_ants_per_generation_array[i].first_hops_len - 1) * sizeof(uip_ipaddr_t));
-
-                new_first_hops[current_best_ants->best_ants_per_generation_array[i].first_hops_len - 1] = ant.path[0];
-                if (current_best_ants->best_ants_per_generation_array[i].first_hops != NULL) {
-                    free(current_best_ants->best_ants_per_generation_array[i].first_hops);
-                    current_best_ants->best_ants_per_generation_array[i].first_hops = NULL;
-                }
-                current_best_ants->best_ants_per_generation_array[i].first_hops = new_first_hops;
-
-                // if best, set values of ant to the new best ant
-                if (best) {
-                    LOG_DBG("Update best ant array!\n");
-                    current_best_ants->best_ants_per_generation_array[i].hop_count = ant.hops;
-                    current_best_ants->best_ants_per_generation_array[i].time_estimate = ant.time_estimate_T_P;
-                }
+        // check acceptance factor a1
 
-                break;
+        // max, so that ACC_FACTOR_A1 can be greater or smaller than 1
+        time_estimate_t threshold_a1 = REAL_MUL(est_of_best_entry, REAL_CONST(ACC_FACTOR(ANT_HOC_NET_ACC_FACTOR_A1)));
+
+        LOG_DBG("Estimated time of best ant: %f\n", REAL_TO_FLOAT(est_of_best_entry));
+        LOG_DBG("Threshold for acceptance factor a1: %f\n", REAL_TO_FLOAT(threshold_a1));
+        LOG_DBG("Estimated time of ant: %f\n", REAL_TO_FLOAT(ant.time_estimate_T_P));
+        if (ant.time_estimate_T_P <= threshold_a1) {
+            LOG_DBG("Ant time estimate is <= threshold.\n");
+            // if time estimate of the ant is smaller than that of the current best ant of the generation
+            if (ant.time_estimate_T_P < est_of_best_entry) {
+                LOG_DBG("Ant is new best Ant.\n");
+                best = true;
             }
-        }
-        /* THIS SECTION IS ONLY REACHED IF THE ANT WAS ACCEPTED OR NO ANT OF ITS GENERATION WAS EVER SEEN,
-         * THUS IF AN ANT WAS NOT ACCEPTED, THIS AREA WOULD NOT BE REACHED
-         */
-
-        // check whether the loop ended from a break of because no best ant was found
-        if (!seen) {
-            LOG_DBG("No ant of the same generation was seen before!\n");
-            // if this section is reached, if no ant of that ant.generation was received earlier
-            // therefor ant is accepted and added to best_ants.best_ants_per_generation_array
-
-            current_best_ants->size_of_best_ants_per_generation_array++;
-
-            best_ant_t new_best_ant;
-            new_best_ant.time_estimate = ant.time_estimate_T_P;
-            new_best_ant.generation = ant.ant_generation;
-            new_best_ant.hop_count = ant.hops;
-            new_best_ant.first_hops = malloc(sizeof(uip_ipaddr_t));
-            new_best_ant.first_hops[0] = uip_zeroes_addr;
-            if (ant.hops > 0) {
-                new_best_ant.first_hops[0] = ant.path[0];
-                new_best_ant.first_hops_len = 1;
-            } else {
-                new_best_ant.first_hops_len = 0;
+
+            // failed to get accepted with acceptance factor A1
+            // check if first hop of ant is different from those of the previously accepted ants
+        } else {
+            LOG_DBG("Ant time estimate is > threshold - ant failed to get accepted with threshold 1.\n");
+
+            /* if path was empty before reception on this ant, path[0] is now this node -> no need to check
+             * whether path[0] is valid
+             */
+            // if the first hop of the ant is a hop, that was used before, the ant is not accepted
+            if (best_ant_has_first_hop(best_ant, &ant.path[0])) {
+                LOG_DBG("Ant doesn't have unique first path - ant is not accepted!\n");
+                // ant is not accepted
+                return;
             }
 
-            // add new best_ant element to the array
-            best_ant_t *new_best_ant_array = malloc(current_best_ants->size_of_best_ants_per_generation_array * sizeof(best_ant_t));
-            memcpy(new_best_ant_array, current_best_ants->best_ants_per_generation_array,
-                   (current_best_ants->size_of_best_ants_per_generation_array - 1) * sizeof(best_ant_t));
-            memcpy(&new_best_ant_array[current_best_ants->size_of_best_ants_per_generation_array - 1], &new_best_ant, sizeof(new_best_ant));
-            if (current_best_ants->best_ants_per_generation_array != NULL) {
-                free(current_best_ants->best_ants_per_generation_array);
-                current_best_ants->best_ants_per_generation_array = NULL;
+            LOG_DBG("Ant has unique first hop! -> check acceptance with threshold 2\n");
+
+            // if first hop of ant does not exist in the first hop list, check for acceptance factor a2
+            time_estimate_t threshold_a2 = REAL_MUL(est_of_best_entry, REAL_CONST(ACC_FACTOR(ANT_HOC_NET_ACC_FACTOR_A2)));
+            LOG_DBG("Estimated time of best ant: %f\n", REAL_TO_FLOAT(est_of_best_entry));
+            LOG_DBG("Threshold for acceptance factor a2: %f\n", REAL_TO_FLOAT(threshold_a2));
+            LOG_DBG("Estimated time of ant: %f\n", REAL_TO_FLOAT(ant.time_estimate_T_P));
+            if (ant.time_estimate_T_P > threshold_a2) {
+                LOG_DBG("Ant time estimate is > threshold2 - ant failed to get accepted with threshold 2.\n");
+                LOG_DBG("Ant is killed.\n");
+                // ant is not accepted
+                return;
             }
-            current_best_ants->best_ants_per_generation_array = new_best_ant_array;
+        }
+        LOG_DBG("Ant is accepted!\n");
+        //------reached when ant was accepted---------------------------------------------------------------------------
+
+        // add first hop of the node to the first hops array
+        add_first_hop_to_best_ant(best_ant, &ant.path[0]);
+
+        // if best, set values of ant to the new best ant
+        if (best) {
+            LOG_DBG("Update best ant!\n");
+            best_ant->hop_count = ant.hops;
+            best_ant->time_estimate = ant.time_estimate_T_P;
         }
     }
 
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+    // the backward ants of this generation are sent back to the node the first accepted ant came from
+    if (!add_reverse_route(&ant.source, ant.ant_generation, false, &previous_hop)) {
+        LOG_WARN("No reverse route can be kept - ant is killed!\n");
+        return;
+    }
+#endif
+
+#if ANT_HOC_NET_INTERMEDIATE_REPLY
+    // a node with a fresh path to the destination answers the ant itself; only the first such node answers
+    time_estimate_t remaining_time;
+    hop_t remaining_hops;
+    if (ant.ant_type == REACTIVE_FORWARD_ANT && !ant.replied
+        && find_intermediate_reply_path(&ant, &previous_hop, &remaining_time, &remaining_hops)) {
+        LOG_DBG("Fresh path to the destination - ant is answered!\n");
+#if ANT_HOC_NET_INTERMEDIATE_REPLY_CONTINUATION
+        // the backward ant is built in uip_buf over the path of the forward ant, the path is kept aside statically
+        // so the forwarding path does not touch the heap
+        static uip_ipaddr_t path_copy[(ICMP6_ANT_MAX_PAYLOAD_LEN - WIRE_RFA_HEADER_LEN) / sizeof(uip_ipaddr_t)];
+        size_t path_size = WIRE_PATH_ELEMENTS(ant.hops) * sizeof(uip_ipaddr_t);
+        if (path_size > sizeof(path_copy)) {
+            return;
+        }
+        memcpy(path_copy, ant.path, path_size);
+#endif
+        send_intermediate_backward_ant(&ant, &previous_hop, remaining_time, remaining_hops);
+#if ANT_HOC_NET_INTERMEDIATE_REPLY_CONTINUATION
+        // the ant still goes on to the destination to refresh the path end to end, the nodes behind don't answer it
+        memcpy(ant.path, path_copy, path_size);
+        ant.replied = true;
+#else
+        return;
+#endif
+    }
+#endif
+
     // Check for routing information, if existent, then unicast if not broadcast
     // Select next neighbours
 
-    int size_of_neighbours = 0;
-    uip_ipaddr_t *list_of_neighbours_with_destination = get_neighbours_to_send_to_destination(ant.destination, true, &size_of_neighbours);
+    // only the selected neighbour is needed
+    uip_ipaddr_t next_hop;
+    int size_of_neighbours = get_neighbours_to_send_to_destination(ant.destination, true, &next_hop, 1);
 
     // Multicast if no pheromone value is no available
     // Select neighbour to unicast to with probability Pnd
@@ -742,59 +831,61 @@ void reception_reactive_forward_or_path_repair_ant(struct reactive_forward_or_pa
         }
 
     } else {
-        /*
-        for (int i = 0; i < size_of_neighbours; i++) {
-            send_reactive_forward_or_path_repair_ant(false, list_of_neighbours_with_destination[i], ant);
-        }
-        */
         // only sent it to one found neighbour
-        send_reactive_forward_or_path_repair_ant(false, list_of_neighbours_with_destination[0], ant);
-    }
-    if (list_of_neighbours_with_destination != NULL) {
-        free(list_of_neighbours_with_destination);
-        list_of_neighbours_with_destination = NULL;
-    }
-
-    if (ant.path != NULL) {
-        // free the allocated space for the path of the ant
-        free(ant.path);
-        ant.path = NULL;
+        send_reactive_forward_or_path_repair_ant(false, next_hop, ant);
     }
 }
 
-void create_and_send_backward_ant(unsigned int ant_gen, hop_t hops, uip_ipaddr_t * path, uip_ipaddr_t destination) {
+void create_and_send_backward_ant(unsigned int ant_gen, bool proactive, hop_t hops, uip_ipaddr_t * path, uip_ipaddr_t destination) {
     LOG_DBG("Start create and send backward ant!\n");
-    uip_ipaddr_t reversed_path[hops];
 
     if (path == NULL) {
         LOG_DBG("Path is NULL! - no backward ant is sent!\n");
         return;
     }
 
-    // reverse path
-    for (int i = 0; i < hops; i++) {
-        reversed_path[i] = path[(hops - 1) - i];
+    uip_ipaddr_t *reversed_path = (uip_ipaddr_t *) (ICMP6_ANT_PAYLOAD + WIRE_RBA_HEADER_LEN);
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+    // the window of the backward ant holds its origin and the last node it passed, both are this node now
+    uip_ipaddr_t next_hop = path[0];
+    reversed_path[0] = host_addr;
+    reversed_path[WIRE_PATH_WINDOW - 1] = host_addr;
+    hops = WIRE_PATH_WINDOW;
+#else
+    if (hops > (ICMP6_ANT_MAX_PAYLOAD_LEN - WIRE_RBA_HEADER_LEN) / sizeof(uip_ipaddr_t)) {
+        LOG_WARN("Path does not fit into uip_buf - no backward ant is sent!\n");
+        return;
+    }
+
+    // move the path behind the header of the backward ant in uip_buf (the path of a received forward ant already is
+    // in uip_buf), then reverse it in place
+    if (path != reversed_path) {
+        memmove(reversed_path, path, hops * sizeof(uip_ipaddr_t));
     }
+    for (int i = 0; i < hops / 2; i++) {
+        uip_ipaddr_t temp = reversed_path[i];
+        reversed_path[i] = reversed_path[(hops - 1) - i];
+        reversed_path[(hops - 1) - i] = temp;
+    }
+    uip_ipaddr_t next_hop = reversed_path[1];
+#endif
 
     struct reactive_backward_ant rba = {
             .ant_type = BACKWARD_ANT,
             .ant_generation = ant_gen,
+            .proactive = proactive,
             .destination = destination,
             .path = reversed_path,
             .length = hops,
-            .time_estimate_T_P = (float)0.0,
+            .time_estimate_T_P = REAL_CONST(0.0),
             .current_hop = 0,
     };
 
     // check whether the next neighbour is still there, if not discard the ant
-    if (!does_neighbour_exists(reversed_path[1])) {
+    if (!does_neighbour_exists(next_hop)) {
         LOG_DBG("Neighbour ");
-        LOG_DBG_6ADDR(&reversed_path[1]);
+        LOG_DBG_6ADDR(&next_hop);
         LOG_DBG_(" is not reachable, since it doesn't exist anymore!\n");
-        if (path != NULL) {
-            free(path);
-            path = NULL;
-        }
         return;
     }
 
@@ -802,22 +893,12 @@ void create_and_send_backward_ant(unsigned int ant_gen, hop_t hops, uip_ipaddr_t
     LOG_INFO_6ADDR(&rba.destination);
     LOG_INFO_("\n");
 
-    // copy the first fields
-    uint16_t size_counter = sizeof(rba) - sizeof(uip_ipaddr_t *);
-    memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN], &rba, size_counter);
-
-    // copy the whole path
-    if (rba.length >= 1  && rba.path != NULL) {
-        memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN + size_counter], rba.path, rba.length * sizeof(uip_ipaddr_t));
-        size_counter += rba.length * sizeof(uip_ipaddr_t);
-    }
-    uip_icmp6_send(&reversed_path[1], ICMP6_REACTIVE_BACKWARD_ANT, 0, size_counter);
-
-    // free the allocated space for the path of the forward ant
-    if (path != NULL) {
-        free(path);
-        path = NULL;
-    }
+    // the path is in place already, it is only compressed
+    uint8_t header[WIRE_RBA_HEADER_LEN];
+    uint8_t code;
+    wire_write_reactive_backward_ant(header, &rba);
+    uint16_t size_counter = write_ant_payload(header, WIRE_RBA_HEADER_LEN, rba.path, rba.length, &rba.destination, &code);
+    uip_icmp6_send(&next_hop, ICMP6_REACTIVE_BACKWARD_ANT, code, size_counter);
 }
 
 void reception_reactive_backward_ant(struct reactive_backward_ant ant) {
@@ -832,15 +913,23 @@ void reception_reactive_backward_ant(struct reactive_backward_ant ant) {
 
     if (uip_ipaddr_cmp(&ant.destination, &host_addr)) {
         LOG_DBG("Destination reached!\n");
-        if (ant.path != NULL) {
-            free(ant.path);
-            ant.path = NULL;
-        }
         return;
     }
 
     uip_ipaddr_t next_neighbour_addr;
 
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+    if (ant.current_hop > ANT_HOC_NET_MAX_HOPS) {
+        LOG_DBG("Max hops reached!\n");
+        return;
+    }
+    if (!get_reverse_route(&ant.destination, ant.ant_generation, ant.proactive, &next_neighbour_addr)) {
+        LOG_DBG("No reverse route of the generation - ant is killed!\n");
+        return;
+    }
+    // this node becomes the last node of the window
+    ant.path[WIRE_PATH_WINDOW - 1] = host_addr;
+#else
     // length minus one since the first node set the current_hop to 0;
     // length minus one since it is the length of the path with the source node and the current hop doesnt contain it
     if (ant.length - 1 == ant.current_hop) {
@@ -851,6 +940,7 @@ void reception_reactive_backward_ant(struct reactive_backward_ant ant) {
     } else {
         next_neighbour_addr = ant.path[ant.current_hop + 1];
     }
+#endif
     LOG_DBG("Next hop neighbour is ");
     LOG_DBG_6ADDR(&next_neighbour_addr);
     LOG_DBG_("\n");
@@ -858,10 +948,6 @@ void reception_reactive_backward_ant(struct reactive_backward_ant ant) {
     // check whether the next neighbour is still there, if not discard the ant
     if (!does_neighbour_exists(next_neighbour_addr)) {
         LOG_DBG("Next hop neighbour is not reachable!\n");
-        if (ant.path != NULL) {
-            free(ant.path);
-            ant.path = NULL;
-        }
         return;
     }
 
@@ -873,74 +959,47 @@ void reception_reactive_backward_ant(struct reactive_backward_ant ant) {
         LOG_DBG_("\n");
     }
 
-    // copy the first fields
-    uint16_t size_counter = sizeof(ant) - sizeof(uip_ipaddr_t *);
-    memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN], &ant, size_counter);
-
-    // copy the whole path
-    if (ant.length >= 1  && ant.path != NULL) {
-        memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN + size_counter], ant.path, ant.length * sizeof(uip_ipaddr_t));
-        size_counter += ant.length * sizeof(uip_ipaddr_t);
+    // the path is only copied if the ant is not forwarded from uip_buf
+    uint8_t header[WIRE_RBA_HEADER_LEN];
+    uint8_t code;
+    wire_write_reactive_backward_ant(header, &ant);
+    uint16_t size_counter = write_ant_payload(header, WIRE_RBA_HEADER_LEN, ant.path, ant.path == NULL ? 0 : ant.length,
+                                              &ant.destination, &code);
+    if (size_counter == 0) {
+        LOG_WARN("Ant does not fit into uip_buf - ant is killed!\n");
+        return;
     }
 
     LOG_INFO("Backward Ant sent to neighbour: ");
     LOG_INFO_6ADDR(&next_neighbour_addr);
     LOG_INFO_("\n");
-    uip_icmp6_send(&next_neighbour_addr, ICMP6_REACTIVE_BACKWARD_ANT, 0, size_counter);
+    uip_icmp6_send(&next_neighbour_addr, ICMP6_REACTIVE_BACKWARD_ANT, code, size_counter);
 }
 
 void reactive_path_setup(uip_ipaddr_t destination) {
-    process_start(&reactive_path_setup_proc, (process_data_t *) &destination);
-}
-
-void delete_neighbour_from_best_ant_array(uip_ipaddr_t neighbour_address) {
-    best_ants_t * current = best_ants;
-    best_ants_t * previous = NULL;
-    while (current != NULL) {
-        if (uip_ipaddr_cmp(&current->source, &neighbour_address)) {
-            if (previous == NULL) {
-                best_ants = current->next;
-            } else {
-                previous->next = current->next;
-            }
-            if (current->best_ants_per_generation_array->first_hops != NULL) {
-                free(current->best_ants_per_generation_array->first_hops);
-                current->best_ants_per_generation_array->first_hops = NULL;
-            }
-            if (current->best_ants_per_generation_array != NULL) {
-                free(current->best_ants_per_generation_array);
-                current->best_ants_per_generation_array = NULL;
-            }
-            if (current != NULL) {
-                free(current);
-                current = NULL;
-            }
+    path_setup_t *path_setup = find_path_setup(&destination);
+    if (path_setup == NULL) {
+        path_setup = start_path_setup(&destination, ANT_HOC_NET_RESTART_PATH_SETUP_SECS * CLOCK_SECOND);
+        if (path_setup == NULL) {
             return;
         }
-        previous = current;
-        current = current->next;
-    }
-}
 
-/**
- * Deletes the best ants array.
- */
-void delete_best_ants_array () {
-    while (best_ants != NULL) {
-        if (best_ants->best_ants_per_generation_array->first_hops != NULL) {
-            free(best_ants->best_ants_per_generation_array->first_hops);
-            best_ants->best_ants_per_generation_array->first_hops = NULL;
-        }
-        if (best_ants->best_ants_per_generation_array != NULL) {
-            free(best_ants->best_ants_per_generation_array);
-            best_ants->best_ants_per_generation_array = NULL;
+        LOG_INFO("Reactive path setup started to ");
+        LOG_INFO_6ADDR(&destination);
+        LOG_INFO_("\n");
+
+        path_setup->try_counter = 1;
+        // remember ant generation for the backward ant
+        path_setup->ant_generation = ++ant_generation;
+        LOG_DBG("Sending reactive forward ant\n");
+        // the packet is buffered first, the ant overwrites uip_buf
+        if (uip_len > 0) {
+            buffer_packet(&path_setup->buffer);
         }
-        best_ants_t * temp = best_ants;
-        best_ants = best_ants->next;
-        free(temp);
-        temp = NULL;
+        create_reactive_forward_or_path_repair_ant(path_setup->ant_generation, destination, REACTIVE_FORWARD_ANT);
+    } else if (uip_len > 0) {
+        buffer_packet(&path_setup->buffer);
     }
-    best_ants = NULL;
 }
 
 /*----End-Reactive-Path-Setup-----------------------------------------------------------------------------------------*/
@@ -952,124 +1011,21 @@ int stochastic_data_routing(uip_ipaddr_t destination, uip_ipaddr_t *address) {
     LOG_DBG("Send data to neighbour with address: ");
     LOG_DBG_6ADDR(&destination);
     LOG_DBG_("\n");
-    int size_of_accepted_neighbours;
 
-    // only one neighbour is selected at the time being, but the list contains all
-    uip_ipaddr_t *accepted_neighbours = get_neighbours_to_send_to_destination(destination, false, &size_of_accepted_neighbours);
+    // only one neighbour is selected at the time being, it is written directly into the address
+    int size_of_accepted_neighbours = get_neighbours_to_send_to_destination(destination, false, address, 1);
 
     // if a neighbour is found, return 1 and the address
-    if (accepted_neighbours != NULL && size_of_accepted_neighbours > 0) {
+    if (size_of_accepted_neighbours > 0) {
         LOG_DBG("Stochastic data routing: Neighbour found\n");
 
-        memcpy(address, &accepted_neighbours[0], sizeof(uip_ipaddr_t));
-        LOG_DBG("Data copied!\n");
-
-        // safe the last package
-        last_package_data.destination = destination;
-        last_package_data.selected_nexthop = accepted_neighbours[0];
-        last_package_data.len = uip_len;
-        if (last_package_data.buffer != NULL) {
-            free(last_package_data.buffer);
-            last_package_data.buffer = NULL;
-        }
-        last_package_data.buffer = malloc(uip_len);
-        memcpy(last_package_data.buffer, &uip_buf, uip_len);
+        // the frame of the package is attached to the context when it is queued by the MAC layer
+        add_reroute_context(&destination, address);
 
         // check for path probing only if we are the source node and not a forwarding node
-        if (uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &host_addr)) {
-            LOG_DBG("Check for path probing!\n");
-            last_destination_data_t *dest_data = last_destination_data;
-
-            // check if packages were sent to that destination in a specific time frame, if so check counter
-            // if the sending rate is reached, sent proactive forward ants
-            clock_time_t now = clock_time();
-            bool seen = false;
-            last_destination_data_t *found_dest = NULL;
-            last_destination_data_t *accepted_dest = NULL;
-            while (dest_data != NULL) {
-                double seconds_dif = (double)(now - dest_data->time) / (double)CLOCK_SECOND;
-                LOG_DBG("Dest time difference: %f!\n", seconds_dif);
-                // if time diff is greater than 0.0028 seconds remove the destination
-                // if messages are sent to the same destination in a short time, it is assumed that a data session is running
-                // if that's the case, count the messages and send proactive forward ant according to the sending rate.
-                LOG_DBG("Dest data: count: %d, time: %lu, addr: ", dest_data->count, dest_data->time);
-                LOG_DBG_6ADDR(&dest_data->destination);
-                LOG_DBG_("\n");
-
-                if (seconds_dif <= ANT_HOC_NET_PFA_TIME_THRESHOLD) {
-                    LOG_DBG("Dest time difference is smaller than 0.5 seconds!\n");
-                    LOG_DBG("Safe the destination!\n");
-
-                    // safe the destination data if it's in the time frame and the correct destination
-                    if (uip_ipaddr_cmp(&dest_data->destination, &destination)) {
-                        LOG_DBG("Destination is found!\n");
-                        found_dest = dest_data;
-                        seen = true;
-                    }
-
-                    // safe dest as accepted
-                    if (accepted_dest == NULL) {
-                        // if no other destination was found, set dest as the only accepted
-                        accepted_dest = dest_data;
-                    } else {
-                        // if another destination was found before, safe it as the next element
-                        accepted_dest->next = dest_data;
-                    }
-
-                    // move to the next element
-                    dest_data = dest_data->next;
-
-                } else {
-                    LOG_DBG("Dest time difference is greater than 0.5 seconds!\n");
-                    LOG_DBG("Remove dest data, even if it's not the one with the right destination!\n");
-
-                    // free the current dest data and continue to the next element
-                    last_destination_data_t *temp = dest_data;
-                    dest_data = dest_data->next;
-                    free(temp);
-                    temp = NULL;
-                }
-            }
-
-            // safe the accepted destinations as the last destination data
-            last_destination_data = accepted_dest;
-
-            if (seen && found_dest != NULL) {
-                LOG_DBG("Seen and found!\n");
-                found_dest->count++;
-                found_dest->time = now;
-                if (found_dest->count == ANT_HOC_NET_PFA_SENDING_RATE_N) {
-                    LOG_DBG("Path Probing: Sent Proactive forward ant\n");
-                    create_and_send_proactive_forward_ant(destination);
-
-                    // copy the data back since the data of the ant may overwrite the buffer
-                    if (last_package_data.buffer != NULL) {
-                        uip_len = last_package_data.len;
-                        memcpy(&uip_buf, last_package_data.buffer, last_package_data.len);
-                        free(last_package_data.buffer);
-                        last_package_data.buffer = NULL;
-                    }
-                    found_dest->count = 0;
-                }
-
-            } else {
-                LOG_DBG("No last dest found!\n");
-                // if no last destination is found create a new one
-                last_destination_data_t *new_dest = malloc(sizeof(last_destination_data_t));
-                if (new_dest != NULL) {
-                    new_dest->destination = destination;
-                    new_dest->time = now;
-                    new_dest->count = 1;
-                    new_dest->next = last_destination_data;
-                    last_destination_data = new_dest;
-                    LOG_DBG("New destination data set.\n");
-                }
-            }
-
-        }
-        if (accepted_neighbours != NULL) {
-            free(accepted_neighbours);
-            accepted_neighbours = NULL;
+        // the flow table tracks the data session to the destination; the ants are sent by the maintenance process
+        if (uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &host_addr) && flow_packet_sent(&destination)) {
+            poll_proactive_maintenance();
         }
         LOG_DBG("Found address: ");
         LOG_DBG_6ADDR(address);
@@ -1079,12 +1035,6 @@ int stochastic_data_routing(uip_ipaddr_t destination, uip_ipaddr_t *address) {
     LOG_DBG("No neighbour was found!\n");
     // if no neighbour was found
 
-    // free the allocated neighbour list
-    if (accepted_neighbours != NULL) {
-        free(accepted_neighbours);
-        accepted_neighbours = NULL;
-    }
-
     // this function is also called when packages were incoming. so check if the source address of the package is this
     // node's uip address, if not, and no neighbours were found, a "dangling" link, as it was called in the paper,
     // was taken
@@ -1094,33 +1044,27 @@ int stochastic_data_routing(uip_ipaddr_t destination, uip_ipaddr_t *address) {
         return 0;
     }
 
-    // if processes are running and new package is found where the host is the source, buffer that message.
-    if (uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &host_addr) && processes_running()) {
-        LOG_INFO("Packet buffered for later sending, since the reactive path setup or data transmission failed processes is running!\n");
-        packet_buffer_t *next_packet = malloc(sizeof(packet_buffer_t));
-        next_packet->buffer = malloc(uip_len);
-        memcpy(next_packet->buffer, &uip_buf, uip_len);
-        next_packet->len = uip_len;
-        next_packet->next = NULL;
-
-        // append package at the end of the buffer to send the packages in the right order
-        if (buffer.packet_buffer == NULL) {
-            buffer.packet_buffer = next_packet;
-        } else {
-            packet_buffer_t *current = buffer.packet_buffer;
-            while (current->next != NULL) {
-                current = current->next;
-            }
-            current->next = next_packet;
+#if ANT_HOC_NET_HELLO_DIGEST_ENTRIES > 0
+    // a path advertised by the hello messages of a neighbour is taken instead of setting up a path; only by the source,
+    // so that packets don't loop over paths no ant has walked
+    if (get_virtual_next_hop(&destination, address)) {
+        LOG_DBG("Stochastic data routing: Neighbour found by virtual pheromone\n");
+        add_reroute_context(&destination, address);
+        // the proactive forward ants of the session lay regular pheromone on the path
+        if (flow_packet_sent(&destination)) {
+            poll_proactive_maintenance();
         }
-        ++buffer.number_of_packets;
-
-        buffer.valid = true;
-        return 0;
+        return 1;
     }
+#endif
 
-    LOG_DBG("Stochastic data routing: Start path setup\n");
-    // start the reactive path setup phase
+    // a packet of this node waits for the path setup of its destination, other destinations are not affected
+    if (path_setup_running(destination)) {
+        LOG_INFO("Packet buffered for later sending, since the path to its destination is set up!\n");
+    } else {
+        LOG_DBG("Stochastic data routing: Start path setup\n");
+    }
+    // start the reactive path setup phase, or add the packet to the running one
     reactive_path_setup(destination);
 
     // when 0 is returned, get_nexthop will check if routes are available for that destination. in the configuration
@@ -1134,18 +1078,68 @@ int stochastic_data_routing(uip_ipaddr_t destination, uip_ipaddr_t *address) {
     return 0;
 }
 
-void delete_last_destination_data_array() {
-    while (last_destination_data != NULL) {
-        last_destination_data_t *temp = last_destination_data;
-        last_destination_data = last_destination_data->next;
-        free(temp);
-    }
-}
 
 /*----End-Stochastic-data-routing-------------------------------------------------------------------------------------*/
 
 /*----Proactive-path-probing,-maintenance-and-exploration-------------------------------------------------------------*/
 
+/**
+ * Sends the proactive forward ants that are due for the active data sessions.
+ * @return The time until the next ant is due, 0 if no ant is scheduled by time
+ */
+static clock_time_t maintain_proactive_paths() {
+    clock_time_t now = clock_time();
+    clock_time_t wait = 0;
+    for (flow_t *flow = next_active_flow(NULL); flow != NULL; flow = next_active_flow(flow)) {
+        if (flow_ant_due(flow, now)) {
+            // the ant would overwrite a packet in uip_buf, it is sent with the next tick
+            if (uip_len > 0) {
+                wait = 1;
+                continue;
+            }
+            LOG_DBG("Path Probing: Sent Proactive forward ant\n");
+            // the sum of the pheromone to the destination tells how volatile the path is
+            flow_ant_sent(flow, now, get_pheromone_sum_to_destination(flow->destination));
+            create_and_send_proactive_forward_ant(flow->destination);
+        }
+        clock_time_t flow_wait = flow_time_until_ant(flow, now);
+        if (flow_wait > 0 && (wait == 0 || flow_wait < wait)) {
+            wait = flow_wait;
+        }
+    }
+    return wait;
+}
+
+/*
+ * Process that sends the proactive forward ants of the data sessions the node is the source of. It wakes up when the
+ * next ant is due, or when it is polled after a session started.
+ */
+PROCESS_THREAD(proactive_maintenance_proc, ev, data) {
+    PROCESS_BEGIN();
+    LOG_INFO("Proactive maintenance process started\n");
+
+    static struct etimer timer;
+
+    while (1) {
+        PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER || ev == PROCESS_EVENT_POLL);
+        clock_time_t wait = maintain_proactive_paths();
+        if (wait > 0) {
+            etimer_set(&timer, wait);
+        } else {
+            // no session left, or the ants are triggered by the packet count; the process is polled again
+            etimer_stop(&timer);
+        }
+    }
+    PROCESS_END();
+}
+
+void poll_proactive_maintenance() {
+    if (!process_is_running(&proactive_maintenance_proc)) {
+        process_start(&proactive_maintenance_proc, NULL);
+    }
+    process_poll(&proactive_maintenance_proc);
+}
+
 /**
  * Creates a proactive forward ant and sends it.
  * @param destination The final destination of the ant (in contrast to the next hop)
@@ -1155,6 +1149,7 @@ void create_and_send_proactive_forward_ant(uip_ipaddr_t destination) {
     struct proactive_forward_ant ant = {
             .source = host_addr,
             .destination = destination,
+            .ant_generation = ++proactive_ant_generation,
             .number_of_broadcasts = 0,
             .hops = 0,
             .path = NULL
@@ -1168,43 +1163,32 @@ void send_proactive_forward_ant(struct proactive_forward_ant ant) {
 
     uip_ipaddr_t next_hop;
     srand(time(NULL));
-    double random_number = (double) rand() / RAND_MAX;
+    int random_number = rand();
 
     bool broadcast = false;
 
     // check whether the ant is broadcast
-    if (random_number <= ANT_HOC_NET_PFA_BROADCAST_PROBABILITY) {
+    if (random_number <= (int)(ANT_HOC_NET_PFA_BROADCAST_PROBABILITY * RAND_MAX)) {
         broadcast = true;
 
     } else {
         // get next hop neighbour
         // at the time being, it is only one neighbour selected
-        int accepted_neighbour_size = 0;
-        uip_ipaddr_t *neighbours = get_neighbours_to_send_to_destination(ant.destination, true, &accepted_neighbour_size);
+        int accepted_neighbour_size = get_neighbours_to_send_to_destination(ant.destination, true, &next_hop, 1);
 
-        if (accepted_neighbour_size == 0 || neighbours == NULL) {
+        if (accepted_neighbour_size == 0) {
             LOG_DBG("Send ant as broadcast!\n");
             broadcast = true;
         } else {
             LOG_DBG("Send ant as unicast to ");
-            LOG_DBG_6ADDR(&neighbours[0]);
+            LOG_DBG_6ADDR(&next_hop);
             LOG_DBG_("\n");
-            // only one ant should be selected
-            next_hop = neighbours[0];
-        }
-        if (neighbours != NULL) {
-            free(neighbours);
-            neighbours = NULL;
         }
     }
     if (broadcast) {
         // kill ant if the maximal number of broadcasts is reached
         if (ant.number_of_broadcasts == ANT_HOC_NET_MAX_NUMBER_BROADCASTS_PFA) {
             LOG_DBG("Maximal number of broadcasts reached, kill ant!\n");
-            if (ant.path != NULL) {
-                free(ant.path);
-                ant.path = NULL;
-            }
             return;
         }
         uip_create_linklocal_allnodes_mcast(&next_hop);
@@ -1212,14 +1196,15 @@ void send_proactive_forward_ant(struct proactive_forward_ant ant) {
         ++ant.number_of_broadcasts;
     }
 
-    // copy the first fields
-    uint16_t size_counter = sizeof(ant) - sizeof(uip_ipaddr_t *);
-    memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN], &ant, size_counter);
-
-    // copy the whole path
-    if (ant.hops >= 1  && ant.path != NULL) {
-        memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN + size_counter], ant.path, ant.hops * sizeof(uip_ipaddr_t));
-        size_counter += ant.hops * sizeof(uip_ipaddr_t);
+    // the path is only copied if the ant is not forwarded from uip_buf
+    uint8_t header[WIRE_PFA_HEADER_LEN];
+    uint8_t code;
+    wire_write_proactive_forward_ant(header, &ant);
+    uint16_t size_counter = write_ant_payload(header, WIRE_PFA_HEADER_LEN, ant.path,
+                                              ant.path == NULL ? 0 : WIRE_PATH_ELEMENTS(ant.hops), &ant.source, &code);
+    if (size_counter == 0) {
+        LOG_WARN("Ant does not fit into uip_buf - ant is killed!\n");
+        return;
     }
 
     /*if (broadcast) {
@@ -1231,47 +1216,286 @@ void send_proactive_forward_ant(struct proactive_forward_ant ant) {
     char *broadcast_str = broadcast ? "broadcast" : "unicast";
     LOG_INFO_(" as %s\n", broadcast_str);
 
-    uip_icmp6_send(&next_hop, ICMP6_PROACTIVE_FORWARD_ANT, 0, size_counter);
+    if (broadcast && !uip_ipaddr_cmp(&ant.source, &host_addr)) {
+        // relayed broadcasts are delayed and may be suppressed, see anthocnet-rebroadcast.h
+        schedule_rebroadcast(&next_hop, ICMP6_PROACTIVE_FORWARD_ANT, code, size_counter,
+                             rebroadcast_key(ICMP6_PROACTIVE_FORWARD_ANT, &ant.source, ant.ant_generation),
+                             REAL_CONST(0.0), true);
+    } else {
+        uip_icmp6_send(&next_hop, ICMP6_PROACTIVE_FORWARD_ANT, code, size_counter);
+    }
     //}
 
 }
 
 void reception_proactive_forward_ant(struct proactive_forward_ant ant) {
     LOG_DBG("Received proactive forward ant\n");
+    uip_ipaddr_t previous_hop = get_previous_hop(ant.path, ant.hops, &ant.source);
     ant.hops++;
 
-    // add node to the path
-    uip_ipaddr_t *new_path = malloc(ant.hops * sizeof(uip_ipaddr_t));
-    memcpy(new_path, ant.path, (ant.hops - 1) * sizeof(uip_ipaddr_t));
-    new_path[ant.hops - 1] = host_addr;
-    ant.path = new_path;
+    // the path no longer bounds the ant, if only a window of it is carried
+    if (ant.hops > ANT_HOC_NET_MAX_HOPS) {
+        LOG_DBG("Max hops reached!\n");
+        return;
+    }
+
+    // add node to the path; a received ant is extended in place in uip_buf
+    ant.path = append_host_to_path(ant.path, ant.hops - 1, WIRE_PFA_HEADER_LEN);
+    if (ant.path == NULL) {
+        LOG_WARN("Path does not fit into uip_buf - ant is killed!\n");
+        return;
+    }
 
     if (uip_ipaddr_cmp(&ant.destination, &host_addr)) {
         LOG_DBG("Destination reached!\n");
-        create_and_send_backward_ant((int)ant_generation, ant.hops, ant.path, ant.source);
+        // the backward ant carries the generation of the proactive ant and is marked as proactive, so it can't finish
+        // a path setup, whose reactive generations are counted apart
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+        // it follows the reverse routes of that proactive generation
+        create_and_send_backward_ant(ant.ant_generation, true, ant.hops, &previous_hop, ant.source);
+#else
+        create_and_send_backward_ant(ant.ant_generation, true, ant.hops, ant.path, ant.source);
+#endif
     } else {
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+        if (!add_reverse_route(&ant.source, ant.ant_generation, true, &previous_hop)) {
+            LOG_WARN("No reverse route can be kept - ant is killed!\n");
+            return;
+        }
+#endif
         LOG_DBG("Send proactive forward ant to next neighbour!\n");
         send_proactive_forward_ant(ant);
     }
 }
 
+#if ANT_HOC_NET_HELLO_TRICKLE
 /**
- * Starts the process that broadcast hello messages every ANT_HOC_NET_T_HELLO_SECs.
+ * Callback of the Trickle timer of the hello messages; a hello message is sent in every interval, since the
+ * redundancy constant is infinite.
+ */
+static void hello_trickle_callback(void *ptr, uint8_t suppress) {
+    broadcast_hello_messages();
+}
+#endif
+
+/**
+ * Starts the broadcast of hello messages, every ANT_HOC_NET_T_HELLO_SECs or by the Trickle timer.
  */
 void start_broadcast_of_hello_messages() {
     hello_message_broadcasting = true;
+#if ANT_HOC_NET_HELLO_TRICKLE
+    trickle_timer_config(&hello_trickle_timer, ANT_HOC_NET_T_HELLO_SEC * CLOCK_SECOND,
+                         ANT_HOC_NET_HELLO_TRICKLE_DOUBLINGS, TRICKLE_TIMER_INFINITE_REDUNDANCY);
+    trickle_timer_set(&hello_trickle_timer, hello_trickle_callback, NULL);
+#else
     process_start(&broadcast_hello_messages_proc, (process_data_t *) NULL);
+#endif
 }
 
 /**
- * Stops the process that broadcast hello messages.
+ * Stops the broadcast of hello messages.
  */
 void stop_broadcast_of_hello_messages() {
     hello_message_broadcasting = false;
+#if ANT_HOC_NET_HELLO_TRICKLE
+    trickle_timer_stop(&hello_trickle_timer);
+#else
     process_exit(&broadcast_hello_messages_proc);
+#endif
+    ctimer_stop(&hello_retry_timer);
+#if ANT_HOC_NET_HELLO_SUPPRESSION
+    ctimer_stop(&hello_deferral_timer);
+#endif
+}
+
+void hello_neighbourhood_changed() {
+#if ANT_HOC_NET_HELLO_TRICKLE
+    if (hello_message_broadcasting) {
+        LOG_DBG("Neighbourhood changed - hello interval reset\n");
+        trickle_timer_inconsistency(&hello_trickle_timer);
+    }
+#endif
+}
+
+#if ANT_HOC_NET_HELLO_SUPPRESSION
+/**
+ * Builds the uIP address of a neighbour from its link-layer address, the prefix is the same for all nodes.
+ */
+static void neighbour_address_of(const linkaddr_t *lladdr, uip_ipaddr_t *address) {
+    *address = host_addr;
+    uip_ds6_set_addr_iid(address, (const uip_lladdr_t *) lladdr);
+}
+
+/**
+ * Called by the netstack for every received IP packet; a packet from a neighbour counts like its hello message.
+ */
+static enum netstack_ip_action liveness_input(void) {
+    if (acceptance_messages) {
+        uip_ipaddr_t neighbour;
+        neighbour_address_of(packetbuf_addr(PACKETBUF_ADDR_SENDER), &neighbour);
+        reset_hello_loss_timer(neighbour);
+    }
+    return NETSTACK_IP_PROCESS;
 }
 
+/**
+ * Called by the netstack for every IP packet that is sent; a broadcast reaches all neighbours like a hello message.
+ * @param localdest The link-layer address of the next hop, NULL for a broadcast
+ */
+static enum netstack_ip_action liveness_output(const linkaddr_t *localdest) {
+    if (localdest == NULL) {
+        last_broadcast = clock_time();
+    }
+    return NETSTACK_IP_PROCESS;
+}
+
+static struct netstack_ip_packet_processor liveness_processor = {
+    .process_input = liveness_input,
+    .process_output = liveness_output
+};
+#endif
+
+/**
+ * The longest time until the next hello message of this node, or with ANT_HOC_NET_HELLO_SUPPRESSION until its next
+ * frame, that is advertised to the neighbours.
+ * @return The time in ticks
+ */
+static clock_time_t hello_interval() {
+#if ANT_HOC_NET_HELLO_TRICKLE
+    // the next hello is sent in the next interval at the latest, which is twice as long as the current one
+    clock_time_t rest_of_interval = hello_trickle_timer.i_start + hello_trickle_timer.i_cur - clock_time();
+    return rest_of_interval + MIN(hello_trickle_timer.i_cur << 1, hello_trickle_timer.i_max_abs);
+#else
+    return ANT_HOC_NET_T_HELLO_SEC * CLOCK_SECOND;
+#endif
+}
+
+static void send_hello_message();
+
+#if ANT_HOC_NET_HELLO_SUPPRESSION
+static bool hello_message_deferred();
+
+/**
+ * Callback of the deferral timer; the deferred hello message is sent, unless a frame reached all neighbours meanwhile.
+ */
+static void hello_deferral_callback(void *ptr) {
+    if (hello_message_broadcasting && !hello_message_deferred()) {
+        send_hello_message();
+    }
+}
+
+/**
+ * Whether the hello message is deferred, since every neighbour got a frame of this node within the advertised hello
+ * interval. The hello is then sent when the oldest of these frames becomes one interval old, so the neighbours never
+ * wait longer than that interval for a frame.
+ * @return True if the hello message is deferred
+ */
+static bool hello_message_deferred() {
+    if (!neighbours_exists()) {
+        return false;
+    }
+    // a broadcast reached all neighbours, a unicast the neighbour that acknowledged it
+    clock_time_t age = MIN(clock_time() - last_broadcast, longest_time_since_neighbour_reached());
+    if (age >= advertised_hello_interval) {
+        return false;
+    }
+    ctimer_set(&hello_deferral_timer, advertised_hello_interval - age, hello_deferral_callback, NULL);
+    return true;
+}
+#endif
+
+#if ANT_HOC_NET_HELLO_DIGEST_ENTRIES > 0
+/**
+ * Fills the digest of a hello message with the best paths to the next destinations of the pheromone table; the
+ * destinations are taken round-robin, so that every destination is advertised within a few hellos.
+ * @param digest The digest of at least ANT_HOC_NET_HELLO_DIGEST_ENTRIES entries
+ * @return The number of entries of the digest
+ */
+static uint8_t fill_hello_digest(hello_digest_entry_t *digest) {
+    static int next_position;
+
+    int destinations = number_of_destinations();
+    if (destinations == 0) {
+        next_position = 0;
+        return 0;
+    }
+    next_position %= destinations;
+
+    // the table is walked once: up to the destination the last hello stopped at, and from there round the table
+    uip_ipaddr_t destination;
+    pheromone_t pheromone_value;
+    hop_t hops;
+    const pheromone_destination_t *iterator = NULL;
+    for (int position = 0; position <= next_position; ++position) {
+        iterator = next_best_path(iterator, &destination, &pheromone_value, &hops);
+    }
+
+    uint8_t size = 0;
+    int visited = 0;
+    for (; iterator != NULL && visited < destinations && size < ANT_HOC_NET_HELLO_DIGEST_ENTRIES; ++visited) {
+        // a path is only advertised if it is known, and if the neighbours can extend it
+        if (pheromone_value > REAL_CONST(0.0) && hops + 1 < ANT_HOC_NET_MAX_HOPS) {
+            digest[size].destination = destination;
+            digest[size].time_estimate_T_P = calc_time_estimate_of_pheromone(pheromone_value, hops);
+            digest[size].hops = hops;
+            ++size;
+        }
+        iterator = next_best_path(iterator, &destination, &pheromone_value, &hops);
+        if (iterator == NULL) {
+            iterator = next_best_path(NULL, &destination, &pheromone_value, &hops);
+        }
+    }
+    next_position = (next_position + visited) % destinations;
+    return size;
+}
+
+/**
+ * Turns the digest of a received hello message into virtual pheromone over its sender.
+ * @param hello_msg The hello message
+ */
+static void reception_hello_digest(const struct hello_message *hello_msg) {
+    for (uint8_t i = 0; i < hello_msg->digest_size; ++i) {
+        const hello_digest_entry_t *entry = &hello_msg->digest[i];
+        if (uip_ipaddr_cmp(&entry->destination, &host_addr) || uip_ipaddr_cmp(&entry->destination, &hello_msg->source)
+            || entry->hops + 1 >= ANT_HOC_NET_MAX_HOPS) {
+            continue;
+        }
+        // the path of the neighbour is extended by the hop to it, as a backward ant does
+        pheromone_t tau_i_d = calc_tau_i_d(entry->time_estimate_T_P + hello_msg->time_estimate_T_P, entry->hops + 1);
+        update_virtual_pheromone(&entry->destination, &hello_msg->source, tau_i_d, entry->hops + 1);
+    }
+}
+#endif
+
 void broadcast_hello_messages() {
+#if ANT_HOC_NET_HELLO_SUPPRESSION
+    if (deferred_hellos < ANT_HOC_NET_HELLO_MAX_SUPPRESSED && hello_message_deferred()) {
+        ++deferred_hellos;
+        LOG_DBG("Hello message deferred - all neighbours got a frame within the hello interval\n");
+        return;
+    }
+#endif
+    send_hello_message();
+}
+
+/**
+ * Callback of the retry timer; the hello message waited for the packet in uip_buf.
+ */
+static void hello_retry_callback(void *ptr) {
+    if (hello_message_broadcasting) {
+        send_hello_message();
+    }
+}
+
+/**
+ * Builds the hello message of this node and broadcasts it.
+ */
+static void send_hello_message() {
+    // the hello would overwrite a packet in uip_buf, it is sent with the next tick
+    if (uip_len > 0) {
+        ctimer_set(&hello_retry_timer, 1, hello_retry_callback, NULL);
+        return;
+    }
 
     uip_ipaddr_t next_hop;
     uip_create_linklocal_allnodes_mcast(&next_hop);
@@ -1279,35 +1503,37 @@ void broadcast_hello_messages() {
 
     struct hello_message hello_msg;
     hello_msg.source = host_addr;
-    hello_msg.time_estimate_T_P = (float)0.0;
+    hello_msg.time_estimate_T_P = REAL_CONST(0.0);
+    hello_msg.hello_interval = hello_interval();
     calc_time_estimate_T_P(&hello_msg.time_estimate_T_P);
+#if ANT_HOC_NET_HELLO_SUPPRESSION
+    // the hello is a frame to all neighbours, a deferred one is sent now
+    ctimer_stop(&hello_deferral_timer);
+    deferred_hellos = 0;
+    advertised_hello_interval = hello_msg.hello_interval;
+#endif
+#if ANT_HOC_NET_HELLO_DIGEST_ENTRIES > 0
+    static hello_digest_entry_t digest[ANT_HOC_NET_HELLO_DIGEST_ENTRIES];
+    hello_msg.digest = digest;
+    hello_msg.digest_size = fill_hello_digest(digest);
+#else
+    hello_msg.digest = NULL;
+    hello_msg.digest_size = 0;
+#endif
 
     // if time estimate is 0, set it to 1.0, to have a valid value at the receiving nodes (and not 200)
-    if (hello_msg.time_estimate_T_P == 0.0) {
-        hello_msg.time_estimate_T_P = (float)1.0;
-    }
-
-    uint8_t* uip_buf_copy = NULL;
-    uint16_t len = 0;
-    if (uip_len > 0) {
-        LOG_DBG("UIP interrupted by hello broadcast - Data copied!\n");
-        uip_buf_copy = malloc(uip_len);
-        memcpy(uip_buf_copy, &uip_buf, uip_len);
-        len = uip_len;
+    if (hello_msg.time_estimate_T_P == REAL_CONST(0.0)) {
+        hello_msg.time_estimate_T_P = REAL_CONST(1.0);
     }
 
     LOG_DBG("Hello message broadcasted\n");
 
-    memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN], &hello_msg, sizeof(struct hello_message));
-    uip_icmp6_send(&next_hop, ICMP6_HELLO_MESSAGE, 0, sizeof(hello_msg));
+    wire_path_encoding_t encoding;
+    uint16_t size_counter = wire_write_hello_message(ICMP6_ANT_PAYLOAD, &hello_msg, &encoding);
+    uip_icmp6_send(&next_hop, ICMP6_HELLO_MESSAGE, WIRE_CODE(encoding), size_counter);
     //send_multicast_message(ICMP6_HELLO_MESSAGE, next_hop, sizeof(struct hello_message));
 
     LOG_DBG("Done broadcasting hello message\n");
-    if (uip_buf_copy != NULL) {
-        uip_len = len;
-        memcpy(&uip_buf, uip_buf_copy, uip_len);
-        free(uip_buf_copy);
-    }
 }
 
 void reception_hello_message(struct hello_message hello_msg) {
@@ -1315,36 +1541,71 @@ void reception_hello_message(struct hello_message hello_msg) {
     LOG_DBG_6ADDR(&hello_msg.source);
     LOG_DBG_("\n");
 
-    LOG_DBG("Time estimate : %f\n", hello_msg.time_estimate_T_P);
-    double tau_i_d = 1 / ((hello_msg.time_estimate_T_P + (float)1.0 * ANT_HOC_NET_T_HOP) / 2);
-    LOG_DBG("tau_i_d: %f\n", tau_i_d);
-    float pheromone_value = (float)((1 - ANT_HOC_NET_GAMMA) * tau_i_d);
-    LOG_DBG("Pheromone value: %f\n", pheromone_value);
+    LOG_DBG("Time estimate : %f\n", REAL_TO_FLOAT(hello_msg.time_estimate_T_P));
+    pheromone_t tau_i_d = calc_tau_i_d(hello_msg.time_estimate_T_P, 1);
+    LOG_DBG("tau_i_d: %f\n", REAL_TO_FLOAT(tau_i_d));
+    pheromone_t pheromone_value = calc_new_pheromone_value(0, tau_i_d);
+    LOG_DBG("Pheromone value: %f\n", REAL_TO_FLOAT(pheromone_value));
+    if (!does_neighbour_exists(hello_msg.source)) {
+        hello_neighbourhood_changed();
+    }
     add_neighbour_to_pheromone_table(hello_msg.source, pheromone_value);
+    // the loss of hello messages is measured by the interval of the neighbour
+    set_hello_interval(hello_msg.source, hello_msg.hello_interval);
+#if ANT_HOC_NET_HELLO_DIGEST_ENTRIES > 0
+    reception_hello_digest(&hello_msg);
+#endif
 }
 
-void hello_loss_callback_function(void *pheromone_entry_ptr) {
-    pheromone_entry_t *pheromone_entry = (pheromone_entry_t *) pheromone_entry_ptr;
-    if (pheromone_entry != NULL) {
-        ++pheromone_entry->hello_loss_counter;
-        LOG_DBG("Hello loss counter from ");
-        LOG_DBG_6ADDR(&pheromone_entry->neighbour);
-        LOG_DBG_(" increased to: %d\n", pheromone_entry->hello_loss_counter);
-
-        if (pheromone_entry->hello_loss_counter > ANT_HOC_NET_ALLOWED_HELLO_LOSS) {
+/**
+ * Callback of the sweep timer; evaluates the hello loss of all neighbours in one pass, and sets the timer to the
+ * earliest time a neighbour loses its next hello.
+ */
+static void hello_loss_sweep(void *ptr) {
+    clock_time_t now = clock_time();
+    bool neighbour_left = false;
+    clock_time_t next_sweep = 0;
+
+    pheromone_entry_t *entry = next_neighbour_entry(NULL);
+    while (entry != NULL) {
+        // the entry is deleted, if the neighbour has disappeared
+        pheromone_entry_t *next = next_neighbour_entry(entry);
+
+        clock_time_t lost_hellos = (now - entry->last_heard) / entry->hello_interval;
+        if (lost_hellos > ANT_HOC_NET_ALLOWED_HELLO_LOSS) {
             LOG_DBG("Hello loss counter exceeds allowed hello loss counter.\n");
-            neighbour_node_has_disappeared(pheromone_entry->neighbour);
-
+            neighbour_node_has_disappeared(*node_id_address(entry->neighbour));
         } else {
-            LOG_DBG("Restart hello loss timer.\n");
-            ctimer_restart(&pheromone_entry->hello_timer);
-
-            //ctimer_reset(&pheromone_entry->hello_timer);
-            LOG_DBG("Timer restarted!\n");
+            if (lost_hellos != entry->hello_loss_counter) {
+                entry->hello_loss_counter = lost_hellos;
+                LOG_DBG("Hello loss counter from ");
+                LOG_DBG_6ADDR(node_id_address(entry->neighbour));
+                LOG_DBG_(" increased to: %d\n", entry->hello_loss_counter);
+            }
+            // in the future, so the times are compared by their distance to now, which handles the wrap-around
+            clock_time_t next_loss = entry->last_heard + (lost_hellos + 1) * entry->hello_interval;
+            if (!neighbour_left || next_loss - now < next_sweep - now) {
+                next_sweep = next_loss;
+                neighbour_left = true;
+            }
         }
-    } else {
-        LOG_ERR("Pheromone entry is NULL\n");
+        entry = next;
+    }
+
+    if (neighbour_left) {
+        hello_loss_sweep_time = next_sweep;
+        ctimer_set(&hello_loss_sweep_timer, next_sweep - now, hello_loss_sweep, NULL);
+    }
+}
+
+void schedule_hello_loss_sweep(clock_time_t time) {
+    clock_time_t now = clock_time();
+    // a later time is found by the running sweep
+    if (!ctimer_expired(&hello_loss_sweep_timer) && time - now >= hello_loss_sweep_time - now) {
+        return;
     }
+    hello_loss_sweep_time = time;
+    ctimer_set(&hello_loss_sweep_timer, time - now, hello_loss_sweep, NULL);
 }
 
 /*----End-Proactive-path-probing,-maintenance-and-exploration---------------------------------------------------------*/
@@ -1358,19 +1619,24 @@ void broadcast_link_failure_notification(link_failure_notification_t link_failur
 
     LOG_DBG("Broadcast link failure notification\n");
 
-    uint16_t size_counter = sizeof(link_failure_notification_t) - sizeof(link_failure_notification_entry_t *);
-    memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN], &link_failure_notification, size_counter);
-
-    // copy all entries
-    if (link_failure_notification.size_of_list_of_destinations >= 1  && link_failure_notification.entries != NULL) {
-        memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN + size_counter], link_failure_notification.entries, link_failure_notification.size_of_list_of_destinations * sizeof(link_failure_notification_entry_t));
-        size_counter += link_failure_notification.size_of_list_of_destinations * sizeof(link_failure_notification_entry_t);
+    // the receivers decode the entries in uip_buf, thus only as many entries are sent as fit there
+    uint8_t max_entries = wire_max_link_failure_notification_entries(ICMP6_ANT_MAX_PAYLOAD_LEN);
+    if (link_failure_notification.entries == NULL) {
+        link_failure_notification.size_of_list_of_destinations = 0;
+    } else if (link_failure_notification.size_of_list_of_destinations > max_entries) {
+        LOG_WARN("Link failure notification has too many entries - only %u are broadcasted!\n", max_entries);
+        link_failure_notification.size_of_list_of_destinations = max_entries;
     }
+    uint16_t size_counter = wire_write_link_failure_notification(ICMP6_ANT_PAYLOAD, &link_failure_notification);
 
     LOG_INFO("Link failure notification broadcasted\n");
 
     //send_multicast_message(ICMP6_LINK_FAILURE_NOTIFICATION, next_hop, size_counter);
-    uip_icmp6_send(&next_hop, ICMP6_LINK_FAILURE_NOTIFICATION, 0, size_counter);
+    // delayed, so that the neighbours that lost the same link don't send at the same time; each notification is keyed
+    // by its own number, a pending one must not be replaced, since it carries other destinations
+    schedule_rebroadcast(&next_hop, ICMP6_LINK_FAILURE_NOTIFICATION, WIRE_VERSION, size_counter,
+                         rebroadcast_key(ICMP6_LINK_FAILURE_NOTIFICATION, &host_addr, ++link_failure_notification_number),
+                         REAL_CONST(0.0), false);
 
     if (link_failure_notification.entries != NULL) {
         free(link_failure_notification.entries);
@@ -1380,6 +1646,7 @@ void broadcast_link_failure_notification(link_failure_notification_t link_failur
 
 void neighbour_node_has_disappeared(uip_ipaddr_t neighbour_address) {
     LOG_DBG("Neighbour node has disappeared\n");
+    hello_neighbourhood_changed();
 
     int length_of_notification_list;
     link_failure_notification_entry_t * notification_list = creat_link_failure_notification_entries(neighbour_address, &length_of_notification_list);
@@ -1404,7 +1671,7 @@ void neighbour_node_has_disappeared(uip_ipaddr_t neighbour_address) {
         LOG_DBG("Destination: ");
         LOG_DBG_6ADDR(&link_failure_notification.entries[i].uip_address_of_destination);
         LOG_DBG_("\n");
-        LOG_DBG("New pheromone value: %f, New hops count: %d\n", link_failure_notification.entries[i].time_estimate_T_P_of_new_best_destination, link_failure_notification.entries[i].number_of_hops_to_new_best_destination);
+        LOG_DBG("New pheromone value: %f, New hops count: %d\n", REAL_TO_FLOAT(link_failure_notification.entries[i].time_estimate_T_P_of_new_best_destination), link_failure_notification.entries[i].number_of_hops_to_new_best_destination);
 
     }
 
@@ -1417,7 +1684,8 @@ void neighbour_node_has_disappeared(uip_ipaddr_t neighbour_address) {
         notification_list = NULL;
     }
     delete_neighbour_from_pheromone_table(neighbour_address);
-    delete_neighbour_from_best_ant_array(neighbour_address);
+    delete_virtual_pheromone_of_neighbour(&neighbour_address);
+    delete_best_ants_of_source(&neighbour_address);
 }
 
 void reception_link_failure_notification(link_failure_notification_t link_failure_notification) {
@@ -1436,27 +1704,36 @@ void reception_link_failure_notification(link_failure_notification_t link_failur
     };
 
     if (length_of_notification_list != 0) {
-        // only broadcast a message if the best paths are lost
+        // only broadcast a message if the best paths are lost; the neighbours learn the new pheromone sooner
+        hello_neighbourhood_changed();
         broadcast_link_failure_notification(link_failure_notification_new);
     }
-
-    // free old list
-    if (link_failure_notification.entries != NULL) {
-        free(link_failure_notification.entries);
-        link_failure_notification.entries = NULL;
-    }
 }
 
 void data_transmission_to_neighbour_has_failed(uip_ipaddr_t destination, uip_ipaddr_t neighbour) {
+    if (path_setup_running(destination)) {
+        return;
+    }
 
-    void * data = malloc(sizeof(uip_ipaddr_t)*2);
-    memcpy(data, &destination, sizeof(uip_ipaddr_t));
-    memcpy(((uip_ipaddr_t *)data) + 1, &neighbour, sizeof(uip_ipaddr_t));
-    process_start(&data_transmission_failed_proc, (process_data_t *) data);
+    pheromone_t *estimated_time = get_pheromone_value(neighbour, destination);
+    // to be safe, that should not happen, since the neighbour is not yet deleted
+    if (estimated_time == NULL) {
+        return;
+    }
 
-    if (data != NULL) {
-        free(data);
+    // calculate seconds to wait, according to the paper
+    clock_time_t interval = (clock_time_t) REAL_SCALE_TO_INT(*estimated_time, CLOCK_SECOND * ANT_HOC_NET_FACTOR_OF_WAITING_TIME_BRA);
+    path_setup_t *path_setup = start_path_setup(&destination, interval);
+    if (path_setup == NULL) {
+        return;
     }
+    path_setup->path_repair = true;
+    path_setup->neighbour = neighbour;
+    path_setup->try_counter = 1;
+
+    // broadcast path repair ant like a reactive forward ant
+    path_setup->ant_generation = ++ant_generation;
+    create_reactive_forward_or_path_repair_ant(path_setup->ant_generation, destination, PATH_REPAIR_ANT);
 }
 
 void no_pheromone_value_found_while_data_transmission(uip_ipaddr_t last_hop, uip_ipaddr_t destination) {
@@ -1471,14 +1748,15 @@ void no_pheromone_value_found_while_data_transmission(uip_ipaddr_t last_hop, uip
     LOG_INFO_6ADDR(&wm.destination);
     LOG_INFO_("\n");
 
-    memcpy(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN], &wm, sizeof(wm));
-    uip_icmp6_send(&last_hop, ICMP6_WARNING_MESSAGE, 0, sizeof(wm));
+    uint16_t size_counter = wire_write_warning_message(ICMP6_ANT_PAYLOAD, &wm);
+    uip_icmp6_send(&last_hop, ICMP6_WARNING_MESSAGE, WIRE_VERSION, size_counter);
 }
 
 void reception_warning(struct warning_message message) {
     LOG_DBG("Received warning message\n");
 
     delete_destination_from_pheromone_table(message.destination, message.source);
+    delete_virtual_pheromone_of_path(&message.destination, &message.source);
 }
 
 /*----End-Link-failures-----------------------------------------------------------------------------------------------*/
@@ -1497,10 +1775,9 @@ init(void)
         LOG_DBG("Routing init started!\n");
         uip_ip6addr(&uip_zeroes_addr, 0, 0, 0, 0, 0, 0, 0, 0);
 
-        running_average_T_i_mac = (float)0.0;
+        running_average_T_i_mac = REAL_CONST(0.0);
         ant_generation = 0;
 
-        best_ants = NULL;
         uip_ds6_addr_t *lladdr = uip_ds6_get_link_local(ADDR_PREFERRED);
         uip_ds6_addr_t *addr = uip_ds6_get_global(ADDR_PREFERRED);
         // get host ip addr
@@ -1533,20 +1810,24 @@ init(void)
         }
 
 
-        last_package_data.buffer = NULL;
-        last_package_data.len = 0;
-        last_package_data.destination = uip_zeroes_addr;
-        last_package_data.selected_nexthop = uip_zeroes_addr;
-
-        last_destination_data = NULL;
-
-        buffer.valid = false;
-        buffer.number_of_packets = 0;
-        buffer.packet_buffer = NULL;
-
+        node_id_init();
         pheromone_table_init();
+        best_ants_init();
+        rebroadcast_init();
+        packet_buffer_init();
+        reroute_contexts_init();
+        flows_init();
+        virtual_pheromone_init();
+        memb_init(&path_setups_memb);
+        list_init(path_setups_list);
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+        reverse_routes_init();
+#endif
 
         anthocnet_icmpv6_register_input_handlers();
+#if ANT_HOC_NET_HELLO_SUPPRESSION
+        netstack_ip_packet_processor_add(&liveness_processor);
+#endif
 
         acceptance_messages = true;
         initialized = true;
@@ -1631,17 +1912,21 @@ leave_network(void)
 {
     LOG_DBG("Routing leave network started!\n");
     stop_broadcast_of_hello_messages();
-    stop_reactive_path_setup_and_data_transmission_failed_process();
+    stop_path_setups();
     delete_pheromone_table();
-    running_average_T_i_mac = (float)0.0;
+    ctimer_stop(&hello_loss_sweep_timer);
+    running_average_T_i_mac = REAL_CONST(0.0);
     ant_generation = 0;
-    delete_best_ants_array();
-    discard_buffer();
-    if (last_package_data.buffer != NULL) {
-        free(last_package_data.buffer);
-    };
-    last_package_data.buffer = NULL;
-    delete_last_destination_data_array();
+    delete_best_ants();
+    delete_pending_rebroadcasts();
+    delete_packet_releases();
+#if ANT_HOC_NET_STATEFUL_REVERSE_ROUTES
+    delete_reverse_routes();
+#endif
+    delete_reroute_contexts();
+    process_exit(&proactive_maintenance_proc);
+    delete_flows();
+    delete_virtual_pheromone();
     acceptance_messages = false;
     LOG_DBG("Routing left network successfully!\n");
 }
@@ -1786,53 +2071,36 @@ ext_header_srh_get_next_hop(uip_ipaddr_t *ipaddr)
 static void
 link_callback(const linkaddr_t *addr, int status, int numtx)
 {
+#if ANT_HOC_NET_HELLO_SUPPRESSION
+    if (status == MAC_TX_OK) {
+        // the acknowledgement tells that the neighbour is alive, and that it got a frame of this node
+        uip_ipaddr_t neighbour;
+        neighbour_address_of(addr, &neighbour);
+        reset_hello_loss_timer(neighbour);
+        set_neighbour_reached(neighbour);
+    }
+#endif
+
+    // the context of the packet tells the destination and the next hop; the frame was rerouted by the MAC layer
+    // already, if another neighbour was found
+    uip_ipaddr_t destination;
+    uip_ipaddr_t next_hop;
+    if (status == MAC_TX_DEFERRED
+        || !take_reroute_context(packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO), addr, &destination, &next_hop)) {
+        // no data package, e.g. an ant
+        return;
+    }
+
     if (status == MAC_TX_OK) {
         LOG_DBG("Link callback - Packet successfully sent!\n");
         // neighbour exists, call the function to reset the timer, if the transmission was successful
-        if (!uip_ipaddr_cmp(&last_package_data.selected_nexthop, &uip_zeroes_addr)) {
-            reset_hello_loss_timer(last_package_data.selected_nexthop);
-        }
+        reset_hello_loss_timer(next_hop);
         return;
     }
 
-    // if a transmission failed
-    if (status != MAC_TX_DEFERRED)
-    {
-        LOG_DBG("Link callback - Transmission failed!\n");
-        // if the buffer is empty, the last message did contain ants, so dont check those messages
-        if (last_package_data.buffer == NULL) {
-            LOG_DBG("Last package buffer is null -> so an ants was sent\n");
-            return;
-        }
-        int neighbour_size = 0;
-        // try to get another neighbour
-        uip_ipaddr_t *neighbours = get_neighbours_to_send_to_destination(last_package_data.destination, false, &neighbour_size);
-        // if no neighbour is found, call data transmission has failed
-        if (neighbour_size == 0) {
-            if (neighbours != NULL) {
-                free(neighbours);
-                neighbours = NULL;
-            }
-            LOG_DBG("No neighbour was found to send package to destination\n");
-            data_transmission_to_neighbour_has_failed(last_package_data.destination, last_package_data.selected_nexthop);
-            return;
-        }
-        // if neighbours are found, check if a new neighbour was found, if so send the package to this neighbour
-        if (neighbours != NULL) {
-            for (int i = 0; i < neighbour_size; ++i) {
-                uip_ipaddr_t neighbour = neighbours[i];
-                if (uip_len == 0 && !uip_ipaddr_cmp(&neighbour, &last_package_data.selected_nexthop) && last_package_data.buffer != NULL) {
-                    LOG_DBG("New neighbour was found to send package to destination\n");
-                    memcpy(&uip_buf, last_package_data.buffer, last_package_data.len);
-                    uip_len = last_package_data.len;
-                    free(last_package_data.buffer);
-                    last_package_data.buffer = NULL;
-                    tcpip_ipv6_output();
-                    return;
-                }
-            }
-        }
-    }
+    // if a transmission failed and no other neighbour took the package, call data transmission has failed
+    LOG_DBG("Link callback - Transmission failed!\n");
+    data_transmission_to_neighbour_has_failed(destination, next_hop);
 }
 
 /**
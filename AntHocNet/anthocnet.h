@@ -29,10 +29,11 @@ unsigned int get_current_ant_generation();
 uip_ipaddr_t get_host_address();
 
 /**
- * Whether the stochastic path setup process or the data transmission failed process is running.
- * @return 1 if the stochastic path setup process or the data transmission failed process is running, 0 otherwise
+ * Whether the path to a destination is set up, either by a reactive path setup or by a path repair.
+ * @param destination uIP address of the destination
+ * @return True if a path setup to the destination is running
  */
-int processes_running();
+bool path_setup_running(uip_ipaddr_t destination);
 
 /**
  * @return 1 if the node is allowed to receive messages, 0 otherwise
@@ -43,9 +44,14 @@ int accept_messages();
  * Calculates the running average of time elapsed between the arrival of a packet at the MAC layer
  * and the end of a successful transmission. It is necessary for calc_time_estimate_T_P and corresponds to equation (4)
  * in the AntHocNet paper.
- * @param new_time_t_i_mac Time the node needs to send a packet
+ * @param new_time_t_i_mac Time the node needs to send a packet, in clock ticks
  */
-void update_running_average_T_i_mac(float new_time_t_i_mac);
+void update_running_average_T_i_mac(clock_time_t new_time_t_i_mac);
+
+/**
+ * @return The number of packets in the queue of the MAC layer, Q_i_mac in the AntHocNet paper
+ */
+int mac_queue_length();
 
 //-------Reactive path setup-------
 /**
@@ -65,44 +71,70 @@ void send_reactive_forward_or_path_repair_ant(bool broadcast, uip_ipaddr_t next_
  * number of hops and travel time are both within the acceptance factor ANT_HOC_NET_ACC_FACTOR_A1 of that of the best
  * ant of the generation, the ant will be forwarded. Furthermore, the acceptance factor ANT_HOC_NET_ACC_FACTOR_A2 is used
  * if the first hop is different from those taken by previously accepted ants.
+ *
+ * The path is not freed; a path in uip_buf behind the header, as for received ants, is extended and forwarded in place.
  * @param ant The reactive forward or the path repair ant
  */
 void reception_reactive_forward_or_path_repair_ant(struct reactive_forward_or_path_repair_ant ant);
 
 /**
- * Creates and sends a backward ant.
+ * Creates and sends a backward ant. The path is reversed in uip_buf, it is not freed.
  * @param ant_gen The new generation of the ant
+ * @param proactive Whether the ant answers a proactive forward ant
  * @param hops The number of hops of the forward ant
- * @param path The path that the forward ant has hold
+ * @param path The path that the forward ant has hold; with ANT_HOC_NET_STATEFUL_REVERSE_ROUTES the node the forward
+ * ant was received from
  * @param destination The uip address of the destination
  */
-void create_and_send_backward_ant(unsigned int ant_gen, hop_t hops, uip_ipaddr_t * path, uip_ipaddr_t destination);
+void create_and_send_backward_ant(unsigned int ant_gen, bool proactive, hop_t hops, uip_ipaddr_t * path, uip_ipaddr_t destination);
 
 /**
  * Handles reception of reactive backward ant.\n
  * Calculates time_estimate_T_P, updates routing tables and sends it to the next hop or discards it when the hop is not
- * found.
+ * found. The path is not freed; a path in uip_buf behind the header is forwarded in place.
  * @param ant The received backward ant
  */
 void reception_reactive_backward_ant(struct reactive_backward_ant ant);
 
 /**
- * Sends the package buffered by the reactive path setup or by the data transmission failed process.
+ * Returns the number of packets that wait for the path setup of a destination.
+ * @param destination uIP address of the destination
+ * @return The number of buffered packets, 0 if no path setup to the destination is running
+ */
+int number_of_buffered_packets(uip_ipaddr_t destination);
+
+/**
+ * Whether a path setup waits for the backward ant of a generation, i.e. the generation of its last forward ant.
+ * @param destination uIP address of the destination of the path setup, the origin of the backward ant
+ * @param ant_generation The generation of the backward ant
+ * @return True if a path setup to the destination waits for the generation
+ */
+bool path_setup_waits_for_generation(uip_ipaddr_t destination, uint16_t ant_generation);
+
+/**
+ * Finishes the path setup that waits for the backward ant of a generation and releases the packets buffered for its
+ * destination, with ANT_HOC_NET_PACED_RELEASE paced by the time estimate of the new path or by the MAC queue. Should be
+ * called after the backward ant was received, so that the packets find the new path.
+ * @param destination uIP address of the destination of the path setup, the origin of the backward ant
+ * @param ant_generation The generation of the backward ant
+ * @param time_estimate_T_P The time estimate of the backward ant, the time to reach the destination of the path setup
  */
-void send_buffered_data_packages();
+void finish_path_setup(uip_ipaddr_t destination, uint16_t ant_generation, time_estimate_t time_estimate_T_P);
 
 /**
  * Is called when reactive path setup should be executed, i.e. if no routing information is available to reach destination d.\n
- * The path setup process is repeated if no reactive backward ant is received withing ANT_HOC_NET_RESTART_PATH_SETUP_SECS.
- * After ANT_HOC_NET_MAX_TRIES_PATH_SETUP tries, the data is discarded. This happens in a Process.
+ * The packet in uip_buf is buffered until the path is set up. Each destination has its own path setup, that runs
+ * concurrently to the ones of other destinations; if the path to the destination is set up already, only the packet is
+ * buffered. The path setup is repeated if no reactive backward ant is received withing
+ * ANT_HOC_NET_RESTART_PATH_SETUP_SECS. After ANT_HOC_NET_MAX_TRIES_PATH_SETUP tries, the data is discarded.
  * @param destination uIP address of the destination of data packages.
  */
 void reactive_path_setup(uip_ipaddr_t destination);
 
 /**
- * Stops reactive path setup and data transmission failed process when either of thems is running.
+ * Stops the path setups and path repairs of all destinations and discards their buffered packets.
  */
-void stop_reactive_path_setup_and_data_transmission_failed_process();
+void stop_path_setups();
 
 //-------End reactive path setup-------
 
@@ -121,6 +153,12 @@ int stochastic_data_routing(uip_ipaddr_t destination, uip_ipaddr_t *address);
 
 //-------Proactive path probing, maintenance and exploration-------
 
+/**
+ * Makes the proactive maintenance process look at the data sessions, e.g. after a session started. The process sends
+ * the proactive forward ants of the sessions on its own schedule, off the data forwarding path.
+ */
+void poll_proactive_maintenance();
+
 /**
  * Unicast to next hop, chosen by (1), or broadcast with a probability of ANT_HOC_NET_PFA_BROADCAST_PROBABILITY.\n
  * Ant is killed if the number of broadcasts extends ANT_HOC_NET_MAX_NUMBER_BROADCASTS_PROACTIVE_FORWARD_A.
@@ -131,6 +169,7 @@ void send_proactive_forward_ant(struct proactive_forward_ant ant);
 /**
  * Handles reception of a proactive forward ant. Node is added to the ant's path.
  * If this is the destination, a backward ant is created and sent if the ant is sent further.
+ * The path is not freed; a path in uip_buf behind the header is extended and forwarded in place.
  *
  * @param ant The proactive forward ant that was received.
  */
@@ -139,10 +178,16 @@ void reception_proactive_forward_ant(struct proactive_forward_ant ant);
 void start_broadcast_of_hello_messages();
 
 /**
- * Broadcasts hello message.
+ * Broadcasts hello message, unless it is deferred with ANT_HOC_NET_HELLO_SUPPRESSION.
  */
 void broadcast_hello_messages();
 
+/**
+ * Is called when neighbours join or disappear, or when best paths are lost. With ANT_HOC_NET_HELLO_TRICKLE the hello
+ * interval is reset to its minimum, otherwise nothing is done.
+ */
+void hello_neighbourhood_changed();
+
 /**
  * Handles reception of a hello message.\n
  * If a message from a new neighbour is received, it is added to the routing tabel.
@@ -151,10 +196,11 @@ void broadcast_hello_messages();
 void reception_hello_message(struct hello_message hello_msg);
 
 /**
- * Callback function for ctimer for the reception of hello messages.
- * @param pheromone_entry_ptr Pointer to the neighbour entry
+ * Makes sure, that the hello loss of the neighbours is evaluated at the given time at the latest. Is called by the
+ * pheromone table, when a neighbour is added or its hello interval changes.
+ * @param time The time a neighbour loses its next hello
  */
-void hello_loss_callback_function(void *pheromone_entry_ptr);
+void schedule_hello_loss_sweep(clock_time_t time);
 
 //-------End proactive path probing, maintenance and exploration-------
 
@@ -171,7 +217,7 @@ void neighbour_node_has_disappeared(uip_ipaddr_t neighbour_address);
 /**
  * Handles reception of link failure notification.\n
  * Updates pheromone table with received new estimates, calls broadcast_link_failure_notification if the best or the only path to
- * the destination is lost.
+ * the destination is lost. The entries are not freed, they are read before uip_buf is overwritten.
  * @param link_failure_notification The received link failure notification
  */
 void reception_link_failure_notification(link_failure_notification_t link_failure_notification);
@@ -53,10 +53,24 @@
 #define LOG_CONF_LEVEL_ANTHOCNET_ICMPV6 LOG_LEVEL_ANTHOCNET
 #define LOG_CONF_LEVEL_ANTHOCNET_PHEROMONE LOG_LEVEL_ANTHOCNET
 #define LOG_CONF_LEVEL_ANTHOCNET_MAIN LOG_LEVEL_ANTHOCNET
+#define LOG_CONF_LEVEL_ANTHOCNET_NODE_ID LOG_LEVEL_ANTHOCNET
+#define LOG_CONF_LEVEL_ANTHOCNET_BEST_ANTS LOG_LEVEL_ANTHOCNET
+#define LOG_CONF_LEVEL_ANTHOCNET_REVERSE_ROUTES LOG_LEVEL_ANTHOCNET
+#define LOG_CONF_LEVEL_ANTHOCNET_REBROADCAST LOG_LEVEL_ANTHOCNET
+#define LOG_CONF_LEVEL_ANTHOCNET_PACKET_BUFFER LOG_LEVEL_ANTHOCNET
+#define LOG_CONF_LEVEL_ANTHOCNET_REROUTE LOG_LEVEL_ANTHOCNET
+#define LOG_CONF_LEVEL_ANTHOCNET_FLOWS LOG_LEVEL_ANTHOCNET
+#define LOG_CONF_LEVEL_ANTHOCNET_VIRTUAL_PHEROMONE LOG_LEVEL_ANTHOCNET
 
 /*---AntHocNet---*/
 #define ANT_HOC_NET_CONF_T_HELLO_SEC 5
 #define ANT_HOC_NET_CONF_ALLOWED_HELLO_LOSS 5
 #define ANT_HOC_NET_CONF_ACC_FACTOR_A2 3
 
+// delayed rebroadcasts with counter suppression for the dense scenarios, e.g. make REBROADCAST_SUPPRESSION=1
+#if ANT_HOC_NET_PROJECT_REBROADCAST_SUPPRESSION
+#define ANT_HOC_NET_CONF_REBROADCAST_JITTER_MS 64
+#define ANT_HOC_NET_CONF_REBROADCAST_COUNTER_THRESHOLD 3
+#endif
+
 #endif //IEEE_802_15_4_ANTNET_PROJECT_CONF_H
\ No newline at end of file
@@ -1,10 +1,17 @@
 #!/bin/bash
 
-# Usage: ./run_cooja_simulations.sh <csc_file> <num_runs>
+# Usage: ./run_cooja_simulations.sh <csc_file> <num_runs> [<paced_release>]
 # Example: ./run_cooja_simulations.sh my_simulation.csc 5
+# Example: ./run_cooja_simulations.sh my_simulation.csc 5 1
+# With <paced_release> the nodes are built with ANT_HOC_NET_CONF_PACED_RELEASE=<paced_release> and the logs are stored
+# with the suffix _paced<paced_release>, so that both modes can be compared with
+# python3 analyse_multiple_folder.py <output_path> outputs/<run> outputs/<run>_paced<paced_release>
+# REBROADCAST_SUPPRESSION=1 in the environment builds the nodes with delayed and suppressed rebroadcasts, see
+# project-conf.h
 
 CSC_FILE="$1"
 NUM_RUNS="$2"
+PACED_RELEASE="$3"
 LOG_DIR="logfiles"
 OUTPUT_DIR="outputs"
 ANALYSIS_SCRIPT="analyse_log.py"
@@ -20,7 +27,15 @@ if ! [[ "$NUM_RUNS" =~ ^[0-9]+$ ]]; then
     exit 1
 fi
 
+if [ -n "$PACED_RELEASE" ] && ! [[ "$PACED_RELEASE" =~ ^[0-2]$ ]]; then
+    echo "Paced release must be 0, 1 or 2."
+    exit 1
+fi
+
 SIM_NAME=$(basename "$CSC_FILE" .csc)
+if [ -n "$PACED_RELEASE" ]; then
+    SIM_NAME="${SIM_NAME}_paced${PACED_RELEASE}"
+fi
 
 TS=$(date +'%m_%d_%H_%M')
 
@@ -34,7 +49,7 @@ for (( i=1; i<=NUM_RUNS; i++ )); do
     # Run COOJA headless, assuming COOJA.jar is in the current directory.
     # Set your JAVA path and COOJA path as needed.
     #java -jar COOJA.jar -nogui="$CSC_FILE" > "$LOG_DIR/COOJA.logfile" 2>&1
-    docker run --privileged --sysctl net.ipv6.conf.all.disable_ipv6=0 --mount type=bind,source=/home/thomas/Git/ieee-802.15.4-antnet,destination=/home/user/ieee-802.15.4-antnet --mount type=bind,source=$CNG_PATH,destination=/home/user/contiki-ng --mount type=bind,source=/home/thomas/Git/contiki-ng-projektmodul,destination=/home/user/contiki-ng-projektmodul -e DISPLAY=$DISPLAY -v /tmp/.X11-unix:/tmp/.X11-unix -v /dev/bus/usb:/dev/bus/usb -v $XAUTHORITY:/home/user/.Xauthority --workdir /home/user/ieee-802.15.4-antnet -ti --rm contiker/contiki-ng_cooja cooja --args="--no-gui AntHocNetProject/simulations/$CSC_FILE --logdir=AntHocNetProject/results/$LOG_DIR"
+    docker run --privileged --sysctl net.ipv6.conf.all.disable_ipv6=0 --mount type=bind,source=/home/thomas/Git/ieee-802.15.4-antnet,destination=/home/user/ieee-802.15.4-antnet --mount type=bind,source=$CNG_PATH,destination=/home/user/contiki-ng --mount type=bind,source=/home/thomas/Git/contiki-ng-projektmodul,destination=/home/user/contiki-ng-projektmodul -e PACED_RELEASE=$PACED_RELEASE -e REBROADCAST_SUPPRESSION=$REBROADCAST_SUPPRESSION -e DISPLAY=$DISPLAY -v /tmp/.X11-unix:/tmp/.X11-unix -v /dev/bus/usb:/dev/bus/usb -v $XAUTHORITY:/home/user/.Xauthority --workdir /home/user/ieee-802.15.4-antnet -ti --rm contiker/contiki-ng_cooja cooja --args="--no-gui AntHocNetProject/simulations/$CSC_FILE --logdir=AntHocNetProject/results/$LOG_DIR"
     # Wait for simulation to finish (if needed, add checks here).
 
     # Generate timestamp
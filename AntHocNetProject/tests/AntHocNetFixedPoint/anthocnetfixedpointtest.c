@@ -0,0 +1,118 @@
+/**
+ * \file
+ *      Compares the fixed-point arithmetic of equations (1), (5) and (6) of the AntHocNet paper with the exact values,
+ *      which are calculated with doubles.
+ */
+#include "contiki.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "anthocnet-conf.h"
+#include "anthocnet-fixed-point.h"
+
+/* accepted errors; the resolution of Q16.16 is 1.5e-5 */
+#define MAX_RELATIVE_ERROR_TAU          0.01
+#define MAX_RELATIVE_ERROR_PHEROMONE    0.01
+#define MAX_ABSOLUTE_ERROR_PND          0.001
+
+#define NEIGHBOURS 8
+
+PROCESS(anthocnetfixedpointtest, "Test for AntHocNet-Fixed-Point.h");
+AUTOSTART_PROCESSES(&anthocnetfixedpointtest);
+
+/**
+ * Returns a random double in [min, max].
+ */
+static double random_double(double min, double max) {
+    return min + (max - min) * ((double)rand() / RAND_MAX);
+}
+
+/**
+ * Equation (5), time estimates from 1 ms to 10 s over 1 to 20 hops.
+ * @return The maximal relative error of tau^i_d
+ */
+static double test_tau() {
+    double max_error = 0.0;
+    for (double time_estimate = 0.001; time_estimate <= 10.0; time_estimate *= 1.1) {
+        for (hop_t hops = 1; hops <= 20; ++hops) {
+            double expected = 2.0 / (time_estimate + hops * ANT_HOC_NET_T_HOP);
+            pheromone_t tau_i_d = calc_tau_i_d(REAL_FROM_FRACTION((long)(time_estimate * 1000000), 1000000), hops);
+            double error = fabs(REAL_TO_FLOAT(tau_i_d) - expected) / expected;
+            max_error = fmax(max_error, error);
+        }
+    }
+    return max_error;
+}
+
+/**
+ * Equation (6), 100 consecutive updates of one pheromone value with random paths.
+ * @return The maximal relative error of the pheromone value
+ */
+static double test_pheromone_update() {
+    double max_error = 0.0;
+    double expected = 0.0;
+    pheromone_t pheromone_value = 0;
+    for (int i = 0; i < 100; ++i) {
+        double time_estimate = random_double(0.001, 5.0);
+        hop_t hops = (hop_t)(1 + rand() % 20);
+        double tau_i_d = 2.0 / (time_estimate + hops * ANT_HOC_NET_T_HOP);
+        expected = ANT_HOC_NET_GAMMA * expected + (1 - ANT_HOC_NET_GAMMA) * tau_i_d;
+        pheromone_value = calc_new_pheromone_value(pheromone_value,
+                calc_tau_i_d(REAL_FROM_FRACTION((long)(time_estimate * 1000000), 1000000), hops));
+        double error = fabs(REAL_TO_FLOAT(pheromone_value) - expected) / expected;
+        max_error = fmax(max_error, error);
+    }
+    return max_error;
+}
+
+/**
+ * Equation (1), 1000 random sets of pheromone values of the neighbours.
+ * @param beta Beta of equation (1)
+ * @return The maximal absolute error of P_nd
+ */
+static double test_pnd(int beta) {
+    double max_error = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        int neighbours = 1 + rand() % NEIGHBOURS;
+        pheromone_t pheromone_values[NEIGHBOURS];
+        pheromone_weight_t sum_of_weights = 0;
+        double expected_sum = 0.0;
+        for (int n = 0; n < neighbours; ++n) {
+            pheromone_values[n] = REAL_FROM_FRACTION((long)(random_double(0.01, 600.0) * 1000), 1000);
+            sum_of_weights += calc_pheromone_weight(pheromone_values[n], beta);
+            expected_sum += pow(REAL_TO_FLOAT(pheromone_values[n]), beta);
+        }
+        for (int n = 0; n < neighbours; ++n) {
+            double expected = pow(REAL_TO_FLOAT(pheromone_values[n]), beta) / expected_sum;
+            probability_t pnd = calc_probability(calc_pheromone_weight(pheromone_values[n], beta), sum_of_weights);
+            double error = fabs(REAL_TO_FLOAT(pnd) - expected);
+            max_error = fmax(max_error, error);
+        }
+    }
+    return max_error;
+}
+
+PROCESS_THREAD(anthocnetfixedpointtest, ev, data)
+{
+    PROCESS_BEGIN();
+
+    srand(1);
+
+    double error_tau = test_tau();
+    printf("Equation (5): max relative error of tau_i_d: %f\n", error_tau);
+    double error_pheromone = test_pheromone_update();
+    printf("Equation (6): max relative error of the pheromone value: %f\n", error_pheromone);
+    double error_pnd_forward = test_pnd(ANT_HOC_NET_BETA_FORWARD);
+    printf("Equation (1): max absolute error of P_nd, beta %d: %f\n", ANT_HOC_NET_BETA_FORWARD, error_pnd_forward);
+    double error_pnd_stochastic = test_pnd(ANT_HOC_NET_BETA_STOCHASTIC);
+    printf("Equation (1): max absolute error of P_nd, beta %d: %f\n", ANT_HOC_NET_BETA_STOCHASTIC, error_pnd_stochastic);
+
+    if (error_tau <= MAX_RELATIVE_ERROR_TAU && error_pheromone <= MAX_RELATIVE_ERROR_PHEROMONE
+        && error_pnd_forward <= MAX_ABSOLUTE_ERROR_PND && error_pnd_stochastic <= MAX_ABSOLUTE_ERROR_PND) {
+        printf("Fixed-point arithmetic is accurate enough\n");
+    } else {
+        printf("Fixed-point arithmetic is NOT accurate enough\n");
+    }
+
+    PROCESS_END();
+}
@@ -0,0 +1,17 @@
+/**
+ * Project configuration file for AntHocNet Algo implementation.
+ */
+
+#ifndef IEEE_802_15_4_ANTNET_PROJECT_CONF_H
+#define IEEE_802_15_4_ANTNET_PROJECT_CONF_H
+
+#define TSCH_SCHEDULE_CONF_WITH_6TISCH_MINIMAL 1
+
+#define NETSTACK_CONF_ROUTING anthocnet_driver
+
+#define UIP_MCAST6_CONF_ENGINE 4
+
+// the arithmetic under test
+#define ANT_HOC_NET_CONF_FIXED_POINT 1
+
+#endif //IEEE_802_15_4_ANTNET_PROJECT_CONF_H
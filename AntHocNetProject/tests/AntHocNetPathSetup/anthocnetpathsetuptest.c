@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include "anthocnet-types.h"
 #include "anthocnet-conf.h"
+#include "anthocnet-fixed-point.h"
 #include "routing.h"
 #include "uip-ds6.h"
 #include "uiplib.h"
@@ -26,7 +27,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
     PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&start_timer));
 
     printf("update_running_average_T_i_mac\n");
-    update_running_average_T_i_mac((float)0.4);
+    update_running_average_T_i_mac((clock_time_t)(0.4 * CLOCK_SECOND));
 
 
     uip_ipaddr_t neighbour_address;
@@ -63,7 +64,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .destination = destination_address,
         .hops = 4,
         .path = path,
-        .time_estimate_T_P = (float)4.0,
+        .time_estimate_T_P = REAL_CONST(4.0),
         .number_broadcasts = 0,
     };
 
@@ -88,7 +89,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .destination = destination_address,
         .hops = ANT_HOC_NET_MAX_HOPS,
         .path = path,
-        .time_estimate_T_P = (float)4.0,
+        .time_estimate_T_P = REAL_CONST(4.0),
         .number_broadcasts = 0,
     };
 
@@ -104,7 +105,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .destination = host_addr,
         .hops = 4,
         .path = path,
-        .time_estimate_T_P = (float)4.0,
+        .time_estimate_T_P = REAL_CONST(4.0),
         .number_broadcasts = 0,
     };
     printf("\nreception reactive forward or path repair ant: ant, hops are not max, host is destination");
@@ -127,7 +128,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .destination = destination_address,
         .hops = 4,
         .path = path_new_gen,
-        .time_estimate_T_P = (float)1.0,
+        .time_estimate_T_P = REAL_CONST(1.0),
         .number_broadcasts = 0,
     };
 
@@ -144,7 +145,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .destination = destination_address,
         .hops = 4,
         .path = path_better_time,
-        .time_estimate_T_P = (float)1.0,
+        .time_estimate_T_P = REAL_CONST(1.0),
         .number_broadcasts = 0,
     };
     printf("\nreception reactive forward or path repair ant: current best exists, same generation, better time");
@@ -160,7 +161,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .destination = destination_address,
         .hops = 4,
         .path = path_different_first_hop,
-        .time_estimate_T_P = (float)10.0,
+        .time_estimate_T_P = REAL_CONST(10.0),
         .number_broadcasts = 0,
     };
     printf("\nreception reactive forward or path repair ant: current best exists, same generation, different first hop");
@@ -176,14 +177,14 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .destination = destination_address,
         .hops = 4,
         .path = path_different_first_hop,
-        .time_estimate_T_P = (float)4.0,
+        .time_estimate_T_P = REAL_CONST(4.0),
         .number_broadcasts = 0,
     };
     printf("\nreception reactive forward or path repair ant: current best exists, different source");
     reception_reactive_forward_or_path_repair_ant(ant_different_source);
 
     printf("\ncreate and send backward ant: ant");
-    create_and_send_backward_ant(ant.ant_generation, ant.hops, ant.path, ant.source);
+    create_and_send_backward_ant(ant.ant_generation, false, ant.hops, ant.path, ant.source);
 
 
     uip_ipaddr_t path2[] = {destination_address, neighbour_4, neighbour_3, host_addr, neighbour_1};
@@ -194,7 +195,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .length = 5,
         .path = path2,
         .current_hop = 2,
-        .time_estimate_T_P = (float)3.0,
+        .time_estimate_T_P = REAL_CONST(3.0),
     };
 
     printf("\nreception reactive backward ant: host not dest, current hop != length");
@@ -207,7 +208,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .length = 5,
         .path = path2,
         .current_hop = 2,
-        .time_estimate_T_P = (float)3.0,
+        .time_estimate_T_P = REAL_CONST(3.0),
     };
 
     printf("\nreception reactive backward ant: destination is host");
@@ -221,7 +222,7 @@ PROCESS_THREAD(anthocnetpathsetuptest, ev, data)
         .length = 5,
         .path = path3,
         .current_hop = 3,
-        .time_estimate_T_P = (float)3.0,
+        .time_estimate_T_P = REAL_CONST(3.0),
     };
     printf("\nreception reactive backward ant: host not dest, current hop == length (-1)");
     reception_reactive_backward_ant(bw_hop_is_len);
@@ -2,6 +2,7 @@
 #include "tcpip.h"
 #include <stdio.h>
 #include <anthocnet-pheromone.h>
+#include <anthocnet-fixed-point.h>
 
 #include "uip-ds6.h"
 #include "uiplib.h"
@@ -32,26 +33,27 @@ PROCESS_THREAD(anthocnetpheromonetest, ev, data)
     uiplib_ipaddr_print(&neighbour_address);
     printf("\n");
 
-    printf("\nget_neighbours_to_send_to_destination, should be NULL, forward ant true\n");
+    printf("\nget_neighbours_to_send_to_destination, should be 0, forward ant true\n");
 
     // get the neighbour over which the imaginary neighbour should be reached
-    // has to be null
-    uip_ipaddr_t *neighbours = get_neighbours_to_send_to_destination(neighbour_address, true, &accepted_neighbour_size);
+    // has to be 0
+    uip_ipaddr_t neighbours[PHEROMONE_MAX_ACCEPTED_NEIGHBOURS];
+    accepted_neighbour_size = get_neighbours_to_send_to_destination(neighbour_address, true, neighbours, PHEROMONE_MAX_ACCEPTED_NEIGHBOURS);
 
     // must be true
-    if (neighbours == NULL) {
-        printf("neighbours == NULL, size; %d\n", accepted_neighbour_size);
+    if (accepted_neighbour_size == 0) {
+        printf("no neighbours, size; %d\n", accepted_neighbour_size);
     }
 
-    printf("\nget_neighbours_to_send_to_destination, should be NULL, forward ant false\n");
+    printf("\nget_neighbours_to_send_to_destination, should be 0, forward ant false\n");
 
-    neighbours = get_neighbours_to_send_to_destination(neighbour_address, false, &accepted_neighbour_size);
-    if (neighbours == NULL) {
-        printf("neighbours == NULL, size; %d\n", accepted_neighbour_size);
+    accepted_neighbour_size = get_neighbours_to_send_to_destination(neighbour_address, false, neighbours, PHEROMONE_MAX_ACCEPTED_NEIGHBOURS);
+    if (accepted_neighbour_size == 0) {
+        printf("no neighbours, size; %d\n", accepted_neighbour_size);
     }
 
     printf("\nget_pheromone_value, should be NULL\n");
-    float *value = get_pheromone_value(neighbour_address, neighbour_address);
+    pheromone_t *value = get_pheromone_value(neighbour_address, neighbour_address);
     if (value == NULL) {
         printf("Result was NULL\n");
     }
@@ -81,29 +83,29 @@ PROCESS_THREAD(anthocnetpheromonetest, ev, data)
     .path = path,
     // when create_or_update_pheromone_table is called, then the current hop is already incremented
     .current_hop = 3,
-    .time_estimate_T_P = (float)3.4
+    .time_estimate_T_P = REAL_CONST(3.4)
     };
 
     printf("\ncreate_or_update_pheromone_table\n");
     create_or_update_pheromone_table(ant);
 
     printf("\nget_pheromone_value, should not be NULL\n");
-    float *value_n = get_pheromone_value(neighbour_2, neighbour_1);
+    pheromone_t *value_n = get_pheromone_value(neighbour_2, neighbour_1);
     if (value_n == NULL) {
         printf("Result was NULL\n");
     } else {
-        printf("Result was %f\n", *value_n);
+        printf("Result was %f\n", REAL_TO_FLOAT(*value_n));
     }
 
     // get newly created neighbour
-    printf("\nget_neighbours_to_send_to_destination should not be NULL, forward ant false\n");
-    neighbours = get_neighbours_to_send_to_destination(neighbour_1, false, &accepted_neighbour_size);
+    printf("\nget_neighbours_to_send_to_destination should not be 0, forward ant false\n");
+    accepted_neighbour_size = get_neighbours_to_send_to_destination(neighbour_1, false, neighbours, PHEROMONE_MAX_ACCEPTED_NEIGHBOURS);
     // should get neighbour with 2s uip addr
-    if (neighbours != NULL) {
-        printf("neighbours != NULL, size; %d\n", accepted_neighbour_size);
+    if (accepted_neighbour_size > 0) {
+        printf("neighbours found, size; %d\n", accepted_neighbour_size);
         uiplib_ipaddr_print(&neighbours[0]);
     } else {
-        printf("neighbours == NULL; \n");
+        printf("no neighbours; \n");
     }
 
     // get the newly created pheromone value
@@ -112,7 +114,7 @@ PROCESS_THREAD(anthocnetpheromonetest, ev, data)
     if (value == NULL) {
         printf("Result was NULL\n");
     } else {
-        printf("Result was %f\n", *value);
+        printf("Result was %f\n", REAL_TO_FLOAT(*value));
     }
 
     // shoudnt do anything
@@ -155,7 +157,7 @@ PROCESS_THREAD(anthocnetpheromonetest, ev, data)
     link_failure_notification_entry_t lfn_1 = {
         .uip_address_of_destination = neighbour_1,
         .number_of_hops_to_new_best_destination = 3,
-        .time_estimate_T_P_of_new_best_destination = (float)6.2,
+        .time_estimate_T_P_of_new_best_destination = REAL_CONST(6.2),
     };
 
     link_failure_notification_t lfn_2 = {
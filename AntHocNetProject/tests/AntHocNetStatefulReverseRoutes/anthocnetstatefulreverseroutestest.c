@@ -0,0 +1,124 @@
+/**
+ * \file
+ *      Checks the hops that are stored in the pheromone table for backward ants, which only carry the window of their
+ *      path with ANT_HOC_NET_STATEFUL_REVERSE_ROUTES, and the reverse routes of a reactive and a proactive forward ant
+ *      of the same generation.
+ */
+#include "contiki.h"
+#include <stdio.h>
+#include <anthocnet-pheromone.h>
+#include <anthocnet-fixed-point.h>
+#include <anthocnet-wire.h>
+#include <anthocnet-node-id.h>
+#include <anthocnet-reverse-routes.h>
+
+#include "uiplib.h"
+#include "uip.h"
+
+PROCESS(anthocnetstatefulreverseroutestest, "Test for ANT_HOC_NET_STATEFUL_REVERSE_ROUTES");
+AUTOSTART_PROCESSES(&anthocnetstatefulreverseroutestest);
+
+/**
+ * Updates the pheromone table with a backward ant and compares the hops of the best path to its origin.
+ * @param origin The origin of the backward ant, i.e. the destination of the path
+ * @param last_node The last node the backward ant passed, i.e. the neighbour of the path
+ * @param current_hop The current hop of the ant, already incremented by this node
+ * @param expected_hops The hops the pheromone table should store
+ * @return True if the neighbour and the hops of the best path are the expected ones
+ */
+static bool check_backward_ant(uip_ipaddr_t origin, uip_ipaddr_t last_node, hop_t current_hop, hop_t expected_hops) {
+    uip_ipaddr_t path[WIRE_PATH_WINDOW] = {origin, last_node};
+    struct reactive_backward_ant ant = {
+            .ant_type = BACKWARD_ANT,
+            .ant_generation = 1,
+            .length = WIRE_PATH_WINDOW,
+            .path = path,
+            .current_hop = current_hop,
+            .time_estimate_T_P = REAL_CONST(0.3)
+    };
+    create_or_update_pheromone_table(ant);
+
+    uip_ipaddr_t neighbour;
+    pheromone_t pheromone_value;
+    hop_t hops;
+    clock_time_t last_ant;
+    if (!get_best_path(origin, &neighbour, &pheromone_value, &hops, &last_ant)) {
+        printf("No path to the origin\n");
+        return false;
+    }
+    printf("Neighbour ");
+    uiplib_ipaddr_print(&neighbour);
+    printf(", hops %d, should be %d\n", hops, expected_hops);
+    return uip_ipaddr_cmp(&neighbour, &last_node) && hops == expected_hops;
+}
+
+/**
+ * A reactive and a proactive forward ant of a source with the same generation pass this node over different nodes;
+ * their generations are counted apart, so each of their backward ants has to follow its own reverse route.
+ * @param source The source of the forward ants
+ * @param reactive_hop The node the reactive forward ant was received from
+ * @param proactive_hop The node the proactive forward ant was received from
+ * @return True if the backward ants of both ants find the node their forward ant was received from
+ */
+static bool check_reverse_routes_of_same_generation(uip_ipaddr_t source, uip_ipaddr_t reactive_hop,
+                                                    uip_ipaddr_t proactive_hop) {
+    const uint16_t generation = 7;
+    if (!add_reverse_route(&source, generation, false, &reactive_hop)
+        || !add_reverse_route(&source, generation, true, &proactive_hop)) {
+        printf("Reverse routes can't be added\n");
+        return false;
+    }
+
+    uip_ipaddr_t reactive_route;
+    uip_ipaddr_t proactive_route;
+    if (!get_reverse_route(&source, generation, false, &reactive_route)
+        || !get_reverse_route(&source, generation, true, &proactive_route)) {
+        printf("No reverse route\n");
+        return false;
+    }
+    printf("Reverse route of the reactive ant ");
+    uiplib_ipaddr_print(&reactive_route);
+    printf(", of the proactive ant ");
+    uiplib_ipaddr_print(&proactive_route);
+    printf("\n");
+    return uip_ipaddr_cmp(&reactive_route, &reactive_hop) && uip_ipaddr_cmp(&proactive_route, &proactive_hop);
+}
+
+PROCESS_THREAD(anthocnetstatefulreverseroutestest, ev, data)
+{
+    PROCESS_BEGIN();
+
+    node_id_init();
+    pheromone_table_init();
+    reverse_routes_init();
+
+    // origin - neighbour_2 - neighbour_3 - this node
+    uip_ipaddr_t origin;
+    uip_ip6addr(&origin, 1, 2, 3, 4, 5, 6, 7, 8);
+    uip_ipaddr_t neighbour_2;
+    uip_ip6addr(&neighbour_2, 2, 2, 2, 2, 2, 2, 2, 2);
+    uip_ipaddr_t neighbour_3;
+    uip_ip6addr(&neighbour_3, 3, 3, 3, 3, 3, 3, 3, 3);
+
+    printf("\n3-hop backward ant, received from neighbour_3\n");
+    bool three_hops = check_backward_ant(origin, neighbour_3, 3, 2);
+
+    // a second path to the same origin over a neighbour, that is the origin itself
+    printf("\n1-hop backward ant, received from the origin\n");
+    bool one_hop = check_backward_ant(origin, origin, 1, 0);
+
+    if (three_hops && one_hop) {
+        printf("Hops of the stateful backward ants are correct\n");
+    } else {
+        printf("Hops of the stateful backward ants are NOT correct\n");
+    }
+
+    printf("\nReactive and proactive forward ant of generation 7 from the origin\n");
+    if (check_reverse_routes_of_same_generation(origin, neighbour_2, neighbour_3)) {
+        printf("Reverse routes of the same generation are apart\n");
+    } else {
+        printf("Reverse routes of the same generation are NOT apart\n");
+    }
+
+    PROCESS_END();
+}
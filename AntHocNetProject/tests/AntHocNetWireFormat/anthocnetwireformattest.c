@@ -0,0 +1,300 @@
+/**
+ * \file
+ *      Encodes and decodes the AntHocNet messages and compares the decoded messages with the original ones. Prints the
+ *      sizes of the encoded fixed parts and of the encoded paths.
+ */
+#include "contiki.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "anthocnet-fixed-point.h"
+#include "anthocnet-wire.h"
+
+#define ENTRIES 20
+#define PATH_HOPS 12
+
+PROCESS(anthocnetwireformattest, "Test for AntHocNet-Wire.h");
+AUTOSTART_PROCESSES(&anthocnetwireformattest);
+
+static uint8_t buf[UIP_BUFSIZE];
+
+static bool check_reactive_forward_ant(struct reactive_forward_or_path_repair_ant *ant) {
+    uip_ip6addr(&ant->source, 0xfe80, 0, 0, 0, 1, 2, 3, 4);
+    uip_ip6addr(&ant->destination, 0xfd00, 0, 0, 0, 5, 6, 7, 8);
+    struct reactive_forward_or_path_repair_ant decoded;
+
+    uint16_t len = wire_write_reactive_forward_ant(buf, ant);
+    wire_read_reactive_forward_ant(buf, &decoded);
+    printf("Reactive forward ant: %u bytes\n", len);
+    return decoded.ant_type == ant->ant_type && decoded.ant_generation == ant->ant_generation
+           && decoded.replied == ant->replied && decoded.number_broadcasts == ant->number_broadcasts
+           && decoded.hops == ant->hops && decoded.time_estimate_T_P == ant->time_estimate_T_P
+           && uip_ipaddr_cmp(&decoded.source, &ant->source) && uip_ipaddr_cmp(&decoded.destination, &ant->destination);
+}
+
+static bool test_reactive_forward_ant() {
+    struct reactive_forward_or_path_repair_ant ant = {
+        .ant_type = PATH_REPAIR_ANT,
+        .ant_generation = 65535,
+        .number_broadcasts = 2,
+        .hops = ANT_HOC_NET_MAX_HOPS,
+        .time_estimate_T_P = REAL_CONST(1.25),
+    };
+    // the flags share their byte with the broadcasts, whose count takes the remaining 6 bits
+    struct reactive_forward_or_path_repair_ant replied = {
+        .ant_type = PATH_REPAIR_ANT,
+        .ant_generation = 1,
+        .replied = true,
+        .number_broadcasts = 63,
+        .hops = 1,
+        .time_estimate_T_P = REAL_CONST(0.5),
+    };
+    return check_reactive_forward_ant(&ant) && check_reactive_forward_ant(&replied);
+}
+
+static bool test_reactive_backward_ant() {
+    struct reactive_backward_ant ant = {
+        .ant_type = BACKWARD_ANT,
+        .ant_generation = 4711,
+        .proactive = true,
+        .current_hop = 3,
+        .length = 7,
+        .time_estimate_T_P = REAL_CONST(0.5),
+    };
+    uip_ip6addr(&ant.destination, 0xfe80, 0, 0, 0, 1, 2, 3, 4);
+    struct reactive_backward_ant decoded;
+
+    uint16_t len = wire_write_reactive_backward_ant(buf, &ant);
+    wire_read_reactive_backward_ant(buf, &decoded);
+    printf("Reactive backward ant: %u bytes\n", len);
+    return decoded.ant_generation == ant.ant_generation && decoded.proactive == ant.proactive
+           && decoded.current_hop == ant.current_hop
+           && decoded.length == ant.length && decoded.time_estimate_T_P == ant.time_estimate_T_P
+           && uip_ipaddr_cmp(&decoded.destination, &ant.destination);
+}
+
+static bool test_proactive_forward_ant() {
+    struct proactive_forward_ant ant = {
+        .ant_generation = 65534,
+        .number_of_broadcasts = 2,
+        .hops = ANT_HOC_NET_MAX_HOPS,
+    };
+    uip_ip6addr(&ant.source, 0xfe80, 0, 0, 0, 1, 2, 3, 4);
+    uip_ip6addr(&ant.destination, 0xfd00, 0, 0, 0, 5, 6, 7, 8);
+    struct proactive_forward_ant decoded;
+
+    uint16_t len = wire_write_proactive_forward_ant(buf, &ant);
+    wire_read_proactive_forward_ant(buf, &decoded);
+    printf("Proactive forward ant: %u bytes\n", len);
+    return len == WIRE_PFA_HEADER_LEN && decoded.ant_generation == ant.ant_generation
+           && decoded.number_of_broadcasts == ant.number_of_broadcasts && decoded.hops == ant.hops
+           && uip_ipaddr_cmp(&decoded.source, &ant.source) && uip_ipaddr_cmp(&decoded.destination, &ant.destination);
+}
+
+/**
+ * Encodes and decodes a path in place.
+ * @param path The path, overwritten by the decoded path
+ * @param source The source of the ant
+ * @param expected The expected encoding
+ * @return True if the decoded path equals the original one and the expected encoding is used
+ */
+static bool test_path(uip_ipaddr_t *path, const uip_ipaddr_t *source, wire_path_encoding_t expected) {
+    uip_ipaddr_t original[PATH_HOPS];
+    memcpy(original, path, sizeof(original));
+    wire_path_encoding_t encoding;
+
+    uint16_t len = wire_write_path((uint8_t *) path, path, PATH_HOPS, source, &encoding);
+    printf("Path of %d hops with encoding %d: %u bytes\n", PATH_HOPS, encoding, len);
+    if (encoding != expected) {
+        return false;
+    }
+    // a truncated path is rejected and a path that can't be expanded in the buffer as well
+    if (wire_read_path((uint8_t *) path, len - 1, sizeof(original), PATH_HOPS, source, encoding)
+        || wire_read_path((uint8_t *) path, len, sizeof(original) - 1, PATH_HOPS, source, encoding)) {
+        return false;
+    }
+    return wire_read_path((uint8_t *) path, len, sizeof(original), PATH_HOPS, source, encoding)
+           && memcmp(path, original, sizeof(original)) == 0;
+}
+
+static bool test_paths() {
+    uip_ipaddr_t path[PATH_HOPS];
+    uip_ipaddr_t source;
+    uip_ip6addr(&source, 0xfe80, 0, 0, 0, 0x0202, 0x0002, 0x0002, 0x0002);
+
+    // addresses of Cooja motes, whose link-layer addresses are made of their node id
+    for (int i = 0; i < PATH_HOPS; ++i) {
+        uip_ip6addr(&path[i], 0xfe80, 0, 0, 0, 0x0200 | (i + 3), i + 3, i + 3, i + 3);
+    }
+    bool short_ids = test_path(path, &source, WIRE_PATH_SHORT);
+
+    for (int i = 0; i < PATH_HOPS; ++i) {
+        uip_ip6addr(&path[i], 0xfe80, 0, 0, 0, 1, 2, 3, i);
+    }
+    bool iids = test_path(path, &source, WIRE_PATH_IID);
+
+    uip_ip6addr(&path[PATH_HOPS - 1], 0xfd00, 0, 0, 0, 1, 2, 3, 4);
+    bool full = test_path(path, &source, WIRE_PATH_FULL);
+
+    return short_ids && iids && full;
+}
+
+static bool test_link_failure_notification() {
+    link_failure_notification_entry_t entries[ENTRIES];
+    link_failure_notification_t lfn = {
+        .size_of_list_of_destinations = ENTRIES,
+        .entries = entries,
+    };
+    uip_ip6addr(&lfn.source, 0xfe80, 0, 0, 0, 1, 2, 3, 4);
+    uip_ip6addr(&lfn.failed_link, 0xfe80, 0, 0, 0, 5, 6, 7, 8);
+    for (int i = 0; i < ENTRIES; ++i) {
+        uip_ip6addr(&entries[i].uip_address_of_destination, 0xfd00, 0, 0, 0, 0, 0, 0, i);
+        entries[i].number_of_hops_to_new_best_destination = i;
+        // the sentinel of a lost path is negative
+        entries[i].time_estimate_T_P_of_new_best_destination = i == 0 ? REAL_CONST(-100.0) : REAL_FROM_FRACTION(i, 8);
+    }
+    link_failure_notification_t decoded;
+
+    uint16_t len = wire_write_link_failure_notification(buf, &lfn);
+    printf("Link failure notification with %d entries: %u bytes\n", ENTRIES, len);
+    if (!wire_read_link_failure_notification(buf, len, sizeof(buf), &decoded)
+        || decoded.size_of_list_of_destinations != ENTRIES
+        || !uip_ipaddr_cmp(&decoded.source, &lfn.source) || !uip_ipaddr_cmp(&decoded.failed_link, &lfn.failed_link)) {
+        return false;
+    }
+    for (int i = 0; i < ENTRIES; ++i) {
+        if (!uip_ipaddr_cmp(&decoded.entries[i].uip_address_of_destination, &entries[i].uip_address_of_destination)
+            || decoded.entries[i].number_of_hops_to_new_best_destination != entries[i].number_of_hops_to_new_best_destination
+            || decoded.entries[i].time_estimate_T_P_of_new_best_destination != entries[i].time_estimate_T_P_of_new_best_destination) {
+            return false;
+        }
+    }
+    // a truncated notification is rejected
+    return !wire_read_link_failure_notification(buf, len - 1, sizeof(buf), &decoded);
+}
+
+/**
+ * Encodes and decodes a hello message with a digest, whose entries are decoded in place.
+ * @param msg The hello message
+ * @param expected The expected encoding of the destinations of the digest
+ * @return True if the decoded message equals the original one, the expected encoding is used and a truncated message
+ * is rejected
+ */
+static bool test_hello(const struct hello_message *msg, wire_path_encoding_t expected) {
+    wire_path_encoding_t encoding;
+    struct hello_message decoded;
+
+    uint16_t len = wire_write_hello_message(buf, msg, &encoding);
+    printf("Hello message with %d entries and encoding %d: %u bytes\n", msg->digest_size, encoding, len);
+    if (encoding != expected) {
+        return false;
+    }
+    // the truncated message is rejected before anything is decoded in place
+    if (wire_read_hello_message(buf, len - 1, sizeof(buf), encoding, &decoded)
+        || !wire_read_hello_message(buf, len, sizeof(buf), encoding, &decoded)) {
+        return false;
+    }
+    if (!uip_ipaddr_cmp(&decoded.source, &msg->source) || decoded.time_estimate_T_P != msg->time_estimate_T_P
+        || decoded.digest_size != msg->digest_size || decoded.digest == NULL
+        || (uintptr_t)decoded.digest % sizeof(uint32_t) != 0) {
+        return false;
+    }
+    for (int i = 0; i < msg->digest_size; ++i) {
+        if (!uip_ipaddr_cmp(&decoded.digest[i].destination, &msg->digest[i].destination)
+            || decoded.digest[i].hops != msg->digest[i].hops
+            || decoded.digest[i].time_estimate_T_P != msg->digest[i].time_estimate_T_P) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Encodes and decodes hello messages with an interval; the interval may be rounded, but never to a shorter one.
+ * @param msg The hello message, its interval is changed
+ * @return True if no interval is decoded shorter than it was encoded
+ */
+static bool test_hello_intervals(struct hello_message *msg) {
+    const clock_time_t intervals[] = {1, CLOCK_SECOND / 3, CLOCK_SECOND - 1, CLOCK_SECOND, 7 * CLOCK_SECOND + 1,
+                                      ANT_HOC_NET_T_HELLO_SEC * CLOCK_SECOND, 60 * CLOCK_SECOND + 1};
+    wire_path_encoding_t encoding;
+    struct hello_message decoded;
+    for (unsigned int i = 0; i < sizeof(intervals) / sizeof(intervals[0]); ++i) {
+        msg->hello_interval = intervals[i];
+        uint16_t len = wire_write_hello_message(buf, msg, &encoding);
+        if (!wire_read_hello_message(buf, len, sizeof(buf), encoding, &decoded)
+            || decoded.hello_interval < msg->hello_interval) {
+            printf("Hello interval of %lu ticks is decoded as %lu ticks\n", (unsigned long)msg->hello_interval,
+                   (unsigned long)decoded.hello_interval);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_hello_messages() {
+    hello_digest_entry_t digest[ENTRIES];
+    struct hello_message msg = {
+        .time_estimate_T_P = REAL_FROM_FRACTION(3, 8),
+        .hello_interval = ANT_HOC_NET_T_HELLO_SEC * CLOCK_SECOND,
+        .digest_size = ENTRIES,
+        .digest = digest,
+    };
+    uip_ip6addr(&msg.source, 0xfe80, 0, 0, 0, 0x0202, 0x0002, 0x0002, 0x0002);
+    for (int i = 0; i < ENTRIES; ++i) {
+        digest[i].hops = i;
+        digest[i].time_estimate_T_P = REAL_FROM_FRACTION(i + 1, 8);
+    }
+
+    // addresses of Cooja motes, whose link-layer addresses are made of their node id
+    for (int i = 0; i < ENTRIES; ++i) {
+        uip_ip6addr(&digest[i].destination, 0xfe80, 0, 0, 0, 0x0200 | (i + 3), i + 3, i + 3, i + 3);
+    }
+    bool short_ids = test_hello(&msg, WIRE_PATH_SHORT);
+
+    for (int i = 0; i < ENTRIES; ++i) {
+        uip_ip6addr(&digest[i].destination, 0xfe80, 0, 0, 0, 1, 2, 3, i);
+    }
+    bool iids = test_hello(&msg, WIRE_PATH_IID);
+
+    uip_ip6addr(&digest[ENTRIES - 1].destination, 0xfd00, 0, 0, 0, 1, 2, 3, 4);
+    bool full = test_hello(&msg, WIRE_PATH_FULL);
+
+    // the header alone is truncated as well
+    msg.digest_size = 0;
+    wire_path_encoding_t encoding;
+    struct hello_message decoded;
+    uint16_t len = wire_write_hello_message(buf, &msg, &encoding);
+    bool header = len == WIRE_HELLO_HEADER_LEN && !wire_read_hello_message(buf, len - 1, sizeof(buf), encoding, &decoded)
+                  && wire_read_hello_message(buf, len, sizeof(buf), encoding, &decoded) && decoded.digest == NULL;
+
+    bool intervals = test_hello_intervals(&msg);
+
+    return short_ids && iids && full && header && intervals;
+}
+
+PROCESS_THREAD(anthocnetwireformattest, ev, data)
+{
+    PROCESS_BEGIN();
+
+    bool rfa = test_reactive_forward_ant();
+    printf("Reactive forward ant: %s\n", rfa ? "ok" : "FAILED");
+    bool rba = test_reactive_backward_ant();
+    printf("Reactive backward ant: %s\n", rba ? "ok" : "FAILED");
+    bool pfa = test_proactive_forward_ant();
+    printf("Proactive forward ant: %s\n", pfa ? "ok" : "FAILED");
+    bool paths = test_paths();
+    printf("Paths: %s\n", paths ? "ok" : "FAILED");
+    bool lfn = test_link_failure_notification();
+    printf("Link failure notification: %s\n", lfn ? "ok" : "FAILED");
+    bool hello = test_hello_messages();
+    printf("Hello message: %s\n", hello ? "ok" : "FAILED");
+
+    if (rfa && rba && pfa && paths && lfn && hello) {
+        printf("Wire format is consistent\n");
+    } else {
+        printf("Wire format is NOT consistent\n");
+    }
+
+    PROCESS_END();
+}
@@ -58,6 +58,7 @@
 
 //--Start-of-changed-part!--
 #include "anthocnet.h"
+#include "anthocnet-reroute.h"
 //--End-of-changed-part!--
 
 #include "sys/log.h"
@@ -345,8 +346,8 @@ tx_done(int status, struct packet_queue *q, struct neighbor_queue *n)
   //--Start-of-changed-part!--
   // calc the time in ticks needed for a packet to be put into the queue until an ack for it received
   rtimer_clock_t time_difference = clock_time() - q->time_sent;
-  // update running average with tick in float
-  update_running_average_T_i_mac((float)time_difference);
+  // update running average with the ticks
+  update_running_average_T_i_mac((clock_time_t)time_difference);
   //--End-of-changed-part!--
 
   //--End-of-changed-part!----
@@ -357,6 +358,19 @@ tx_done(int status, struct packet_queue *q, struct neighbor_queue *n)
               packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO),
               status, n->transmissions, n->collisions);
 
+  //--Start-of-changed-part!--
+  // a failed frame of a data packet is queued for another neighbour, if AntHocNet finds one; the frame is taken from
+  // its queuebuf, the packet is not kept anywhere else
+  if(status == MAC_TX_NOACK || status == MAC_TX_COLLISION) {
+    queuebuf_to_packetbuf(q->buf);
+    if(reroute_frame()) {
+      free_packet(n, q, status);
+      csma_output_packet(sent, cptr);
+      return;
+    }
+  }
+  //--End-of-changed-part!--
+
   free_packet(n, q, status);
   mac_call_sent_callback(sent, cptr, status, ntx);
 }
@@ -466,6 +480,11 @@ csma_output_packet(mac_callback_t sent, void *ptr)
   mac_sequence_set_dsn();
   packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
 
+  //--Start-of-changed-part!--
+  // the sequence number identifies the frame of a routed data packet
+  attach_frame_to_reroute_context();
+  //--End-of-changed-part!--
+
   /* Look for the neighbor entry */
   n = neighbor_queue_from_addr(addr);
   if(n == NULL) {
@@ -64,6 +64,7 @@
 #include <string.h>
 
 #include "anthocnet.h"
+#include "anthocnet-reroute.h"
 
 /* Log configuration */
 #include "sys/log.h"
@@ -269,6 +270,8 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             //--Start-of-changed-part!--
             // Added to get the time when the message is put into the queue.
             p->time_of_arrival = clock_time();
+            // the sequence number identifies the frame of a routed data packet; frames are not rerouted with TSCH
+            attach_frame_to_reroute_context();
             //--End-of-changed-part!--
 
             /* Add to ringbuf (actual add committed through atomic operation) */
@@ -363,8 +366,8 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
     //--Start-of-changed-part!--
     // calc the time in ticks needed for a packet to be put into the queue until an ack for it received
     rtimer_clock_t time_difference = clock_time() - p->time_of_arrival;
-    // update running average with tick in float
-    update_running_average_T_i_mac((float)time_difference);
+    // update running average with the ticks
+    update_running_average_T_i_mac((clock_time_t)time_difference);
     //--End-of-changed-part!--
 
     /* Update CSMA state in the unicast case */